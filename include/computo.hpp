@@ -1,14 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <jsom/jsom.hpp>
+#include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace computo {
@@ -124,17 +129,149 @@ public:
     void reset();
 };
 
+// --- Shared Values ---
+
+// A reference-counted handle to an immutable JSON value. Copying a handle, or
+// taking one to part of its value with share(), is O(1): all of them share the
+// storage of the document they came from, which lives as long as any handle
+// does. Values are never modified through a handle; code that needs a changed
+// value takes its own copy with take(), which moves instead when nothing else
+// shares the value.
+class SharedJson {
+public:
+    SharedJson() : value_(std::shared_ptr<const void>(), &null_value()) {}
+    // Implicit so that a binding can be written {"x", value}
+    SharedJson(jsom::JsonDocument value) // NOLINT(google-explicit-constructor)
+        : value_(std::make_shared<jsom::JsonDocument>(std::move(value))), owns_value_(true) {}
+    // value is kept alive by owner; a null owner means value outlives every
+    // handle to it (the script being run, the inputs of a running program)
+    SharedJson(std::shared_ptr<const void> owner, const jsom::JsonDocument& value)
+        : value_(std::move(owner), &value) {}
+
+    [[nodiscard]] auto get() const -> const jsom::JsonDocument& { return *value_; }
+    [[nodiscard]] auto operator*() const -> const jsom::JsonDocument& { return *value_; }
+    [[nodiscard]] auto operator->() const -> const jsom::JsonDocument* { return value_.get(); }
+
+    // A handle to member, which must be part of this handle's value
+    [[nodiscard]] auto share(const jsom::JsonDocument& member) const -> SharedJson {
+        return {value_, member};
+    }
+
+    // The value to keep or modify
+    [[nodiscard]] auto take() && -> jsom::JsonDocument;
+
+private:
+    std::shared_ptr<const jsom::JsonDocument> value_;
+    bool owns_value_{false}; // value_ was allocated by this handle, not aliased
+
+    static auto null_value() -> const jsom::JsonDocument&;
+};
+
+// --- Variable Frames ---
+
+// One immutable scope of let or lambda bindings. A frame holds only its own
+// bindings plus a link to the scope it was created in, so entering a scope
+// costs O(bindings) and every context or pending tail call that can see a
+// frame shares it instead of copying it.
+class VariableFrame {
+public:
+    struct Binding {
+        std::string name;
+        SharedJson value; // Often part of the input or of another binding
+    };
+
+    // A parent whose every name is rebound here can never be seen through
+    // this frame, so the frame links past it (see elided())
+    VariableFrame(std::shared_ptr<const VariableFrame> parent, std::vector<Binding> bindings);
+
+    [[nodiscard]] auto parent() const -> const VariableFrame* { return parent_.get(); }
+    [[nodiscard]] auto bindings() const -> const std::vector<Binding>& { return bindings_; }
+    // Fully shadowed frames skipped between this frame and parent(). Keeps the
+    // chain short when a recursive lambda rebinds its parameters at every level.
+    [[nodiscard]] auto elided() const -> std::size_t { return elided_; }
+
+    // Innermost binding of name visible from frame (which may be null), or nullptr
+    static auto find(const VariableFrame* frame, const std::string& name) -> const SharedJson*;
+    // Binding at a statically resolved (hops, slot) position, or nullptr if the
+    // chain does not match (the caller then falls back to find())
+    static auto load(const VariableFrame* frame, std::size_t hops, std::size_t slot,
+                     const std::string& name) -> const SharedJson*;
+    // Flat view of everything visible from frame (inner bindings win)
+    static auto flatten(const VariableFrame* frame) -> std::map<std::string, jsom::JsonDocument>;
+
+private:
+    std::shared_ptr<const VariableFrame> parent_;
+    std::vector<Binding> bindings_;
+    std::size_t elided_{0};
+};
+
+// --- Execution Path ---
+
+// One step of the execution path (e.g. "then", "arg2" or "binding_value_for_x").
+// A context links its innermost segment to that of the context it was derived
+// from, which lives further up the C++ stack, so entering a sub-expression
+// copies no strings. The path is only rendered by get_path_string().
+struct PathSegment {
+    static constexpr std::size_t NO_INDEX = static_cast<std::size_t>(-1);
+
+    const PathSegment* parent{nullptr};
+    const char* label{nullptr};  // Static text
+    std::string_view name;       // Borrowed text appended to label
+    std::size_t index{NO_INDEX}; // Appended last, e.g. "arg" + 2
+
+    [[nodiscard]] auto empty() const -> bool {
+        return label == nullptr && name.empty() && index == NO_INDEX;
+    }
+};
+
+// --- Parallel Execution ---
+
+/**
+ * Opt-in data parallelism for map, filter and reduce
+ *
+ * A map or filter call over at least min_elements elements splits the array
+ * into chunks that run on a shared work-stealing thread pool; results are
+ * reassembled in array order, and an error is the one a sequential run would
+ * have thrown first. reduce does the same when its lambda is a recognized
+ * associative reducer (sum, product, min / max, merge), combining the chunks'
+ * results as a tree. Smaller arrays, and calls fused into an array operator
+ * consuming them, run sequentially.
+ *
+ * The same pool evaluates independent arguments of obj, merge, append,
+ * strConcat, zip, the arithmetic and comparison operators and let bindings
+ * concurrently (fork-join) when at least two are estimated to cost
+ * min_argument_cost evaluation steps, a loop counting as a thousand passes
+ * over its body. and, or and if stay sequential: they evaluate an argument
+ * only once the ones before it ask for it.
+ */
+struct ParallelOptions {
+    std::size_t threads{1};          // Threads per call, the calling one included; 1 disables
+    std::size_t min_elements{1024};  // Shorter arrays run sequentially
+    std::size_t chunk_size{0};       // Elements per chunk; 0 picks one from the size and threads
+    std::size_t min_argument_cost{1000}; // Cheaper operator arguments are never forked
+};
+
 // --- ExecutionContext ---
 
+struct CompiledNode;    // Internal compiled node (see Program)
+struct CompiledProgram; // Internal storage behind a Program
+struct HoistedValues;   // Loop-invariant values of one array operator call (see Program)
+
 class ExecutionContext {
 private:
     std::shared_ptr<const jsom::JsonDocument> input_ptr_;
     std::shared_ptr<const std::vector<jsom::JsonDocument>> inputs_ptr_;
+    const CompiledProgram* program_{nullptr}; // Set while running a compiled Program
+    HoistedValues* hoisted_{nullptr};         // Innermost loop call caching invariants
+    const ParallelOptions* parallel_{nullptr}; // Set when map and filter may use threads
+    bool concurrent_{false}; // Running alongside other threads of a parallel call
+    std::shared_ptr<const VariableFrame> frame_; // Innermost scope, null at top level
+    PathSegment path_;                           // Innermost path segment, empty at top level
     static const jsom::JsonDocument null_input_;
 
+    [[nodiscard]] auto with_segment(PathSegment segment) const -> ExecutionContext;
+
 public:
-    std::map<std::string, jsom::JsonDocument> variables;
-    std::vector<std::string> path;
     std::string array_key; // Custom array wrapper key
 
     // Single input constructor
@@ -144,119 +281,258 @@ public:
     explicit ExecutionContext(const std::vector<jsom::JsonDocument>& inputs,
                               std::string array_key = "array");
 
+    // Multiple inputs, shared with the caller instead of copied
+    explicit ExecutionContext(std::shared_ptr<const std::vector<jsom::JsonDocument>> inputs,
+                              std::string array_key = "array");
+
     // Accessors
     [[nodiscard]] auto input() const -> const jsom::JsonDocument& { return *input_ptr_; }
+    // Handles sharing the inputs' storage (part of one via share())
+    [[nodiscard]] auto shared_input() const -> SharedJson { return {input_ptr_, *input_ptr_}; }
+    [[nodiscard]] auto shared_inputs() const -> const std::shared_ptr<const std::vector<jsom::JsonDocument>>& {
+        return inputs_ptr_;
+    }
     [[nodiscard]] auto inputs() const -> const std::vector<jsom::JsonDocument>& { return *inputs_ptr_; }
+    [[nodiscard]] auto program() const -> const CompiledProgram* { return program_; }
+    [[nodiscard]] auto hoisted() const -> HoistedValues* { return hoisted_; }
+    [[nodiscard]] auto parallel() const -> const ParallelOptions* { return parallel_; }
+    [[nodiscard]] auto concurrent() const -> bool { return concurrent_; }
+    [[nodiscard]] auto frame() const -> const VariableFrame* { return frame_.get(); }
+
+    // Variables
+    [[nodiscard]] auto find_variable(const std::string& name) const -> const jsom::JsonDocument*;
+    [[nodiscard]] auto load_variable(std::size_t hops, std::size_t slot,
+                                     const std::string& name) const -> const jsom::JsonDocument*;
+    // The bindings themselves, to share a variable's value rather than copy it
+    [[nodiscard]] auto find_binding(const std::string& name) const -> const SharedJson*;
+    [[nodiscard]] auto load_binding(std::size_t hops, std::size_t slot,
+                                    const std::string& name) const -> const SharedJson*;
+    [[nodiscard]] auto variables() const -> std::map<std::string, jsom::JsonDocument>;
+
+    // Enters a scope holding bindings (slot i is bindings[i]; a repeated name's
+    // last binding wins)
+    [[nodiscard]] auto with_bindings(std::vector<VariableFrame::Binding> bindings) const
+        -> ExecutionContext;
 
     // Thread-safe context creation for scoping
     [[nodiscard]] auto with_variables(const std::map<std::string, jsom::JsonDocument>& vars) const
         -> ExecutionContext;
-    [[nodiscard]] auto with_path(const std::string& segment) const -> ExecutionContext;
+    [[nodiscard]] auto with_program(const CompiledProgram* program) const -> ExecutionContext;
+    // hoisted lives on the stack of the loop call it belongs to; the returned
+    // context must not outlive it
+    [[nodiscard]] auto with_hoisted(HoistedValues* hoisted) const -> ExecutionContext;
+    // options must outlive the returned context
+    [[nodiscard]] auto with_parallel(const ParallelOptions* options) const -> ExecutionContext;
+    // For evaluation on a pool thread; shared state it reaches is locked
+    [[nodiscard]] auto as_concurrent() const -> ExecutionContext;
+
+    // Path breadcrumbs. The returned context refers to this one's segment (and
+    // to name), so it must not outlive either; tail calls detach themselves.
+    [[nodiscard]] auto with_path(const char* label) const -> ExecutionContext;
+    [[nodiscard]] auto with_path(std::size_t index) const -> ExecutionContext;
+    [[nodiscard]] auto with_path(const char* label, std::size_t index) const -> ExecutionContext;
+    [[nodiscard]] auto with_path(const char* label, std::string_view name) const
+        -> ExecutionContext;
+
+    // Innermost segment of the path, null at the top level
+    [[nodiscard]] auto innermost_path() const -> const PathSegment* {
+        return path_.empty() ? path_.parent : &path_;
+    }
+    // Copies the segments between this context and anchor (an ancestor's
+    // innermost segment, which is not copied) into owned, so the context no
+    // longer refers to the contexts that built them; attach_path() hangs the
+    // copy below another context. owned must outlive the context and not
+    // reallocate in between.
+    void detach_path(const PathSegment* anchor, std::vector<PathSegment>& owned);
+    void attach_path(const ExecutionContext& parent, std::vector<PathSegment>& owned);
+    // Moves the context to a path built ahead of time, whose outermost segment
+    // has no parent; null is the top level. segment must outlive the context.
+    void set_path(const PathSegment* segment) {
+        path_ = segment != nullptr ? *segment : PathSegment{};
+    }
 
     [[nodiscard]] auto get_path_string() const -> std::string;
 };
 
 // --- TCO Support ---
 
-// Continuation for tail call optimization
+// Continuation for tail call optimization. The expression is referenced, not
+// copied: it is part of the expression being evaluated (the script or a lambda
+// value), which outlives the trampoline that runs the continuation. The path
+// segments between the trampoline and the call are copied, since the contexts
+// holding them return before the call runs.
 struct TailCall {
-    jsom::JsonDocument expression;
+    std::reference_wrapper<const jsom::JsonDocument> expression;
     ExecutionContext context;
-
-    TailCall(jsom::JsonDocument expr, ExecutionContext ctx)
-        : expression(std::move(expr)), context(std::move(ctx)) {}
+    const CompiledNode* node{nullptr}; // Set when expression belongs to a compiled program
+    std::vector<PathSegment> path_segments; // Referenced by context; moves keep the buffer
+
+    TailCall(const jsom::JsonDocument& expr, ExecutionContext ctx);
+    TailCall(const TailCall&) = delete;
+    TailCall(TailCall&&) = default;
+    auto operator=(const TailCall&) -> TailCall& = delete;
+    auto operator=(TailCall&&) -> TailCall& = default;
+    ~TailCall() = default;
 };
 
-// Result type for trampoline pattern
+// Result type for trampoline pattern. A pending tail call is stored inline, so
+// the trampoline's result slot is reused from bounce to bounce; only a tail
+// call nested below other operators' path segments allocates, to copy them.
 struct EvaluationResult {
     jsom::JsonDocument value;
     bool is_tail_call;
-    std::unique_ptr<TailCall> tail_call;
+    std::optional<TailCall> tail_call;
 
     // Constructor for regular result
     explicit EvaluationResult(jsom::JsonDocument val) : value(std::move(val)), is_tail_call(false) {}
 
     // Constructor for tail call
-    EvaluationResult(jsom::JsonDocument expr, ExecutionContext ctx)
-        : is_tail_call(true),
-          tail_call(std::make_unique<TailCall>(std::move(expr), std::move(ctx))) {}
+    EvaluationResult(const jsom::JsonDocument& expr, ExecutionContext ctx)
+        : is_tail_call(true), tail_call(std::in_place, expr, std::move(ctx)) {}
+};
+
+// --- Operator Arguments ---
+
+// Non-owning view over the arguments of an operator call, i.e. the elements of
+// ["op", arg0, arg1, ...] after the operator name. Arguments are read straight
+// from the calling expression and are never copied.
+class OperatorArgs {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = jsom::JsonDocument;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const jsom::JsonDocument*;
+        using reference = const jsom::JsonDocument&;
+
+        Iterator(const jsom::JsonDocument* call_expr, std::size_t index)
+            : call_expr_(call_expr), index_(index) {}
+
+        auto operator*() const -> reference { return (*call_expr_)[index_]; }
+        auto operator->() const -> pointer { return &(*call_expr_)[index_]; }
+        auto operator++() -> Iterator& {
+            ++index_;
+            return *this;
+        }
+        auto operator==(const Iterator& other) const -> bool { return index_ == other.index_; }
+        auto operator!=(const Iterator& other) const -> bool { return index_ != other.index_; }
+
+    private:
+        const jsom::JsonDocument* call_expr_;
+        std::size_t index_;
+    };
+
+    // call_expr must be a non-empty array whose first element is the operator name
+    explicit OperatorArgs(const jsom::JsonDocument& call_expr) : call_expr_(&call_expr) {}
+
+    [[nodiscard]] auto size() const -> std::size_t { return call_expr_->size() - 1; }
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+    [[nodiscard]] auto operator[](std::size_t index) const -> const jsom::JsonDocument& {
+        return (*call_expr_)[index + 1];
+    }
+    [[nodiscard]] auto begin() const -> Iterator { return {call_expr_, 1}; }
+    [[nodiscard]] auto end() const -> Iterator { return {call_expr_, call_expr_->size()}; }
+    [[nodiscard]] auto call_expression() const -> const jsom::JsonDocument& { return *call_expr_; }
+
+private:
+    const jsom::JsonDocument* call_expr_;
 };
 
 // --- Operator Function Signature ---
 
-using OperatorFunction = std::function<EvaluationResult(const jsom::JsonDocument&, ExecutionContext&)>;
+using OperatorFunction = EvaluationResult (*)(const OperatorArgs&, ExecutionContext&);
+
+// Dense operator index, assigned in registration order. Scripts resolve names
+// to opcodes once when loaded; dispatch is then a plain table lookup.
+using OpCode = std::uint16_t;
 
 // --- Operator Registry ---
 
 class OperatorRegistry {
 private:
-    std::map<std::string, OperatorFunction> operators_;
+    std::vector<OperatorFunction> dispatch_table_; // Indexed by OpCode
+    std::vector<std::string> operator_names_;      // Indexed by OpCode
+    std::map<std::string, OpCode> opcodes_;        // Name lookup (slow path)
     static std::once_flag initialized_;
     static std::unique_ptr<OperatorRegistry> instance_;
 
     OperatorRegistry() = default;
     void initialize_operators();
+    void register_operator(const std::string& name, OperatorFunction function);
 
 public:
     static auto get_instance() -> OperatorRegistry&;
+
+    // Name-based lookup, used by the interpreter and for introspection
     [[nodiscard]] auto get_operator(const std::string& name) const -> OperatorFunction;
     [[nodiscard]] auto has_operator(const std::string& name) const -> bool;
     [[nodiscard]] auto get_operator_names() const -> std::vector<std::string>;
+
+    // Opcode-based dispatch for loaded scripts
+    [[nodiscard]] auto find_opcode(const std::string& name) const -> std::optional<OpCode>;
+    [[nodiscard]] auto get_operator(OpCode opcode) const -> OperatorFunction {
+        return dispatch_table_[opcode];
+    }
+    [[nodiscard]] auto get_operator_name(OpCode opcode) const -> const std::string& {
+        return operator_names_[opcode];
+    }
+    [[nodiscard]] auto operator_count() const -> std::size_t { return dispatch_table_.size(); }
 };
 
 // --- Operator Forward Declarations ---
 
 // Arithmetic Operators
-auto op_addition(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_subtraction(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_multiplication(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_division(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_modulo(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_addition(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_subtraction(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_multiplication(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_division(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_modulo(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Comparison Operators
-auto op_greater_than(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_less_than(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_greater_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_less_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_not_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_greater_than(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_less_than(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_greater_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_less_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_not_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Logical Operators
-auto op_logical_and(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_logical_or(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_logical_not(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_logical_and(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_logical_or(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_logical_not(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Array Operations
-auto op_map(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_filter(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_reduce(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_count(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_find(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_some(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_every(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_map(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_filter(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_reduce(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_count(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_find(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_some(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_every(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Functional Programming
-auto op_car(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_cdr(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_cons(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_append(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_car(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_cdr(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_cons(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_append(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Object Operations
-auto op_obj(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_keys(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_values(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_obj_from_pairs(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_pick(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_omit(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_obj(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_keys(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_values(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_obj_from_pairs(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_pick(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_omit(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Data Access
-auto op_input(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_inputs(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_variable(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto op_let(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_input(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_inputs(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_variable(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_let(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Control Flow
-auto op_if(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto op_if(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // --- Core Evaluation ---
 
@@ -265,12 +541,126 @@ auto evaluate_internal(const jsom::JsonDocument& expr, const ExecutionContext& c
 auto evaluate(const jsom::JsonDocument& expr, const ExecutionContext& ctx,
               DebugContext* debug_ctx = nullptr) -> jsom::JsonDocument;
 
+// Evaluate the continuation of a tail call (one bounce of the trampoline).
+// Its path is re-attached below caller, the context running the trampoline.
+auto evaluate_tail_call(TailCall& tail_call, const ExecutionContext& caller,
+                        DebugContext* debug_ctx = nullptr) -> EvaluationResult;
+
 // --- Public API ---
 
 // Unified execution function - inputs vector can be empty, single element, or
 // multiple elements
 auto execute(const jsom::JsonDocument& script, const std::vector<jsom::JsonDocument>& inputs = {},
-             DebugContext* debug_context = nullptr, std::string array_key = "array")
-    -> jsom::JsonDocument;
+             DebugContext* debug_context = nullptr, std::string array_key = "array",
+             const ParallelOptions& parallel = {}) -> jsom::JsonDocument;
+
+// As above, taking over the inputs instead of copying them
+auto execute(const jsom::JsonDocument& script, std::vector<jsom::JsonDocument>&& inputs,
+             DebugContext* debug_context = nullptr, std::string array_key = "array",
+             const ParallelOptions& parallel = {}) -> jsom::JsonDocument;
+
+// How a Program executes its compiled tree
+enum class Backend : std::uint8_t {
+    Tree,    // Walk the compiled node tree
+    Bytecode // Run core operators on a bytecode VM; other subtrees run on the tree
+};
+
+// What compile() produced for a script
+struct ProgramStats {
+    std::size_t nodes{0};                 // Compiled tree nodes
+    std::size_t folded_nodes{0};          // Evaluations removed by constant folding
+    std::size_t hoisted_nodes{0};         // Lambda body nodes evaluated once per loop call
+    std::size_t resolved_variables{0};    // $ lookups resolved to frame slots
+    std::size_t bytecode_instructions{0}; // Backend::Bytecode only
+    std::size_t bytecode_fallbacks{0};    // Subtrees the VM hands to the tree
+};
+
+// Which parts of its inputs a program can read, from the arguments of the
+// $input and $inputs calls anywhere in its script (see Program::input_access)
+struct InputAccess {
+    bool all_inputs{false}; // A call may read any input whole (bare or computed $inputs)
+    // JSON Pointers read from each input, by input index; "" reads it whole.
+    // Inputs without an entry are never read.
+    std::map<std::size_t, std::vector<std::string>> pointers;
+
+    [[nodiscard]] auto reads_whole(std::size_t input) const -> bool;
+};
+
+// How run_batch() / execute_batch() spread documents over threads
+struct BatchOptions {
+    std::size_t threads{0};    // Threads, the calling one included; 0 uses every hardware thread
+    std::size_t chunk_size{0}; // Documents per task; 0 picks one from the count and threads
+    ParallelOptions parallel;  // For each run (parallel map / filter within one document)
+};
+
+// Outcome of one document of a batch: its result, or the exception its run
+// threw. A failing document does not stop the others.
+struct BatchResult {
+    jsom::JsonDocument value;  // null when the run failed
+    std::exception_ptr error;  // Set when the run failed
+
+    [[nodiscard]] auto ok() const -> bool { return !error; }
+    [[nodiscard]] auto error_message() const -> std::string; // what() of error, "" when ok
+};
+
+// A script compiled once into a typed node tree with operators resolved ahead
+// of time. Programs are immutable and may be run concurrently from several
+// threads; copies share the same compiled tree.
+class Program {
+public:
+    Program() = default;
+
+    [[nodiscard]] auto run(const std::vector<jsom::JsonDocument>& inputs = {},
+                           DebugContext* debug_context = nullptr,
+                           const ParallelOptions& parallel = {}) const -> jsom::JsonDocument;
+    // Takes over the inputs instead of copying them
+    [[nodiscard]] auto run(std::vector<jsom::JsonDocument>&& inputs,
+                           DebugContext* debug_context = nullptr,
+                           const ParallelOptions& parallel = {}) const -> jsom::JsonDocument;
+
+    // Run once per document, each as the single input, across a thread pool
+    // (see execute_batch)
+    [[nodiscard]] auto run_batch(const std::vector<jsom::JsonDocument>& inputs,
+                                 const BatchOptions& options = {}) const -> std::vector<BatchResult>;
+    // Takes over the inputs instead of copying them
+    [[nodiscard]] auto run_batch(std::vector<jsom::JsonDocument>&& inputs,
+                                 const BatchOptions& options = {}) const -> std::vector<BatchResult>;
+
+    [[nodiscard]] auto script() const -> const jsom::JsonDocument&; // After constant folding
+    [[nodiscard]] auto array_key() const -> const std::string&;
+    [[nodiscard]] auto node_count() const -> std::size_t;
+    [[nodiscard]] auto backend() const -> Backend;
+    [[nodiscard]] auto stats() const -> ProgramStats;
+    [[nodiscard]] auto input_access() const -> InputAccess;
+
+private:
+    [[nodiscard]] auto run_batch(std::size_t count, const BatchOptions& options,
+                                 const std::function<jsom::JsonDocument(std::size_t)>& input) const
+        -> std::vector<BatchResult>;
+
+    friend auto compile(const jsom::JsonDocument& script, std::string array_key, Backend backend)
+        -> Program;
+    std::shared_ptr<const CompiledProgram> impl_;
+};
+
+// Compile a script for repeated execution. Constant subtrees are evaluated once
+// here. Unknown operators are reported when the offending node is evaluated,
+// exactly as execute() would report them.
+// Both backends produce the same results and errors; runs with debugging
+// enabled always walk the tree.
+auto compile(const jsom::JsonDocument& script, std::string array_key = "array",
+             Backend backend = Backend::Tree) -> Program;
+
+// Apply one script to many independent documents: compile it once, run it on
+// each document (as the single input) across a thread pool, and return the
+// results in input order. Errors are captured per document rather than thrown.
+auto execute_batch(const jsom::JsonDocument& script, const std::vector<jsom::JsonDocument>& inputs,
+                   const BatchOptions& options = {}, std::string array_key = "array")
+    -> std::vector<BatchResult>;
+
+// As above, taking over the inputs instead of copying them
+auto execute_batch(const jsom::JsonDocument& script, std::vector<jsom::JsonDocument>&& inputs,
+                   const BatchOptions& options = {}, std::string array_key = "array")
+    -> std::vector<BatchResult>;
 
 } // namespace computo
@@ -0,0 +1,732 @@
+#include <bytecode.hpp>
+#include <cmath>
+#include <operators/shared.hpp>
+#include <optional>
+#include <string_view>
+
+// Threaded dispatch: each instruction jumps straight to the next one's handler
+#if defined(__GNUC__) || defined(__clang__)
+#define COMPUTO_COMPUTED_GOTO 1
+#else
+#define COMPUTO_COMPUTED_GOTO 0
+#endif
+
+namespace computo {
+
+namespace {
+
+// --- Code Generation ---
+
+auto arithmetic_op(const std::string& name) -> std::optional<BytecodeOp> {
+    if (name == "+") {
+        return BytecodeOp::Add;
+    }
+    if (name == "-") {
+        return BytecodeOp::Subtract;
+    }
+    if (name == "*") {
+        return BytecodeOp::Multiply;
+    }
+    if (name == "/") {
+        return BytecodeOp::Divide;
+    }
+    if (name == "%") {
+        return BytecodeOp::Modulo;
+    }
+    return std::nullopt;
+}
+
+auto comparison_op(const std::string& name) -> std::optional<BytecodeOp> {
+    if (name == "<") {
+        return BytecodeOp::Less;
+    }
+    if (name == ">") {
+        return BytecodeOp::Greater;
+    }
+    if (name == "<=") {
+        return BytecodeOp::LessEqual;
+    }
+    if (name == ">=") {
+        return BytecodeOp::GreaterEqual;
+    }
+    if (name == "==") {
+        return BytecodeOp::Equal;
+    }
+    if (name == "!=") {
+        return BytecodeOp::NotEqual;
+    }
+    return std::nullopt;
+}
+
+auto iter_kind_name(IterKind kind) -> const char* {
+    switch (kind) {
+    case IterKind::Map:
+        return "map";
+    case IterKind::Filter:
+        return "filter";
+    case IterKind::Reduce:
+        return "reduce";
+    }
+    return "";
+}
+
+// Parameter names of a ["lambda", params, body] literal, if it is one
+auto inline_lambda_params(const jsom::JsonDocument& expr) -> std::optional<std::vector<std::string>> {
+    if (!expr.is_array() || expr.size() != 3 || !expr[0].is_string()
+        || expr[0].as<std::string>() != "lambda" || !expr[1].is_array()) {
+        return std::nullopt;
+    }
+    std::vector<std::string> params;
+    for (const auto& param : expr[1]) {
+        if (!param.is_string()) {
+            return std::nullopt;
+        }
+        params.push_back(param.as<std::string>());
+    }
+    return params;
+}
+
+// Walks the compiled node tree, emitting instructions for the core operators.
+// Anything else (or a core operator called with arguments it would reject)
+// becomes a Fallback to the tree interpreter, so behaviour never diverges.
+class BytecodeGenerator {
+public:
+    BytecodeGenerator(const CompiledProgram& program, BytecodeProgram& out)
+        : program_(program), out_(out) {}
+
+    void generate(const CompiledNode& node) {
+        switch (node.kind) {
+        case NodeKind::Literal:
+            emit(BytecodeOp::PushConst, add_constant(*node.literal));
+            return;
+        case NodeKind::LiteralArray:
+            for (std::size_t i = 0; i < node.children.size(); ++i) {
+                generate_at(*node.children[i], nullptr, {}, i);
+            }
+            emit(BytecodeOp::MakeArray, static_cast<std::uint32_t>(node.children.size()));
+            return;
+        case NodeKind::VariableLoad:
+            emit(BytecodeOp::LoadVariable, add_node(node));
+            return;
+        case NodeKind::OperatorCall:
+            if (node.opcode && generate_operator(node)) {
+                return;
+            }
+            break;
+        case NodeKind::ArrayObject:
+            break;
+        }
+        emit(BytecodeOp::Fallback, add_node(node));
+        ++out_.fallbacks;
+    }
+
+private:
+    const CompiledProgram& program_;
+    BytecodeProgram& out_;
+    const PathSegment* path_{nullptr}; // Where the tree evaluates the node being generated
+
+    auto emit(BytecodeOp op, std::uint32_t a = 0, std::uint32_t b = 0) -> std::size_t {
+        out_.code.push_back({op, a, b});
+        out_.paths.push_back(path_);
+        return out_.code.size() - 1;
+    }
+
+    // Generates node where the tree evaluates it, in ctx.with_path(label, name)
+    // or ctx.with_path(label, index) of the node being generated
+    void generate_at(const CompiledNode& node, const char* label, std::string_view name,
+                     std::size_t index = PathSegment::NO_INDEX) {
+        const auto* parent = path_;
+        path_ = &out_.path_segments.emplace_back(PathSegment{parent, label, name, index});
+        generate(node);
+        path_ = parent;
+    }
+
+    // Points the jump at index to the next instruction emitted
+    void patch(std::size_t index) { out_.code[index].a = static_cast<std::uint32_t>(out_.code.size()); }
+
+    auto add_constant(const jsom::JsonDocument& value) -> std::uint32_t {
+        out_.constants.push_back(value);
+        return static_cast<std::uint32_t>(out_.constants.size() - 1);
+    }
+
+    auto add_node(const CompiledNode& node) -> std::uint32_t {
+        out_.nodes.push_back(&node);
+        return static_cast<std::uint32_t>(out_.nodes.size() - 1);
+    }
+
+    auto add_names(std::vector<std::string> names) -> std::uint32_t {
+        out_.name_lists.push_back(std::move(names));
+        return static_cast<std::uint32_t>(out_.name_lists.size() - 1);
+    }
+
+    // NOLINTBEGIN(readability-function-size)
+    auto generate_operator(const CompiledNode& node) -> bool {
+        const auto& name = node.operator_name;
+        const auto& expr = *node.expression;
+        const auto argc = node.children.size();
+
+        if (auto op = arithmetic_op(name)) {
+            if (argc < (name == "%" ? 2U : 1U)) {
+                return false;
+            }
+            // One operand at a time: the first one that is not a number (or a zero
+            // divisor) fails before the operands after it are evaluated
+            for (std::size_t i = 0; i < argc; ++i) {
+                generate(*node.children[i]);
+                emit(*op, i == 0 ? 1U : 2U, argc == 1 ? 1U : 0U);
+            }
+            return true;
+        }
+        if (auto op = comparison_op(name)) {
+            if (argc != 2) {
+                return false; // Chained comparisons short-circuit; leave them to the tree
+            }
+            generate_at(*node.children[0], "arg", {}, 0);
+            generate_at(*node.children[1], "arg", {}, 1);
+            emit(*op);
+            return true;
+        }
+        if (name == "not") {
+            if (argc != 1) {
+                return false;
+            }
+            generate_at(*node.children[0], "arg", {}, 0);
+            emit(BytecodeOp::Not);
+            return true;
+        }
+        if (name == "and" || name == "or") {
+            if (argc == 0) {
+                return false;
+            }
+            bool is_and = name == "and";
+            std::vector<std::size_t> short_circuits;
+            for (std::size_t i = 0; i < argc; ++i) {
+                generate_at(*node.children[i], "arg", {}, i);
+                short_circuits.push_back(
+                    emit(is_and ? BytecodeOp::JumpIfFalse : BytecodeOp::JumpIfTrue));
+            }
+            emit(BytecodeOp::PushConst, add_constant(jsom::JsonDocument(is_and)));
+            auto done = emit(BytecodeOp::Jump);
+            for (auto jump : short_circuits) {
+                patch(jump);
+            }
+            emit(BytecodeOp::PushConst, add_constant(jsom::JsonDocument(!is_and)));
+            patch(done);
+            return true;
+        }
+        if (name == "if") {
+            if (argc != 3) {
+                return false;
+            }
+            generate_at(*node.children[0], "condition", {});
+            auto to_else = emit(BytecodeOp::JumpIfFalse);
+            generate_at(*node.children[1], "then", {});
+            auto done = emit(BytecodeOp::Jump);
+            patch(to_else);
+            generate_at(*node.children[2], "else", {});
+            patch(done);
+            return true;
+        }
+        if (name == "$input") {
+            if (argc == 0) {
+                emit(BytecodeOp::LoadInput);
+                return true;
+            }
+            if (argc == 1 && expr[1].is_string()) {
+                out_.strings.push_back(expr[1].as<std::string>());
+                emit(BytecodeOp::LoadInputPointer,
+                     static_cast<std::uint32_t>(out_.strings.size() - 1));
+                return true;
+            }
+            return false;
+        }
+        if (name == "let") {
+            return generate_let(node);
+        }
+        if (name == "map") {
+            return generate_loop(node, IterKind::Map);
+        }
+        if (name == "filter") {
+            return generate_loop(node, IterKind::Filter);
+        }
+        if (name == "reduce") {
+            return generate_loop(node, IterKind::Reduce);
+        }
+        return false;
+    }
+    // NOLINTEND(readability-function-size)
+
+    auto generate_let(const CompiledNode& node) -> bool {
+        const auto& expr = *node.expression;
+        if (node.children.size() != 2) {
+            return false;
+        }
+
+        // Same binding order as let_operator: slot i holds binding i
+        std::vector<std::string> names;
+        std::vector<const CompiledNode*> values;
+        auto add_binding = [&](const std::string& binding_name, const jsom::JsonDocument& value) {
+            names.push_back(binding_name);
+            values.push_back(program_.find_node(value));
+        };
+        const auto& bindings = expr[1];
+        if (bindings.is_object()) {
+            for (const auto& [key, value] : bindings.items()) {
+                add_binding(key, bindings[key]); // The indexed member, not a copy
+            }
+        } else if (bindings.is_array()) {
+            for (const auto& binding : bindings) {
+                if (!binding.is_array() || binding.size() != 2 || !binding[0].is_string()) {
+                    return false;
+                }
+                add_binding(binding[0].as<std::string>(), binding[1]);
+            }
+        } else {
+            return false;
+        }
+        for (const auto* value : values) {
+            if (value == nullptr) {
+                return false;
+            }
+        }
+
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            generate_at(*values[i], "binding_value_for_", out_.path_names.emplace_back(names[i]));
+        }
+        auto count = static_cast<std::uint32_t>(names.size());
+        emit(BytecodeOp::Bind, add_names(std::move(names)), count);
+        generate_at(*node.children[1], "let_body", {});
+        emit(BytecodeOp::Unbind);
+        return true;
+    }
+
+    // map/filter/reduce with an inline lambda of the right arity; the lambda
+    // body is emitted in place as the loop body
+    auto generate_loop(const CompiledNode& node, IterKind kind) -> bool {
+        const bool is_reduce = kind == IterKind::Reduce;
+        if (node.children.size() != (is_reduce ? 3U : 2U)) {
+            return false;
+        }
+        auto params = inline_lambda_params((*node.expression)[2]);
+        const auto& lambda = *node.children[1];
+        if (!params || params->size() != (is_reduce ? 2U : 1U) || lambda.children.size() != 2) {
+            return false;
+        }
+
+        generate(*node.children[0]);
+        if (is_reduce) {
+            generate(*node.children[2]);
+        }
+        emit(BytecodeOp::IterBegin, static_cast<std::uint32_t>(kind));
+        auto loop = static_cast<std::uint32_t>(out_.code.size());
+        auto next = emit(BytecodeOp::IterNext, 0, add_names(std::move(*params)));
+        generate_at(*lambda.children[1], "lambda_body", {});
+        emit(BytecodeOp::IterCollect);
+        emit(BytecodeOp::Jump, loop);
+        patch(next);
+        emit(BytecodeOp::IterEnd);
+        return true;
+    }
+};
+
+// --- Execution ---
+
+// A value on the VM stack: one the VM computed, or a handle to one that
+// already exists (a constant, the input, a variable), which is never copied
+class StackValue {
+public:
+    StackValue(jsom::JsonDocument value) // NOLINT(google-explicit-constructor)
+        : value_(std::move(value)) {}
+    StackValue(SharedJson shared) // NOLINT(google-explicit-constructor)
+        : shared_(std::move(shared)), is_shared_(true) {}
+
+    [[nodiscard]] auto operator*() const -> const jsom::JsonDocument& {
+        return is_shared_ ? *shared_ : value_;
+    }
+
+    // The value to keep or modify
+    [[nodiscard]] auto take() && -> jsom::JsonDocument {
+        return is_shared_ ? std::move(shared_).take() : std::move(value_);
+    }
+
+    // A handle to the value, for bindings and loops
+    [[nodiscard]] auto share() && -> SharedJson {
+        return is_shared_ ? std::move(shared_) : SharedJson(std::move(value_));
+    }
+
+private:
+    jsom::JsonDocument value_;
+    SharedJson shared_;
+    bool is_shared_{false};
+};
+
+// An active map/filter/reduce loop
+struct Iteration {
+    IterKind kind;
+    SharedJson items; // Shared with the element bindings
+    std::size_t next{0};
+    jsom::JsonDocument result; // Collected array, or the reduce accumulator
+};
+
+auto numeric_operand(const jsom::JsonDocument& value, const char* op_name,
+                     const ExecutionContext& ctx) -> double {
+    if (!value.is_number()) {
+        throw InvalidArgumentException(std::string("'") + op_name + "' requires numeric arguments",
+                                       ctx.get_path_string());
+    }
+    return value.as<double>();
+}
+
+auto nonzero_divisor(double divisor, const char* message, const ExecutionContext& ctx) -> double {
+    if (divisor == 0.0) {
+        throw InvalidArgumentException(message, ctx.get_path_string());
+    }
+    return divisor;
+}
+
+} // namespace
+
+auto generate_bytecode(const CompiledProgram& program) -> BytecodeProgram {
+    BytecodeProgram bytecode;
+    BytecodeGenerator generator(program, bytecode);
+    generator.generate(program.nodes.front());
+    bytecode.code.push_back({BytecodeOp::Return});
+    bytecode.paths.push_back(nullptr);
+    return bytecode;
+}
+
+// NOLINTBEGIN(readability-function-size)
+auto run_bytecode(const BytecodeProgram& bytecode, const ExecutionContext& ctx)
+    -> jsom::JsonDocument {
+    const Instruction* code = bytecode.code.data();
+    const Instruction* instruction = code;
+    std::vector<StackValue> stack;
+    std::vector<ExecutionContext> scopes{ctx}; // scopes.back() holds the innermost frame
+    std::vector<Iteration> loops;
+    constexpr std::size_t INITIAL_STACK = 16;
+    stack.reserve(INITIAL_STACK);
+
+    // Pops the top value
+    auto pop = [&stack]() {
+        auto value = std::move(stack.back());
+        stack.pop_back();
+        return value;
+    };
+    // The n values on top of the stack, in push order
+    auto top = [&stack](std::size_t count) { return stack.data() + (stack.size() - count); };
+    auto drop = [&stack](std::size_t count) {
+        stack.erase(stack.end() - static_cast<std::ptrdiff_t>(count), stack.end());
+    };
+    // The innermost scope, at the path of the current instruction's node; only
+    // needed where the instruction can fail or runs a subtree on the tree
+    auto at = [&]() -> const ExecutionContext& {
+        auto& scope = scopes.back();
+        scope.set_path(bytecode.paths[static_cast<std::size_t>(instruction - code)]);
+        return scope;
+    };
+    // Starts an arithmetic result with the operand on top (start(operand)), or
+    // folds that operand into the result below it (combine(result, operand))
+    auto arithmetic = [&](const char* op_name, auto start, auto combine) {
+        const auto& scope = at();
+        double operand = numeric_operand(*stack.back(), op_name, scope);
+        stack.pop_back();
+        if (instruction->a == 1) {
+            stack.emplace_back(jsom::JsonDocument(start(operand, scope)));
+        } else {
+            auto& result = stack.back();
+            result = jsom::JsonDocument(combine((*result).as<double>(), operand, scope));
+        }
+    };
+    auto as_is = [](double operand, const ExecutionContext& /*scope*/) { return operand; };
+
+#if COMPUTO_COMPUTED_GOTO
+    static const void* const dispatch_table[] = {
+        &&op_PushConst, &&op_MakeArray,  &&op_LoadInput,   &&op_LoadInputPointer,
+        &&op_LoadVariable, &&op_Add,     &&op_Subtract,    &&op_Multiply,
+        &&op_Divide,    &&op_Modulo,     &&op_Less,        &&op_Greater,
+        &&op_LessEqual, &&op_GreaterEqual, &&op_Equal,     &&op_NotEqual,
+        &&op_Not,       &&op_Jump,       &&op_JumpIfFalse, &&op_JumpIfTrue,
+        &&op_Bind,      &&op_Unbind,     &&op_IterBegin,   &&op_IterNext,
+        &&op_IterCollect, &&op_IterEnd, &&op_Fallback,     &&op_Return};
+    static_assert(sizeof(dispatch_table) / sizeof(dispatch_table[0])
+                      == static_cast<std::size_t>(BytecodeOp::Return) + 1,
+                  "dispatch_table must list every BytecodeOp in order");
+#define VM_CASE(name) op_##name
+#define VM_NEXT() goto* dispatch_table[static_cast<std::size_t>(instruction->op)]
+    VM_NEXT();
+#else
+#define VM_CASE(name) case BytecodeOp::name
+#define VM_NEXT() goto dispatch
+dispatch:
+    switch (instruction->op) {
+#endif
+
+    VM_CASE(PushConst) : {
+        // Constants outlive the run, so the handle needs no owner
+        stack.emplace_back(SharedJson(nullptr, bytecode.constants[instruction->a]));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(MakeArray) : {
+        auto array = jsom::JsonDocument::make_array();
+        auto* elements = top(instruction->a);
+        for (std::uint32_t i = 0; i < instruction->a; ++i) {
+            array.push_back(std::move(elements[i]).take());
+        }
+        drop(instruction->a);
+        stack.emplace_back(std::move(array));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(LoadInput) : {
+        stack.emplace_back(scopes.back().shared_input());
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(LoadInputPointer) : {
+        const auto& scope = scopes.back();
+        const auto& pointer = bytecode.strings[instruction->a];
+        if (const auto* value = find_json_pointer(scope.input(), pointer)) {
+            stack.emplace_back(scope.shared_input().share(*value));
+        } else {
+            stack.emplace_back(evaluate_json_pointer(scope.input(), pointer, at(), "$input"));
+        }
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(LoadVariable) : {
+        const auto& node = *bytecode.nodes[instruction->a];
+        const auto* binding = find_compiled_binding(node, scopes.back());
+        const jsom::JsonDocument* value = nullptr;
+        if (binding != nullptr) {
+            const auto& sub_path = node.variable.sub_path;
+            value = sub_path.empty() ? &binding->get() : find_json_pointer(**binding, sub_path);
+        }
+        if (value != nullptr) {
+            stack.emplace_back(binding->share(*value));
+        } else {
+            stack.emplace_back(load_compiled_variable(node, at())); // Fails, or an escaped pointer
+        }
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Add) : {
+        arithmetic(
+            "+", [](double operand, const ExecutionContext& /*scope*/) { return 0.0 + operand; },
+            [](double result, double operand, const ExecutionContext& /*scope*/) {
+                return result + operand;
+            });
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Subtract) : {
+        const bool negate = instruction->b == 1; // Unary negation
+        arithmetic(
+            "-",
+            [negate](double operand, const ExecutionContext& /*scope*/) {
+                return negate ? -operand : operand;
+            },
+            [](double result, double operand, const ExecutionContext& /*scope*/) {
+                return result - operand;
+            });
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Multiply) : {
+        arithmetic(
+            "*", [](double operand, const ExecutionContext& /*scope*/) { return 1.0 * operand; },
+            [](double result, double operand, const ExecutionContext& /*scope*/) {
+                return result * operand;
+            });
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Divide) : {
+        const bool invert = instruction->b == 1; // Reciprocal
+        arithmetic(
+            "/",
+            [invert](double operand, const ExecutionContext& scope) {
+                return invert ? 1.0 / nonzero_divisor(operand, "Division by zero", scope)
+                              : operand;
+            },
+            [](double result, double operand, const ExecutionContext& scope) {
+                return result / nonzero_divisor(operand, "Division by zero", scope);
+            });
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Modulo) : {
+        arithmetic("%", as_is, [](double result, double operand, const ExecutionContext& scope) {
+            return std::fmod(result, nonzero_divisor(operand, "Modulo by zero", scope));
+        });
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Less) : {
+        const auto& scope = at();
+        const auto* args = top(2);
+        bool result = numeric_operand(*args[0], "<", scope) < numeric_operand(*args[1], "<", scope);
+        drop(2);
+        stack.emplace_back(jsom::JsonDocument(result));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Greater) : {
+        const auto& scope = at();
+        const auto* args = top(2);
+        bool result = numeric_operand(*args[0], ">", scope) > numeric_operand(*args[1], ">", scope);
+        drop(2);
+        stack.emplace_back(jsom::JsonDocument(result));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(LessEqual) : {
+        const auto& scope = at();
+        const auto* args = top(2);
+        bool result
+            = numeric_operand(*args[0], "<=", scope) <= numeric_operand(*args[1], "<=", scope);
+        drop(2);
+        stack.emplace_back(jsom::JsonDocument(result));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(GreaterEqual) : {
+        const auto& scope = at();
+        const auto* args = top(2);
+        bool result
+            = numeric_operand(*args[0], ">=", scope) >= numeric_operand(*args[1], ">=", scope);
+        drop(2);
+        stack.emplace_back(jsom::JsonDocument(result));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Equal) : {
+        const auto* args = top(2);
+        bool result = *args[0] == *args[1];
+        drop(2);
+        stack.emplace_back(jsom::JsonDocument(result));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(NotEqual) : {
+        const auto* args = top(2);
+        bool result = *args[0] != *args[1];
+        drop(2);
+        stack.emplace_back(jsom::JsonDocument(result));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Not) : {
+        bool result = !is_truthy(*stack.back());
+        stack.back() = jsom::JsonDocument(result);
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Jump) : {
+        instruction = code + instruction->a;
+        VM_NEXT();
+    }
+    VM_CASE(JumpIfFalse) : {
+        instruction = is_truthy(*pop()) ? instruction + 1 : code + instruction->a;
+        VM_NEXT();
+    }
+    VM_CASE(JumpIfTrue) : {
+        instruction = is_truthy(*pop()) ? code + instruction->a : instruction + 1;
+        VM_NEXT();
+    }
+    VM_CASE(Bind) : {
+        const auto& names = bytecode.name_lists[instruction->a];
+        auto* values = top(instruction->b);
+        std::vector<VariableFrame::Binding> bindings;
+        bindings.reserve(instruction->b);
+        for (std::uint32_t i = 0; i < instruction->b; ++i) {
+            bindings.push_back({names[i], std::move(values[i]).share()});
+        }
+        drop(instruction->b);
+        scopes.push_back(scopes.back().with_bindings(std::move(bindings)));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Unbind) : {
+        scopes.pop_back();
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(IterBegin) : {
+        auto kind = static_cast<IterKind>(instruction->a);
+        jsom::JsonDocument result
+            = kind == IterKind::Reduce ? pop().take() : jsom::JsonDocument::make_array();
+        auto array_input = pop().share();
+        const auto& items = borrow_array_data(*array_input, iter_kind_name(kind), at());
+        loops.push_back({kind, array_input.share(items), 0, std::move(result)});
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(IterNext) : {
+        auto& loop = loops.back();
+        if (loop.next == loop.items->size()) {
+            instruction = code + instruction->a;
+            VM_NEXT();
+        }
+        const auto& names = bytecode.name_lists[instruction->b];
+        std::vector<VariableFrame::Binding> bindings;
+        if (loop.kind == IterKind::Reduce) {
+            // The accumulator is replaced by IterCollect, so it can move
+            bindings.push_back({names[0], SharedJson(std::move(loop.result))});
+            bindings.push_back({names[1], loop.items.share((*loop.items)[loop.next])});
+        } else {
+            bindings.push_back({names[0], loop.items.share((*loop.items)[loop.next])});
+        }
+        ++loop.next;
+        scopes.push_back(scopes.back().with_bindings(std::move(bindings)));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(IterCollect) : {
+        auto& loop = loops.back();
+        switch (loop.kind) {
+        case IterKind::Map:
+            loop.result.push_back(pop().take());
+            break;
+        case IterKind::Filter:
+            if (is_truthy(*pop())) {
+                loop.result.push_back((*loop.items)[loop.next - 1]);
+            }
+            break;
+        case IterKind::Reduce:
+            loop.result = pop().take();
+            break;
+        }
+        scopes.pop_back();
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(IterEnd) : {
+        auto& loop = loops.back();
+        if (loop.kind == IterKind::Reduce) {
+            stack.emplace_back(std::move(loop.result));
+        } else {
+            stack.emplace_back(
+                jsom::JsonDocument{{scopes.back().array_key, std::move(loop.result)}});
+        }
+        loops.pop_back();
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Fallback) : {
+        stack.emplace_back(evaluate_shared(*bytecode.nodes[instruction->a]->expression, at()));
+        ++instruction;
+        VM_NEXT();
+    }
+    VM_CASE(Return) : { return pop().take(); }
+
+#if !COMPUTO_COMPUTED_GOTO
+    }
+    return {};
+#endif
+#undef VM_CASE
+#undef VM_NEXT
+}
+// NOLINTEND(readability-function-size)
+
+} // namespace computo
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <computo.hpp>
+#include <cstdint>
+#include <deque>
+#include <program.hpp>
+#include <string>
+#include <vector>
+
+namespace computo {
+
+// --- Bytecode Backend ---
+
+/**
+ * Instructions of the bytecode VM, a stack machine over JSON values
+ *
+ * Core operators (arithmetic, comparison, logical, if, let, $, $input, map,
+ * filter, reduce) are lowered to instructions; any other subtree becomes a
+ * single Fallback instruction that runs it on the tree interpreter.
+ * The order must match the dispatch table in run_bytecode().
+ */
+enum class BytecodeOp : std::uint8_t {
+    PushConst,        // Push constants[a]
+    MakeArray,        // Pop a values into a new array (Rule 3 literal arrays)
+    LoadInput,        // Push the first input
+    LoadInputPointer, // Push the value at JSON Pointer strings[a] in the first input
+    LoadVariable,     // Push the value of the ["$", ...] node nodes[a]
+    // Arithmetic takes its operands one at a time, checking each as the tree
+    // interpreter does: a == 1 starts the result with the operand on top
+    // (negated / inverted when b == 1, a lone "-" / "/" operand), a == 2 pops
+    // the operand on top into the result below it
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Less, // Pop two numbers, push the comparison (likewise Greater ... GreaterEqual)
+    Greater,
+    LessEqual,
+    GreaterEqual,
+    Equal, // Pop two values, push whether they are (not) equal
+    NotEqual,
+    Not,         // Pop a value, push its negated truthiness
+    Jump,        // Continue at a
+    JumpIfFalse, // Pop a value, continue at a if it is falsy
+    JumpIfTrue,  // Pop a value, continue at a if it is truthy
+    Bind,        // Pop b values into a new frame named by name_lists[a]
+    Unbind,      // Drop the innermost frame
+    IterBegin,   // Pop an array (and for reduce the initial value) and start an IterKind a loop
+    IterNext,    // Bind the next item as name_lists[b], or end the loop at a
+    IterCollect, // Pop the lambda result into the loop and drop its frame
+    IterEnd,     // Push the loop's result
+    Fallback,    // Push the tree-interpreted value of nodes[a]
+    Return       // Stop with the top of the stack as the result
+};
+
+/**
+ * Loop flavour of an IterBegin ... IterEnd sequence
+ */
+enum class IterKind : std::uint8_t { Map, Filter, Reduce };
+
+struct Instruction {
+    BytecodeOp op;
+    std::uint32_t a{0};
+    std::uint32_t b{0};
+};
+
+/**
+ * A compiled program lowered to bytecode
+ *
+ * Nodes referenced by LoadVariable and Fallback belong to the CompiledProgram
+ * the bytecode was generated from, which must outlive it.
+ */
+struct BytecodeProgram {
+    std::vector<Instruction> code;
+    // paths[i]: execution path of the node code[i] belongs to (null at the top
+    // level), so errors are reported where the tree interpreter reports them
+    std::vector<const PathSegment*> paths;
+    std::deque<PathSegment> path_segments; // What paths point into
+    std::deque<std::string> path_names;    // Binding names path_segments borrow
+    std::vector<jsom::JsonDocument> constants;
+    std::vector<std::string> strings;
+    std::vector<std::vector<std::string>> name_lists; // Frame layouts for Bind / IterNext
+    std::vector<const CompiledNode*> nodes;
+    std::size_t fallbacks{0}; // Subtrees left to the tree interpreter
+};
+
+/**
+ * Lower a compiled program to bytecode
+ */
+auto generate_bytecode(const CompiledProgram& program) -> BytecodeProgram;
+
+/**
+ * Run bytecode against ctx, which must be running the program it was
+ * generated from (fallback subtrees use its compiled nodes) at the top level.
+ * Errors are the ones execute() would throw, with the same execution path.
+ */
+auto run_bytecode(const BytecodeProgram& bytecode, const ExecutionContext& ctx)
+    -> jsom::JsonDocument;
+
+} // namespace computo
@@ -1,6 +1,7 @@
 #include "cli_args.hpp"
 #include <cstring>
 #include <iostream>
+#include <limits>
 
 namespace computo {
 
@@ -8,6 +9,7 @@ auto ArgumentParser::parse(int argc, char* const argv[]) -> ComputoArgs {
     ComputoArgs args{};
     bool script_mode = false;
     bool repl_mode = false;
+    bool serve_mode = false;
 
     if (argc == 1) {
         args.show_help = true;
@@ -19,6 +21,9 @@ auto ArgumentParser::parse(int argc, char* const argv[]) -> ComputoArgs {
             if (repl_mode) {
                 throw ArgumentError("--script and --repl are mutually exclusive");
             }
+            if (serve_mode) {
+                throw ArgumentError("--script and --serve are mutually exclusive");
+            }
             script_mode = true;
             args.mode = ComputoArgs::Mode::SCRIPT;
             if (++i >= argc) {
@@ -29,12 +34,33 @@ auto ArgumentParser::parse(int argc, char* const argv[]) -> ComputoArgs {
             if (script_mode) {
                 throw ArgumentError("--script and --repl are mutually exclusive");
             }
+            if (serve_mode) {
+                throw ArgumentError("--repl and --serve are mutually exclusive");
+            }
             repl_mode = true;
             args.mode = ComputoArgs::Mode::REPL;
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            if (script_mode || repl_mode) {
+                throw ArgumentError("--serve cannot be combined with --script or --repl");
+            }
+            serve_mode = true;
+            args.mode = ComputoArgs::Mode::SERVE;
+            if (++i >= argc) {
+                throw ArgumentError("--serve requires a socket path argument");
+            }
+            args.socket_path = argv[i];
         } else if (strcmp(argv[i], "--comments") == 0) {
             args.enable_comments = true;
         } else if (strcmp(argv[i], "--debug") == 0) {
             args.debug_mode = true;
+        } else if (strcmp(argv[i], "--bytecode") == 0) {
+            args.bytecode = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            args.show_stats = true;
+        } else if (strcmp(argv[i], "--ndjson") == 0) {
+            args.ndjson = true;
+        } else if (strcmp(argv[i], "--lazy-input") == 0) {
+            args.lazy_input = true;
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             args.show_help = true;
             return args;
@@ -68,6 +94,12 @@ auto ArgumentParser::parse(int argc, char* const argv[]) -> ComputoArgs {
                 throw ArgumentError("--tojson requires a file argument");
             }
             args.to_json_file = argv[i];
+        } else if (strcmp(argv[i], "--compile-to") == 0) {
+            args.compile_to = true;
+            if (++i >= argc) {
+                throw ArgumentError("--compile-to requires an output file argument");
+            }
+            args.compile_to_file = argv[i];
         } else if (strcmp(argv[i], "--color") == 0) {
             args.color_mode = ColorMode::Always;
         } else if (strcmp(argv[i], "--no-color") == 0) {
@@ -77,6 +109,28 @@ auto ArgumentParser::parse(int argc, char* const argv[]) -> ComputoArgs {
             if (args.array_key.empty()) {
                 throw ArgumentError("--array requires a non-empty key");
             }
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            std::string count(argv[i] + 10);
+            if (count.empty() || count.find_first_not_of("0123456789") != std::string::npos
+                || count.size() > 4 || std::stoul(count) == 0) {
+                throw ArgumentError("--threads requires a positive thread count");
+            }
+            args.threads = std::stoul(count);
+        } else if (strncmp(argv[i], "--max-request-bytes=", 20) == 0) {
+            std::string limit(argv[i] + 20);
+            if (limit.empty() || limit.find_first_not_of("0123456789") != std::string::npos
+                || limit.size() > 10 || std::stoull(limit) == 0
+                || std::stoull(limit) > std::numeric_limits<std::uint32_t>::max()) {
+                throw ArgumentError("--max-request-bytes requires a byte count below 4 GB");
+            }
+            args.max_request_bytes = std::stoull(limit);
+        } else if (strncmp(argv[i], "--max-connections=", 18) == 0) {
+            std::string count(argv[i] + 18);
+            if (count.empty() || count.find_first_not_of("0123456789") != std::string::npos
+                || count.size() > 6 || std::stoul(count) == 0) {
+                throw ArgumentError("--max-connections requires a positive connection count");
+            }
+            args.max_connections = std::stoul(count);
         } else if (argv[i][0] == '-') {
             throw ArgumentError("Unknown option: " + std::string(argv[i]));
         } else {
@@ -85,10 +139,19 @@ auto ArgumentParser::parse(int argc, char* const argv[]) -> ComputoArgs {
         }
     }
 
-    if (!script_mode && !repl_mode && !args.highlight_script && !args.format_script &&
+    if (!script_mode && !repl_mode && !serve_mode && !args.highlight_script && !args.format_script &&
         !args.to_computo && !args.to_json) {
         throw ArgumentError("Must specify either --script or --repl mode");
     }
+    if (serve_mode && args.input_files.empty()) {
+        throw ArgumentError("--serve requires at least one script file");
+    }
+    if (args.ndjson && !script_mode) {
+        throw ArgumentError("--ndjson requires --script");
+    }
+    if (args.compile_to && !script_mode) {
+        throw ArgumentError("--compile-to requires --script");
+    }
 
     return args;
 }
@@ -99,19 +162,39 @@ void ArgumentParser::print_help() {
 USAGE:
     computo --script <SCRIPT> [OPTIONS] [INPUT_FILES...]
     computo --repl [OPTIONS] [INPUT_FILES...]
+    computo --serve <SOCKET> [OPTIONS] SCRIPT_FILES...
 
 MODES:
     --script <file>    Execute script from file (auto-detects JSON or sugar)
     --repl             Start interactive REPL
+    --serve <socket>   Keep the given scripts compiled and run them on request over a Unix
+                       socket; each script's id is its file name without extension
 
 CONVERSION:
     --tocomputo <file> Convert JSON script to sugar syntax (.computo)
     --tojson <file>    Convert sugar syntax (.computo) to JSON
+    --compile-to <file>
+                       Write the --script script in compiled binary form (.computoc), which
+                       --script then loads without parsing
 
 OPTIONS:
     --comments         Enable JSON comment parsing
     --debug            Enable debugging features (REPL only)
     --array=<key>      Use custom array wrapper key (default: "array")
+    --bytecode         Run the script on the bytecode VM (--script only)
+    --stats            Print compilation statistics to stderr (--script only)
+    --threads=<n>      Run map, filter and reduce over large arrays on n threads (--script only);
+                       with --ndjson, run n records at a time instead
+    --max-request-bytes=<n>
+                       Reject --serve requests whose input is longer than n bytes
+                       (default: 67108864)
+    --max-connections=<n>
+                       Serve at most n --serve connections at once; further clients wait
+                       to be accepted until one closes (default: 64)
+    --ndjson           Read newline-delimited JSON records from the input files (or stdin)
+                       and print one compact result line per record (--script only)
+    --lazy-input       Parse only the parts of input files that the script's literal
+                       $input / $inputs pointers read (--script only)
     --format <file>    Reformat script with semantic indentation
     --highlight <file> Display script with syntax highlighting
     --color            Force colored output (with --highlight)
@@ -125,8 +208,14 @@ EXAMPLES:
     computo --script script.computo data.json
     computo --tocomputo transform.json
     computo --tojson script.computo
+    computo --script script.computo --compile-to script.computoc
     computo --script transform.json data.json --array="@data"
+    computo --script transform.json data.json --bytecode
+    computo --script transform.json data.json --threads=8
+    computo --script transform.json --ndjson < events.ndjson
+    computo --script transform.json events.json --lazy-input
     computo --repl --comments users.json orders.json
+    computo --serve /tmp/computo.sock transform.json summary.computoc
     computo --repl --debug
     computo --format script.json
     computo --highlight script.computo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -10,14 +11,16 @@
 namespace computo {
 
 struct ComputoArgs {
-    enum class Mode : std::uint8_t { SCRIPT, REPL };
+    enum class Mode : std::uint8_t { SCRIPT, REPL, SERVE };
     Mode mode;
     std::string script_file; // Only valid in SCRIPT mode
-    std::vector<std::string> input_files;
+    std::vector<std::string> input_files; // In SERVE mode, the scripts to serve
+    std::string socket_path;              // Only valid in SERVE mode
     std::string highlight_file; // Only valid when highlight_script is true
     std::string format_file;    // Only valid when format_script is true
     std::string to_computo_file; // --tocomputo: convert JSON to sugar syntax
     std::string to_json_file;    // --tojson: convert sugar to JSON
+    std::string compile_to_file; // --compile-to: write the script's compiled (.computoc) form
     bool enable_comments = false;
     bool debug_mode = false;
     bool show_help = false;
@@ -27,6 +30,14 @@ struct ComputoArgs {
     bool format_script = false;
     bool to_computo = false;
     bool to_json = false;
+    bool compile_to = false;
+    bool bytecode = false; // --bytecode: run scripts on the bytecode VM
+    bool show_stats = false; // --stats: report compilation statistics on stderr
+    bool ndjson = false; // --ndjson: run the script once per newline-delimited JSON record
+    bool lazy_input = false; // --lazy-input: parse only the input parts the script's pointers read
+    std::size_t threads = 1; // --threads: threads per map / filter / reduce call over a large array
+    std::size_t max_request_bytes = std::size_t{64} << 20; // --max-request-bytes, for --serve
+    std::size_t max_connections = 64; // --max-connections: --serve connections served at once
     std::string array_key = "array"; // Custom array wrapper key (default: "array")
     ColorMode color_mode = ColorMode::Auto;
 };
@@ -1,7 +1,11 @@
+#include <algorithm>
 #include <cmath>
 #include <computo.hpp>
+#include <native_stack.hpp>
 #include <operators/shared.hpp>
 #include <optional>
+#include <utility>
+#include <program.hpp>
 
 namespace computo {
 
@@ -10,48 +14,301 @@ const jsom::JsonDocument ExecutionContext::null_input_ = jsom::JsonDocument(null
 std::once_flag OperatorRegistry::initialized_;
 std::unique_ptr<OperatorRegistry> OperatorRegistry::instance_;
 
+// --- SharedJson Implementation ---
+
+auto SharedJson::null_value() -> const jsom::JsonDocument& {
+    static const jsom::JsonDocument null_json(nullptr);
+    return null_json;
+}
+
+auto SharedJson::take() && -> jsom::JsonDocument {
+    if (owns_value_ && value_.use_count() == 1) {
+        // Allocated non-const by this handle, and nothing else can see it
+        return std::move(const_cast<jsom::JsonDocument&>(*value_)); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+    return *value_;
+}
+
+// --- VariableFrame Implementation ---
+
+namespace {
+
+// Largest parent frame checked for being shadowed; lambda parameter lists and
+// let blocks are small, and the check runs once per frame
+constexpr std::size_t MAX_ELIDED_FRAME_SIZE = 8;
+
+auto shadows(const std::vector<VariableFrame::Binding>& bindings, const VariableFrame& parent)
+    -> bool {
+    if (parent.bindings().empty() || parent.bindings().size() > MAX_ELIDED_FRAME_SIZE) {
+        return false;
+    }
+    for (const auto& hidden : parent.bindings()) {
+        auto rebound = std::any_of(bindings.begin(), bindings.end(),
+                                   [&](const auto& binding) { return binding.name == hidden.name; });
+        if (!rebound) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+VariableFrame::VariableFrame(std::shared_ptr<const VariableFrame> parent,
+                             std::vector<Binding> bindings)
+    : parent_(std::move(parent)), bindings_(std::move(bindings)) {
+    if (parent_ && shadows(bindings_, *parent_)) {
+        elided_ = 1 + parent_->elided_;
+        parent_ = parent_->parent_;
+    }
+}
+
+auto VariableFrame::find(const VariableFrame* frame, const std::string& name) -> const SharedJson* {
+    for (; frame != nullptr; frame = frame->parent()) {
+        const auto& bindings = frame->bindings_;
+        // Later bindings in a frame win, matching map assignment semantics
+        for (auto index = bindings.size(); index > 0; --index) {
+            if (bindings[index - 1].name == name) {
+                return &bindings[index - 1].value;
+            }
+        }
+    }
+    return nullptr;
+}
+
+auto VariableFrame::load(const VariableFrame* frame, std::size_t hops, std::size_t slot,
+                         const std::string& name) -> const SharedJson* {
+    // hops counts frames as compiled, including any elided since
+    while (hops > 0 && frame != nullptr) {
+        if (hops <= frame->elided_) {
+            return nullptr; // Target was shadowed: only find() knows the answer
+        }
+        hops -= 1 + frame->elided_;
+        frame = frame->parent();
+    }
+    if (frame == nullptr || slot >= frame->bindings_.size()) {
+        return nullptr;
+    }
+    const auto& binding = frame->bindings_[slot];
+    return binding.name == name ? &binding.value : nullptr;
+}
+
+auto VariableFrame::flatten(const VariableFrame* frame) -> std::map<std::string, jsom::JsonDocument> {
+    std::map<std::string, jsom::JsonDocument> result;
+    for (; frame != nullptr; frame = frame->parent()) {
+        const auto& bindings = frame->bindings_;
+        for (auto index = bindings.size(); index > 0; --index) {
+            // emplace keeps the first (innermost) binding seen for each name
+            result.emplace(bindings[index - 1].name, *bindings[index - 1].value);
+        }
+    }
+    return result;
+}
+
 // --- ExecutionContext Implementation ---
 
+// $input is the first of $inputs: input_ptr_ shares that element rather than
+// holding a second copy of it
 ExecutionContext::ExecutionContext(const jsom::JsonDocument& input, std::string array_key)
-    : input_ptr_(std::make_shared<jsom::JsonDocument>(input)),
-      inputs_ptr_(
-          std::make_shared<std::vector<jsom::JsonDocument>>(std::vector<jsom::JsonDocument>{input})),
-      array_key(std::move(array_key)) {}
+    : ExecutionContext(std::make_shared<const std::vector<jsom::JsonDocument>>(1, input),
+                       std::move(array_key)) {}
 
 ExecutionContext::ExecutionContext(const std::vector<jsom::JsonDocument>& inputs, std::string array_key)
-    : input_ptr_(inputs.empty() ? std::make_shared<jsom::JsonDocument>(null_input_)
-                                : std::make_shared<jsom::JsonDocument>(inputs[0])),
-      inputs_ptr_(std::make_shared<std::vector<jsom::JsonDocument>>(inputs)),
-      array_key(std::move(array_key)) {}
+    : ExecutionContext(std::make_shared<const std::vector<jsom::JsonDocument>>(inputs),
+                       std::move(array_key)) {}
+
+ExecutionContext::ExecutionContext(std::shared_ptr<const std::vector<jsom::JsonDocument>> inputs,
+                                   std::string array_key)
+    : inputs_ptr_(std::move(inputs)), array_key(std::move(array_key)) {
+    input_ptr_ = inputs_ptr_->empty()
+                     ? std::shared_ptr<const jsom::JsonDocument>(std::shared_ptr<void>(), &null_input_)
+                     : std::shared_ptr<const jsom::JsonDocument>(inputs_ptr_, &inputs_ptr_->front());
+}
+
+auto ExecutionContext::find_variable(const std::string& name) const -> const jsom::JsonDocument* {
+    const auto* binding = find_binding(name);
+    return binding != nullptr ? &binding->get() : nullptr;
+}
+
+auto ExecutionContext::load_variable(std::size_t hops, std::size_t slot,
+                                     const std::string& name) const -> const jsom::JsonDocument* {
+    const auto* binding = load_binding(hops, slot, name);
+    return binding != nullptr ? &binding->get() : nullptr;
+}
+
+auto ExecutionContext::find_binding(const std::string& name) const -> const SharedJson* {
+    return VariableFrame::find(frame_.get(), name);
+}
+
+auto ExecutionContext::load_binding(std::size_t hops, std::size_t slot,
+                                    const std::string& name) const -> const SharedJson* {
+    return VariableFrame::load(frame_.get(), hops, slot, name);
+}
+
+auto ExecutionContext::variables() const -> std::map<std::string, jsom::JsonDocument> {
+    return VariableFrame::flatten(frame_.get());
+}
+
+auto ExecutionContext::with_bindings(std::vector<VariableFrame::Binding> bindings) const
+    -> ExecutionContext {
+    ExecutionContext new_ctx = *this;
+    new_ctx.frame_ = std::make_shared<const VariableFrame>(frame_, std::move(bindings));
+    return new_ctx;
+}
 
 auto ExecutionContext::with_variables(const std::map<std::string, jsom::JsonDocument>& vars) const
     -> ExecutionContext {
-    ExecutionContext new_ctx(*inputs_ptr_, array_key);
-    new_ctx.variables = variables; // Copy existing
-    new_ctx.path = path;           // Copy path
+    std::vector<VariableFrame::Binding> bindings;
+    bindings.reserve(vars.size());
     for (const auto& pair : vars) {
-        new_ctx.variables[pair.first] = pair.second; // Add new
+        bindings.push_back({pair.first, SharedJson(pair.second)});
     }
+    return with_bindings(std::move(bindings));
+}
+
+auto ExecutionContext::with_program(const CompiledProgram* program) const -> ExecutionContext {
+    ExecutionContext new_ctx = *this;
+    new_ctx.program_ = program;
+    return new_ctx;
+}
+
+auto ExecutionContext::with_hoisted(HoistedValues* hoisted) const -> ExecutionContext {
+    ExecutionContext new_ctx = *this;
+    new_ctx.hoisted_ = hoisted;
+    return new_ctx;
+}
+
+auto ExecutionContext::with_parallel(const ParallelOptions* options) const -> ExecutionContext {
+    ExecutionContext new_ctx = *this;
+    new_ctx.parallel_ = options;
+    return new_ctx;
+}
+
+auto ExecutionContext::as_concurrent() const -> ExecutionContext {
+    ExecutionContext new_ctx = *this;
+    new_ctx.concurrent_ = true;
     return new_ctx;
 }
 
-auto ExecutionContext::with_path(const std::string& segment) const -> ExecutionContext {
+auto ExecutionContext::with_segment(PathSegment segment) const -> ExecutionContext {
     ExecutionContext new_ctx = *this;
-    new_ctx.path.push_back(segment);
+    segment.parent = path_.empty() ? path_.parent : &path_;
+    new_ctx.path_ = segment;
     return new_ctx;
 }
 
+auto ExecutionContext::with_path(const char* label) const -> ExecutionContext {
+    return with_segment({nullptr, label, {}, PathSegment::NO_INDEX});
+}
+
+auto ExecutionContext::with_path(std::size_t index) const -> ExecutionContext {
+    return with_segment({nullptr, nullptr, {}, index});
+}
+
+auto ExecutionContext::with_path(const char* label, std::size_t index) const -> ExecutionContext {
+    return with_segment({nullptr, label, {}, index});
+}
+
+auto ExecutionContext::with_path(const char* label, std::string_view name) const
+    -> ExecutionContext {
+    return with_segment({nullptr, label, name, PathSegment::NO_INDEX});
+}
+
+// Contexts are copied by value (with_bindings, the operator call), so the
+// chain below the trampoline may reach a copy of its segment rather than the
+// segment itself; a copy has the same parent and prints the same
+static auto is_anchor(const PathSegment* segment, const PathSegment* anchor) -> bool {
+    if (segment == anchor) {
+        return true;
+    }
+    return anchor != nullptr && segment->parent == anchor->parent &&
+           segment->label == anchor->label && segment->name == anchor->name &&
+           segment->index == anchor->index;
+}
+
+void ExecutionContext::detach_path(const PathSegment* anchor, std::vector<PathSegment>& owned) {
+    owned.clear();
+    if (!path_.empty() && is_anchor(&path_, anchor)) {
+        // The tail call sits at the trampoline's own segment
+        path_ = PathSegment{};
+        return;
+    }
+    for (const auto* segment = path_.parent; segment != nullptr && !is_anchor(segment, anchor);
+         segment = segment->parent) {
+        owned.push_back(*segment);
+    }
+    for (std::size_t i = 0; i < owned.size(); ++i) {
+        owned[i].parent = i + 1 < owned.size() ? &owned[i + 1] : nullptr;
+    }
+    path_.parent = owned.empty() ? nullptr : owned.data();
+}
+
+void ExecutionContext::attach_path(const ExecutionContext& parent,
+                                   std::vector<PathSegment>& owned) {
+    (owned.empty() ? path_.parent : owned.back().parent) = parent.innermost_path();
+}
+
 auto ExecutionContext::get_path_string() const -> std::string {
-    if (path.empty()) {
+    std::vector<const PathSegment*> segments;
+    for (const auto* segment = path_.empty() ? path_.parent : &path_; segment != nullptr;
+         segment = segment->parent) {
+        segments.push_back(segment);
+    }
+    if (segments.empty()) {
         return "/";
     }
     std::string result;
-    for (const auto& seg : path) {
-        result += "/" + seg;
+    for (auto iter = segments.rbegin(); iter != segments.rend(); ++iter) {
+        const auto& segment = **iter;
+        result += '/';
+        if (segment.label != nullptr) {
+            result += segment.label;
+        }
+        result += segment.name;
+        if (segment.index != PathSegment::NO_INDEX) {
+            result += std::to_string(segment.index);
+        }
     }
     return result;
 }
 
+// --- TCO Support Implementation ---
+
+namespace {
+
+// Innermost segment of the context of the trampoline running on this thread;
+// a tail call copies the segments below it
+thread_local const PathSegment* trampoline_path = nullptr;
+
+// Sets trampoline_path for the lifetime of one trampoline
+class TrampolinePath {
+public:
+    explicit TrampolinePath(const ExecutionContext& caller)
+        : previous_(std::exchange(trampoline_path, caller.innermost_path())) {}
+    TrampolinePath(const TrampolinePath&) = delete;
+    TrampolinePath(TrampolinePath&&) = delete;
+    auto operator=(const TrampolinePath&) -> TrampolinePath& = delete;
+    auto operator=(TrampolinePath&&) -> TrampolinePath& = delete;
+    ~TrampolinePath() { trampoline_path = previous_; }
+
+private:
+    const PathSegment* previous_;
+};
+
+} // namespace
+
+TailCall::TailCall(const jsom::JsonDocument& expr, ExecutionContext ctx)
+    : expression(expr), context(std::move(ctx)) {
+    // The operators between the trampoline and this tail call are about to
+    // return: their segments are copied, and the trampoline re-attaches them
+    // below its own context
+    context.detach_path(trampoline_path, path_segments);
+
+    if (context.program() != nullptr) {
+        node = context.program()->find_node(expr);
+    }
+}
+
 // --- Operator Registry Implementation ---
 
 auto OperatorRegistry::get_instance() -> OperatorRegistry& {
@@ -63,165 +320,180 @@ auto OperatorRegistry::get_instance() -> OperatorRegistry& {
 }
 
 auto OperatorRegistry::get_operator(const std::string& name) const -> OperatorFunction {
-    auto iter = operators_.find(name);
-    if (iter == operators_.end()) {
+    auto iter = opcodes_.find(name);
+    if (iter == opcodes_.end()) {
         auto available_ops = get_operator_names();
         auto suggestions = suggest_similar_names(name, available_ops, 2);
 
         std::string suggestion = suggestions.empty() ? "" : suggestions[0];
         throw InvalidOperatorException(name, suggestion);
     }
-    return iter->second;
+    return dispatch_table_[iter->second];
 }
 
 auto OperatorRegistry::has_operator(const std::string& name) const -> bool {
-    return operators_.find(name) != operators_.end();
+    return opcodes_.find(name) != opcodes_.end();
 }
 
 auto OperatorRegistry::get_operator_names() const -> std::vector<std::string> {
     std::vector<std::string> names;
-    names.reserve(operators_.size());
-    for (const auto& [name, _] : operators_) {
+    names.reserve(opcodes_.size());
+    for (const auto& [name, _] : opcodes_) {
         names.push_back(name);
     }
     return names;
 }
 
+auto OperatorRegistry::find_opcode(const std::string& name) const -> std::optional<OpCode> {
+    auto iter = opcodes_.find(name);
+    if (iter == opcodes_.end()) {
+        return std::nullopt;
+    }
+    return iter->second;
+}
+
+void OperatorRegistry::register_operator(const std::string& name, OperatorFunction function) {
+    auto opcode = static_cast<OpCode>(dispatch_table_.size());
+    dispatch_table_.push_back(function);
+    operator_names_.push_back(name);
+    opcodes_[name] = opcode;
+}
+
 namespace operators {
 // Forward declarations for operators defined in other files
-auto addition(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto subtraction(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto multiplication(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto division(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto modulo(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto addition(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto subtraction(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto multiplication(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto division(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto modulo(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Comparison Operators
-auto greater_than(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto less_than(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto greater_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto less_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto not_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto greater_than(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto less_than(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto greater_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto less_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto not_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Data Access Operators
-auto input_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto inputs_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto variable_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto let_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto input_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto inputs_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto variable_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto let_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Logical Operators
-auto logical_and(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto logical_or(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto logical_not(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto logical_and(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto logical_or(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto logical_not(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Control Flow Operators
-auto if_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto if_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Lambda Operator
-auto lambda_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto lambda_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Object Operators
-auto obj_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto keys_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto values_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto objFromPairs_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto pick_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto omit_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto merge_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto obj_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto keys_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto values_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto objFromPairs_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto pick_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto omit_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto merge_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Array Operators
-auto map_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto filter_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto reduce_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto count_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto find_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto some_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto every_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto map_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto filter_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto reduce_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto count_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto find_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto some_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto every_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // Functional Programming Operators
-auto car_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto cdr_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto cons_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto append_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto car_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto cdr_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto cons_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto append_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 
 // String and Utility Operators
-auto join_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto strConcat_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto sort_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto reverse_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto unique_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto unique_sorted_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto zip_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
-auto approx_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult;
+auto join_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto strConcat_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto sort_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto reverse_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto unique_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto unique_sorted_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto zip_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
+auto approx_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult;
 } // namespace operators
 
 // NOLINTBEGIN(readability-function-size)
 void OperatorRegistry::initialize_operators() {
     // Arithmetic Operators
-    operators_["+"] = operators::addition;
-    operators_["-"] = operators::subtraction;
-    operators_["*"] = operators::multiplication;
-    operators_["/"] = operators::division;
-    operators_["%"] = operators::modulo;
+    register_operator("+", operators::addition);
+    register_operator("-", operators::subtraction);
+    register_operator("*", operators::multiplication);
+    register_operator("/", operators::division);
+    register_operator("%", operators::modulo);
 
     // Comparison Operators
-    operators_[">"] = operators::greater_than;
-    operators_["<"] = operators::less_than;
-    operators_[">="] = operators::greater_equal;
-    operators_["<="] = operators::less_equal;
-    operators_["=="] = operators::equal;
-    operators_["!="] = operators::not_equal;
+    register_operator(">", operators::greater_than);
+    register_operator("<", operators::less_than);
+    register_operator(">=", operators::greater_equal);
+    register_operator("<=", operators::less_equal);
+    register_operator("==", operators::equal);
+    register_operator("!=", operators::not_equal);
 
     // Data Access Operators
-    operators_["$input"] = operators::input_operator;
-    operators_["$inputs"] = operators::inputs_operator;
-    operators_["$"] = operators::variable_operator;
-    operators_["let"] = operators::let_operator;
+    register_operator("$input", operators::input_operator);
+    register_operator("$inputs", operators::inputs_operator);
+    register_operator("$", operators::variable_operator);
+    register_operator("let", operators::let_operator);
 
     // Logical Operators
-    operators_["and"] = operators::logical_and;
-    operators_["or"] = operators::logical_or;
-    operators_["not"] = operators::logical_not;
+    register_operator("and", operators::logical_and);
+    register_operator("or", operators::logical_or);
+    register_operator("not", operators::logical_not);
 
     // Control Flow Operators
-    operators_["if"] = operators::if_operator;
+    register_operator("if", operators::if_operator);
 
     // Lambda Operator
-    operators_["lambda"] = operators::lambda_operator;
+    register_operator("lambda", operators::lambda_operator);
 
     // Object Operators
-    operators_["obj"] = operators::obj_operator;
-    operators_["keys"] = operators::keys_operator;
-    operators_["values"] = operators::values_operator;
-    operators_["objFromPairs"] = operators::objFromPairs_operator;
-    operators_["pick"] = operators::pick_operator;
-    operators_["omit"] = operators::omit_operator;
-    operators_["merge"] = operators::merge_operator;
+    register_operator("obj", operators::obj_operator);
+    register_operator("keys", operators::keys_operator);
+    register_operator("values", operators::values_operator);
+    register_operator("objFromPairs", operators::objFromPairs_operator);
+    register_operator("pick", operators::pick_operator);
+    register_operator("omit", operators::omit_operator);
+    register_operator("merge", operators::merge_operator);
 
     // Array Operators
-    operators_["map"] = operators::map_operator;
-    operators_["filter"] = operators::filter_operator;
-    operators_["reduce"] = operators::reduce_operator;
-    operators_["count"] = operators::count_operator;
-    operators_["find"] = operators::find_operator;
-    operators_["some"] = operators::some_operator;
-    operators_["every"] = operators::every_operator;
+    register_operator("map", operators::map_operator);
+    register_operator("filter", operators::filter_operator);
+    register_operator("reduce", operators::reduce_operator);
+    register_operator("count", operators::count_operator);
+    register_operator("find", operators::find_operator);
+    register_operator("some", operators::some_operator);
+    register_operator("every", operators::every_operator);
 
     // Functional Programming Operators
-    operators_["car"] = operators::car_operator;
-    operators_["cdr"] = operators::cdr_operator;
-    operators_["cons"] = operators::cons_operator;
-    operators_["append"] = operators::append_operator;
+    register_operator("car", operators::car_operator);
+    register_operator("cdr", operators::cdr_operator);
+    register_operator("cons", operators::cons_operator);
+    register_operator("append", operators::append_operator);
 
     // String and Utility Operators
-    operators_["join"] = operators::join_operator;
-    operators_["strConcat"] = operators::strConcat_operator;
-    operators_["sort"] = operators::sort_operator;
-    operators_["reverse"] = operators::reverse_operator;
-    operators_["unique"] = operators::unique_operator;
-    operators_["uniqueSorted"] = operators::unique_sorted_operator;
-    operators_["zip"] = operators::zip_operator;
-    operators_["approx"] = operators::approx_operator;
+    register_operator("join", operators::join_operator);
+    register_operator("strConcat", operators::strConcat_operator);
+    register_operator("sort", operators::sort_operator);
+    register_operator("reverse", operators::reverse_operator);
+    register_operator("unique", operators::unique_operator);
+    register_operator("uniqueSorted", operators::unique_sorted_operator);
+    register_operator("zip", operators::zip_operator);
+    register_operator("approx", operators::approx_operator);
 }
 // NOLINTEND(readability-function-size)
 
@@ -245,7 +517,7 @@ static auto handle_debug_integration(const std::string& operator_name, const Exe
 
     // Record execution step if tracing is enabled
     if (debug_ctx->is_trace_enabled()) {
-        debug_ctx->record_step(operator_name, ctx.get_path_string(), ctx.variables, expr);
+        debug_ctx->record_step(operator_name, ctx.get_path_string(), ctx.variables(), expr);
     }
 
     // Check for operator breakpoint
@@ -260,6 +532,23 @@ static auto handle_debug_integration(const std::string& operator_name, const Exe
     }
 }
 
+// The one trampoline: runs step() and bounces its tail calls to a final value.
+// Operators re-enter here for every nested evaluate(), so this is also where
+// evaluation moves to a fresh native stack segment once the current one runs
+// low; deep (non-tail) recursion is then bounded by memory, not the thread stack.
+template <typename Step>
+static auto run_trampoline(Step&& step, const ExecutionContext& caller, DebugContext* debug_ctx)
+    -> jsom::JsonDocument {
+    return native_stack::with_headroom([&] {
+        TrampolinePath scope(caller);
+        auto result = step();
+        while (result.is_tail_call) {
+            result = evaluate_tail_call(*result.tail_call, caller, debug_ctx);
+        }
+        return std::move(result.value);
+    });
+}
+
 // --- Core Evaluation (Updated with Registry and TCO) ---
 
 // Handles literal arrays like [1, 2, 3] or [true, "a"]
@@ -271,12 +560,10 @@ auto evaluate_literal_array(const jsom::JsonDocument& expr, const ExecutionConte
     }
 
     // Rule 3: Non-string first elements → treat as literal array
-    // Evaluate each element and return as literal array
+    // Evaluate each element (resolving tail calls) and return as literal array
     jsom::JsonDocument result = jsom::JsonDocument::make_array();
     for (size_t i = 0; i < expr.size(); ++i) {
-        auto element_result
-            = evaluate_internal(expr[i], ctx.with_path(std::to_string(i)), debug_ctx);
-        result.push_back(element_result.value);
+        result.push_back(evaluate(expr[i], ctx.with_path(i), debug_ctx));
     }
     return EvaluationResult(result);
 }
@@ -290,11 +577,8 @@ auto evaluate_operator_call(const jsom::JsonDocument& expr, const ExecutionConte
     // Handle debug integration (breakpoints, tracing, stepping)
     handle_debug_integration(operator_name, ctx, expr, debug_ctx);
 
-    // Extract arguments (everything after the operator name)
-    jsom::JsonDocument args = jsom::JsonDocument::make_array();
-    for (size_t i = 1; i < expr.size(); ++i) {
-        args.push_back(expr[i]);
-    }
+    // Arguments are a view over expr[1..n]; nothing is copied
+    OperatorArgs args(expr);
 
     // Get operator from registry and execute
     auto& registry = OperatorRegistry::get_instance();
@@ -307,8 +591,129 @@ auto evaluate_operator_call(const jsom::JsonDocument& expr, const ExecutionConte
     return operator_func(args, mutable_ctx);
 }
 
+auto find_compiled_binding(const CompiledNode& node, const ExecutionContext& ctx)
+    -> const SharedJson* {
+    const auto& name = node.variable.variable_name;
+    const SharedJson* binding = nullptr;
+    if (node.variable_slot) {
+        binding = ctx.load_binding(node.variable_slot->hops, node.variable_slot->slot, name);
+    }
+    if (binding == nullptr) {
+        binding = ctx.find_binding(name); // Bound outside the program, or not at all
+    }
+    return binding;
+}
+
+auto load_compiled_variable(const CompiledNode& node, const ExecutionContext& ctx)
+    -> jsom::JsonDocument {
+    const auto* binding = find_compiled_binding(node, ctx);
+    return variable_value(binding != nullptr ? &binding->get() : nullptr, node.variable, ctx);
+}
+
+// Dispatches a node of a compiled Program; classification and operator lookup
+// already happened in compile()
+// NOLINTBEGIN(readability-function-size)
+static auto evaluate_compiled_node(const CompiledNode& node, const ExecutionContext& ctx,
+                                   DebugContext* debug_ctx) -> EvaluationResult {
+    switch (node.kind) {
+    case NodeKind::Literal:
+        return EvaluationResult(*node.literal);
+    case NodeKind::ArrayObject:
+        return evaluate_array_object(*node.expression, ctx, debug_ctx);
+    case NodeKind::LiteralArray: {
+        jsom::JsonDocument result = jsom::JsonDocument::make_array();
+        for (size_t i = 0; i < node.children.size(); ++i) {
+            auto element_ctx = ctx.with_path(i);
+            result.push_back(run_trampoline(
+                [&] { return evaluate_compiled(*node.children[i], element_ctx, debug_ctx); },
+                element_ctx, debug_ctx));
+        }
+        return EvaluationResult(result);
+    }
+    case NodeKind::VariableLoad:
+        handle_debug_integration(node.operator_name, ctx, *node.expression, debug_ctx);
+        return EvaluationResult(load_compiled_variable(node, ctx));
+    case NodeKind::OperatorCall:
+        break;
+    }
+
+    handle_debug_integration(node.operator_name, ctx, *node.expression, debug_ctx);
+    auto& registry = OperatorRegistry::get_instance();
+    if (!node.opcode) {
+        // Unknown operator: the name lookup produces the usual error and suggestion
+        (void)registry.get_operator(node.operator_name);
+    }
+
+    if (node.hoisted_count > 0) {
+        // Array operators return values, never tail calls, so no context
+        // referring to hoisted outlives this call
+        HoistedValues hoisted{&node, ctx.hoisted(),
+                              std::make_unique<HoistedSlot[]>(node.hoisted_count)};
+        ExecutionContext loop_ctx = ctx.with_hoisted(&hoisted);
+        return registry.get_operator(*node.opcode)(OperatorArgs(*node.expression), loop_ctx);
+    }
+
+    ExecutionContext mutable_ctx = ctx;
+    return registry.get_operator(*node.opcode)(OperatorArgs(*node.expression), mutable_ctx);
+}
+// NOLINTEND(readability-function-size)
+
+// The running call of the loop a hoisted node belongs to, or nullptr when the
+// loop is not running on the tree (e.g. the bytecode VM ran it)
+static auto find_hoisted_values(const CompiledNode& node, const ExecutionContext& ctx)
+    -> HoistedValues* {
+    for (auto* hoisted = ctx.hoisted(); hoisted != nullptr; hoisted = hoisted->parent) {
+        if (hoisted->loop == node.hoisted_in) {
+            return hoisted;
+        }
+    }
+    return nullptr;
+}
+
+auto hoisted_value(const CompiledNode& node, const ExecutionContext& ctx, DebugContext* debug_ctx)
+    -> const jsom::JsonDocument* {
+    if (node.hoisted_in == nullptr) {
+        return nullptr;
+    }
+    auto* hoisted = find_hoisted_values(node, ctx);
+    if (hoisted == nullptr) {
+        return nullptr;
+    }
+    // Evaluated where the first element reaches it, so errors and their paths
+    // are unchanged; later elements reuse the value
+    auto& slot = hoisted->slots[node.hoist_slot];
+    if (const auto* value = slot.ready.load(std::memory_order_acquire)) {
+        return value;
+    }
+    // No lock is held while evaluating: the node may reach other invariants
+    // of this call, and parallel chunks must not queue behind it
+    auto value = run_trampoline([&] { return evaluate_compiled_node(node, ctx, debug_ctx); }, ctx,
+                                debug_ctx);
+    std::lock_guard<std::mutex> lock(slot.publish);
+    if (!slot.value) {
+        slot.value = std::move(value);
+        slot.ready.store(&*slot.value, std::memory_order_release);
+    }
+    return &*slot.value;
+}
+
+auto evaluate_compiled(const CompiledNode& node, const ExecutionContext& ctx, DebugContext* debug_ctx)
+    -> EvaluationResult {
+    if (const auto* value = hoisted_value(node, ctx, debug_ctx)) {
+        return EvaluationResult(*value);
+    }
+    return evaluate_compiled_node(node, ctx, debug_ctx);
+}
+
 auto evaluate_internal(const jsom::JsonDocument& expr, const ExecutionContext& ctx,
                        DebugContext* debug_ctx) -> EvaluationResult {
+    // 0. Expressions owned by a compiled program skip classification entirely
+    if (ctx.program() != nullptr) {
+        if (const auto* node = ctx.program()->find_node(expr)) {
+            return evaluate_compiled(*node, ctx, debug_ctx);
+        }
+    }
+
     // 1. Handle simple literals (numbers, strings, booleans, null, objects)
     if (!expr.is_array()) {
         if (expr.is_object() && expr.size() == 1 && expr.contains(ctx.array_key)) {
@@ -328,24 +733,58 @@ auto evaluate_internal(const jsom::JsonDocument& expr, const ExecutionContext& c
 // Trampoline function for TCO
 auto evaluate(const jsom::JsonDocument& expr, const ExecutionContext& ctx, DebugContext* debug_ctx)
     -> jsom::JsonDocument {
-    auto result = evaluate_internal(expr, ctx, debug_ctx);
+    return run_trampoline([&] { return evaluate_internal(expr, ctx, debug_ctx); }, ctx,
+                          debug_ctx);
+}
 
-    // Keep bouncing until we get a final result
-    while (result.is_tail_call) {
-        result
-            = evaluate_internal(result.tail_call->expression, result.tail_call->context, debug_ctx);
+auto evaluate_tail_call(TailCall& tail_call, const ExecutionContext& caller, DebugContext* debug_ctx)
+    -> EvaluationResult {
+    tail_call.context.attach_path(caller, tail_call.path_segments);
+    if (tail_call.node != nullptr) {
+        return evaluate_compiled(*tail_call.node, tail_call.context, debug_ctx);
     }
-
-    return result.value;
+    return evaluate_internal(tail_call.expression.get(), tail_call.context, debug_ctx);
 }
 
 // --- Public API Implementation ---
 
 // Unified execution function
 auto execute(const jsom::JsonDocument& script, const std::vector<jsom::JsonDocument>& inputs,
-             DebugContext* debug_context, std::string array_key) -> jsom::JsonDocument {
+             DebugContext* debug_context, std::string array_key, const ParallelOptions& parallel)
+    -> jsom::JsonDocument {
     ExecutionContext ctx(inputs, std::move(array_key));
-    return evaluate(script, ctx, debug_context);
+    return evaluate(script, ctx.with_parallel(&parallel), debug_context);
+}
+
+auto execute(const jsom::JsonDocument& script, std::vector<jsom::JsonDocument>&& inputs,
+             DebugContext* debug_context, std::string array_key, const ParallelOptions& parallel)
+    -> jsom::JsonDocument {
+    ExecutionContext ctx(std::make_shared<const std::vector<jsom::JsonDocument>>(std::move(inputs)),
+                         std::move(array_key));
+    return evaluate(script, ctx.with_parallel(&parallel), debug_context);
+}
+
+auto BatchResult::error_message() const -> std::string {
+    if (!error) {
+        return {};
+    }
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        return e.what();
+    } catch (...) {
+        return "unknown error";
+    }
+}
+
+auto execute_batch(const jsom::JsonDocument& script, const std::vector<jsom::JsonDocument>& inputs,
+                   const BatchOptions& options, std::string array_key) -> std::vector<BatchResult> {
+    return compile(script, std::move(array_key)).run_batch(inputs, options);
+}
+
+auto execute_batch(const jsom::JsonDocument& script, std::vector<jsom::JsonDocument>&& inputs,
+                   const BatchOptions& options, std::string array_key) -> std::vector<BatchResult> {
+    return compile(script, std::move(array_key)).run_batch(std::move(inputs), options);
 }
 
 } // namespace computo
@@ -0,0 +1,174 @@
+#include "json_writer.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace computo {
+
+namespace {
+
+// Hands all of data to fd, however many write(2) calls that takes
+void write_all(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        auto chunk = static_cast<unsigned int>(std::min<std::size_t>(size, std::size_t{1} << 30));
+        auto written = _write(fd, data, chunk);
+#else
+        auto written = ::write(fd, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Could not write output: ")
+                                     + std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+// Keys without anything to escape go out as they are; the rest through jsom,
+// so they read exactly as in to_json()
+void write_key(OutputSink& sink, std::string_view key) {
+    bool plain = std::all_of(key.begin(), key.end(), [](char c) {
+        auto byte = static_cast<unsigned char>(c);
+        return byte >= 0x20 && byte < 0x7f && c != '"' && c != '\\';
+    });
+    if (plain) {
+        sink.put('"');
+        sink.write(key);
+        sink.put('"');
+    } else {
+        sink.write(jsom::JsonDocument(std::string(key)).to_json());
+    }
+}
+
+// Whether items() hands out the object's own members. If it returns a fresh
+// container instead, walking it would copy every subtree once per level
+// above it, so objects are then serialized by jsom in one piece
+constexpr bool ITEMS_BORROW_MEMBERS =
+    std::is_reference_v<decltype(std::declval<const jsom::JsonDocument&>().items())>;
+
+void write_value(OutputSink& sink, const jsom::JsonDocument& value) {
+    if (value.is_array()) {
+        if (value.empty()) {
+            sink.write("[]");
+            return;
+        }
+        sink.put('[');
+        bool first = true;
+        for (const auto& element : value) {
+            if (!first) {
+                sink.put(',');
+            }
+            first = false;
+            write_value(sink, element);
+        }
+        sink.put(']');
+    } else if (value.is_object() && ITEMS_BORROW_MEMBERS) {
+        if (value.empty()) {
+            sink.write("{}");
+            return;
+        }
+        sink.put('{');
+        bool first = true;
+        for (const auto& [key, member] : value.items()) {
+            if (!first) {
+                sink.put(',');
+            }
+            first = false;
+            write_key(sink, key);
+            sink.put(':');
+            write_value(sink, member);
+        }
+        sink.put('}');
+    } else {
+        sink.write(value.to_json()); // Scalars are small; jsom formats numbers and escapes
+    }
+}
+
+} // namespace
+
+OutputSink::OutputSink(int fd, std::size_t capacity, OutputFraming framing)
+    : fd_(fd), framing_(framing), buffer_(std::max<std::size_t>(capacity, 1)) {}
+
+OutputSink::~OutputSink() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Nowhere left to report it
+    }
+}
+
+void OutputSink::write(std::string_view bytes) {
+    if (bytes.size() > buffer_.size() - used_) {
+        flush();
+        if (bytes.size() >= buffer_.size()) {
+            emit(bytes.data(), bytes.size());
+            return;
+        }
+    }
+    std::memcpy(buffer_.data() + used_, bytes.data(), bytes.size());
+    used_ += bytes.size();
+}
+
+void OutputSink::put(char byte) {
+    if (used_ == buffer_.size()) {
+        flush();
+    }
+    buffer_[used_++] = byte;
+}
+
+void OutputSink::flush() {
+    auto size = std::exchange(used_, 0);
+    emit(buffer_.data(), size);
+}
+
+void OutputSink::end_message() {
+    flush();
+    if (framing_ == OutputFraming::LengthPrefixed) {
+        const std::array<char, 4> empty{};
+        write_all(fd_, empty.data(), empty.size());
+    }
+}
+
+void OutputSink::emit(const char* data, std::size_t size) {
+    if (framing_ == OutputFraming::None) {
+        write_all(fd_, data, size);
+        return;
+    }
+    // Chunks stay below 4 GB; an empty one would end the message early
+    while (size > 0) {
+        auto chunk = static_cast<std::uint32_t>(std::min<std::size_t>(size, std::size_t{1} << 30));
+        std::array<char, 4> header{};
+        for (std::size_t i = 0; i < header.size(); ++i) {
+            header[i] = static_cast<char>((chunk >> (8 * i)) & 0xFFU);
+        }
+        write_all(fd_, header.data(), header.size());
+        write_all(fd_, data, chunk);
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void write_json(OutputSink& sink, const jsom::JsonDocument& value, bool pretty) {
+    if (pretty) {
+        sink.write(value.to_json(true)); // jsom's own layout, as before the writer
+        return;
+    }
+    write_value(sink, value);
+}
+
+} // namespace computo
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <computo.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace computo {
+
+// --- Streaming JSON Output ---
+
+/**
+ * How an OutputSink frames the bytes it writes
+ */
+enum class OutputFraming : std::uint8_t {
+    None,          // Bytes go out as they are
+    LengthPrefixed // Each chunk is preceded by its length (4 bytes, little-endian)
+};
+
+/**
+ * Buffered output to a file descriptor: bytes collect in one large buffer
+ * that is handed to write(2) whenever it fills, so output of any size needs
+ * no more memory than the buffer
+ */
+class OutputSink {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = std::size_t{1} << 20;
+
+    explicit OutputSink(int fd, std::size_t capacity = DEFAULT_CAPACITY,
+                        OutputFraming framing = OutputFraming::None);
+    OutputSink(const OutputSink&) = delete;
+    OutputSink(OutputSink&&) = delete;
+    auto operator=(const OutputSink&) -> OutputSink& = delete;
+    auto operator=(OutputSink&&) -> OutputSink& = delete;
+    ~OutputSink(); // Flushes what is left, ignoring errors
+
+    void write(std::string_view bytes);
+    void put(char byte);
+    void flush(); // Throws std::runtime_error if the descriptor rejects the bytes
+    // LengthPrefixed only: flush, then send an empty chunk to end the message
+    void end_message();
+
+private:
+    void emit(const char* data, std::size_t size);
+
+    int fd_;
+    OutputFraming framing_;
+    std::vector<char> buffer_;
+    std::size_t used_{0};
+};
+
+/**
+ * Serialize value into sink without building it as one string first
+ *
+ * Output is byte for byte what value.to_json(pretty) returns. Only compact
+ * output is streamed; pretty output is built by jsom as one string and then
+ * written, so its layout stays jsom's.
+ */
+void write_json(OutputSink& sink, const jsom::JsonDocument& value, bool pretty);
+
+} // namespace computo
@@ -0,0 +1,329 @@
+#include "lazy_input.hpp"
+#include "operators/shared.hpp"
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace computo {
+
+namespace {
+
+struct PathChild;
+
+// Reference tokens selected below one value. A whole node is parsed in full,
+// whatever its children.
+struct PathNode {
+    bool whole{false};
+    std::vector<PathChild> children;
+
+    [[nodiscard]] auto find(std::string_view token) const -> const PathNode*;
+    auto child(const std::string& token) -> PathNode&;
+};
+
+struct PathChild {
+    std::string token;
+    PathNode node;
+};
+
+auto PathNode::find(std::string_view token) const -> const PathNode* {
+    for (const auto& entry : children) {
+        if (entry.token == token) {
+            return &entry.node;
+        }
+    }
+    return nullptr;
+}
+
+auto PathNode::child(const std::string& token) -> PathNode& {
+    for (auto& entry : children) {
+        if (entry.token == token) {
+            return entry.node;
+        }
+    }
+    children.push_back({token, {}});
+    return children.back().node;
+}
+
+// Merges pointers into one tree. Tokens that jsom might read differently from
+// a plain key (empty, or with "~" escapes) select their parent whole.
+auto build_paths(const std::vector<std::string>& pointers) -> PathNode {
+    PathNode root;
+    for (const auto& pointer : pointers) {
+        if (pointer.empty()) {
+            root.whole = true;
+        }
+        if (pointer.empty() || pointer[0] != '/') {
+            continue;
+        }
+        auto* node = &root;
+        std::size_t start = 1;
+        while (!node->whole) {
+            auto end = pointer.find('/', start);
+            auto token = pointer.substr(start, end == std::string::npos ? end : end - start);
+            if (token.empty() || token.find('~') != std::string::npos) {
+                node->whole = true;
+                break;
+            }
+            node = &node->child(token);
+            if (end == std::string::npos) {
+                node->whole = true;
+                break;
+            }
+            start = end + 1;
+        }
+    }
+    return root;
+}
+
+auto is_whitespace(char c) -> bool { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+auto is_delimiter(char c) -> bool {
+    return is_whitespace(c) || c == ',' || c == ':' || c == '[' || c == ']' || c == '{' || c == '}'
+           || c == '"';
+}
+
+// Values a script could run as lambdas read the input themselves
+auto may_hold_input_calls(std::string_view value_text) -> bool {
+    return value_text.find("\"$input") != std::string_view::npos
+           || value_text.find("\\u0024") != std::string_view::npos;
+}
+
+// Walks the text once, building only the selected values. Every method
+// returning bool or std::optional fails (false / std::nullopt) on text the
+// scan cannot follow, leaving the full parser to report it.
+class SelectiveParser {
+public:
+    explicit SelectiveParser(std::string_view text) : text_(text) {}
+
+    auto parse(const PathNode& root, bool scan_only) -> std::optional<jsom::JsonDocument> {
+        std::optional<jsom::JsonDocument> value;
+        if (scan_only) {
+            if (skip_value()) {
+                value.emplace(nullptr);
+            }
+        } else {
+            value = select(root);
+        }
+        skip_whitespace();
+        if (pos_ != text_.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    std::string_view text_;
+    std::size_t pos_{0};
+    std::string closers_; // Brackets open in skip_value(), innermost last
+
+    [[nodiscard]] auto peek() const -> char { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+    void skip_whitespace() {
+        while (pos_ < text_.size() && is_whitespace(text_[pos_])) {
+            ++pos_;
+        }
+    }
+
+    // Moves past the string whose opening quote is at pos_
+    auto skip_string() -> bool {
+        ++pos_;
+        while (true) {
+            auto next = text_.find_first_of("\"\\", pos_);
+            if (next == std::string_view::npos) {
+                return false;
+            }
+            if (text_[next] == '"') {
+                pos_ = next + 1;
+                return true;
+            }
+            pos_ = next + 2; // The escaped character cannot end the string
+        }
+    }
+
+    // Moves past one value, matching brackets and strings only
+    // NOLINTNEXTLINE(readability-function-size)
+    auto skip_value() -> bool {
+        closers_.clear();
+        do {
+            skip_whitespace();
+            if (pos_ >= text_.size()) {
+                return false;
+            }
+            char c = text_[pos_];
+            if (c == '"') {
+                if (!skip_string()) {
+                    return false;
+                }
+            } else if (c == '[' || c == '{') {
+                closers_.push_back(c == '[' ? ']' : '}');
+                ++pos_;
+            } else if (c == ']' || c == '}') {
+                if (closers_.empty() || closers_.back() != c) {
+                    return false;
+                }
+                closers_.pop_back();
+                ++pos_;
+            } else if (c == ',' || c == ':') {
+                if (closers_.empty()) {
+                    return false;
+                }
+                ++pos_;
+            } else {
+                auto start = pos_;
+                while (pos_ < text_.size() && !is_delimiter(text_[pos_])) {
+                    ++pos_;
+                }
+                if (pos_ == start) {
+                    return false;
+                }
+            }
+        } while (!closers_.empty());
+        return true;
+    }
+
+    auto parse_whole() -> std::optional<jsom::JsonDocument> {
+        skip_whitespace();
+        auto start = pos_;
+        if (!skip_value()) {
+            return std::nullopt;
+        }
+        auto value_text = text_.substr(start, pos_ - start);
+        if (may_hold_input_calls(value_text)) {
+            return std::nullopt;
+        }
+        try {
+            return jsom::parse_document(value_text);
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+    }
+
+    auto select(const PathNode& node) -> std::optional<jsom::JsonDocument> {
+        skip_whitespace();
+        if (!node.whole && peek() == '{') {
+            return select_object(node);
+        }
+        if (!node.whole && peek() == '[') {
+            return select_array(node);
+        }
+        return parse_whole(); // Selected, or a scalar where the pointers go deeper
+    }
+
+    // NOLINTNEXTLINE(readability-function-size)
+    auto select_object(const PathNode& node) -> std::optional<jsom::JsonDocument> {
+        auto object = jsom::JsonDocument::make_object();
+        ++pos_;
+        skip_whitespace();
+        if (peek() == '}') {
+            ++pos_;
+            return object;
+        }
+        while (true) {
+            skip_whitespace();
+            if (peek() != '"') {
+                return std::nullopt;
+            }
+            auto key_start = pos_;
+            if (!skip_string()) {
+                return std::nullopt;
+            }
+            auto quoted_key = text_.substr(key_start, pos_ - key_start);
+            skip_whitespace();
+            if (peek() != ':') {
+                return std::nullopt;
+            }
+            ++pos_;
+
+            auto key = quoted_key.substr(1, quoted_key.size() - 2);
+            std::string unescaped;
+            if (key.find('\\') != std::string_view::npos) {
+                try {
+                    unescaped = jsom::parse_document(quoted_key).as<std::string>();
+                } catch (const std::exception&) {
+                    return std::nullopt;
+                }
+                key = unescaped;
+            }
+            if (const auto* child = node.find(key)) {
+                std::string name(key);
+                if (object.contains(name)) {
+                    return std::nullopt; // Which one wins is the full parser's call
+                }
+                auto value = select(*child);
+                if (!value) {
+                    return std::nullopt;
+                }
+                object.set(name, std::move(*value));
+            } else if (!skip_value()) {
+                return std::nullopt;
+            }
+
+            skip_whitespace();
+            if (peek() == '}') {
+                ++pos_;
+                return object;
+            }
+            if (peek() != ',') {
+                return std::nullopt;
+            }
+            ++pos_;
+        }
+    }
+
+    // NOLINTNEXTLINE(readability-function-size)
+    auto select_array(const PathNode& node) -> std::optional<jsom::JsonDocument> {
+        std::vector<std::pair<std::size_t, const PathNode*>> selected;
+        for (const auto& entry : node.children) {
+            auto index = parse_array_index(entry.token);
+            if (!index) {
+                return parse_whole(); // Not an index: leave the lookup to jsom
+            }
+            selected.emplace_back(*index, &entry.node);
+        }
+        std::sort(selected.begin(), selected.end());
+        auto next = selected.begin();
+
+        auto array = jsom::JsonDocument::make_array();
+        ++pos_;
+        skip_whitespace();
+        if (peek() == ']') {
+            ++pos_;
+            return array;
+        }
+        for (std::size_t index = 0;; ++index) {
+            if (next != selected.end() && next->first == index) {
+                const auto* child = next->second;
+                ++next;
+                auto value = select(*child);
+                if (!value) {
+                    return std::nullopt;
+                }
+                array.push_back(std::move(*value));
+            } else if (skip_value()) {
+                array.push_back(jsom::JsonDocument(nullptr)); // Keeps later indices in place
+            } else {
+                return std::nullopt;
+            }
+
+            skip_whitespace();
+            if (peek() == ']') {
+                ++pos_;
+                return array;
+            }
+            if (peek() != ',') {
+                return std::nullopt;
+            }
+            ++pos_;
+        }
+    }
+};
+
+} // namespace
+
+auto parse_selected(std::string_view text, const std::vector<std::string>& pointers)
+    -> std::optional<jsom::JsonDocument> {
+    SelectiveParser parser(text);
+    return parser.parse(build_paths(pointers), pointers.empty());
+}
+
+} // namespace computo
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <computo.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace computo {
+
+// --- Selective Input Parsing ---
+
+/**
+ * Parse only the parts of a JSON document that pointers can reach
+ *
+ * The values the pointers name are parsed in full. The objects and arrays on
+ * the way to them keep just the members leading there, except that arrays keep
+ * their length (skipped elements become null) so out-of-range indices fail as
+ * before. Everything else is skipped by a structural scan that only matches
+ * brackets and strings, without building any values. An empty pointer ("")
+ * selects the whole document; with no pointers at all the document is only
+ * scanned, and null is returned in its place.
+ *
+ * @return The document, or std::nullopt if it has to be parsed in full:
+ *         the scan failed (so the full parser reports the error), an object
+ *         repeats a key on a selected path, or a selected value contains
+ *         $input / $inputs calls that a script could run as a lambda
+ */
+auto parse_selected(std::string_view text, const std::vector<std::string>& pointers)
+    -> std::optional<jsom::JsonDocument>;
+
+} // namespace computo
@@ -1,22 +1,31 @@
 #include "cli_args.hpp"
 #include "json_colorizer.hpp"
+#include "json_writer.hpp"
+#include "mapped_file.hpp"
 #include "repl.hpp"
+#include "script_cache.hpp"
+#include "server.hpp"
 #include "sugar_parser.hpp"
 #include "sugar_writer.hpp"
 #include <algorithm>
 #include <computo.hpp>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <istream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace computo {
 
 // Forward declarations for file utilities (implemented in repl.cpp)
 auto load_json_file(const std::string& filename, bool enable_comments) -> jsom::JsonDocument;
-auto load_input_files(const std::vector<std::string>& filenames, bool enable_comments)
-    -> std::vector<jsom::JsonDocument>;
+// With access, only the parts of each input the script reads are parsed
+auto load_input_files(const std::vector<std::string>& filenames, bool enable_comments,
+                      const InputAccess* access) -> std::vector<jsom::JsonDocument>;
 
 // Load a file as raw text
 static auto read_file_text(const std::string& filename) -> std::string {
@@ -27,16 +36,46 @@ static auto read_file_text(const std::string& filename) -> std::string {
     return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 }
 
-// Auto-detect format and load script based on extension or content
+// Sugar scripts usually start with something no JSON text can start with
+// (a keyword, an identifier, $input, a "--" comment), which saves them a
+// failed JSON parse before the sugar one
+static auto may_be_json(std::string_view content, bool enable_comments) -> bool {
+    auto start = content.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) {
+        return true; // Let the JSON parser report the empty file
+    }
+    auto rest = content.substr(start);
+    if (rest.substr(0, 2) == "--") {
+        return false;
+    }
+    char first = rest[0];
+    return first == '[' || first == '{' || first == '"' || first == '-'
+           || (first >= '0' && first <= '9') || rest.substr(0, 4) == "true"
+           || rest.substr(0, 5) == "false" || rest.substr(0, 4) == "null"
+           || (enable_comments && first == '/');
+}
+
+// Auto-detect format and load script based on extension or content: compiled
+// (.computoc, recognized by its header), JSON, or sugar
 static auto load_script_file(const std::string& filename, bool enable_comments,
                              const std::string& array_key) -> jsom::JsonDocument {
-    auto content = read_file_text(filename);
+    MappedFile file(filename);
+    auto content = file.view();
+
+    if (is_script_cache(content)) {
+        auto cached = decode_script_cache(content);
+        if (cached.array_key != array_key) {
+            throw std::runtime_error(filename + " was compiled with --array=" + cached.array_key
+                                     + "; recompile it or pass the same key");
+        }
+        return std::move(cached.script);
+    }
 
     // Check file extension: .computo files are always sugar syntax
     bool force_sugar = filename.size() >= 8
                        && filename.substr(filename.size() - 8) == ".computo";
 
-    if (!force_sugar) {
+    if (!force_sugar && may_be_json(content, enable_comments)) {
         // Try JSON parse first
         try {
             if (enable_comments) {
@@ -51,16 +90,118 @@ static auto load_script_file(const std::string& filename, bool enable_comments,
     // Parse as sugar
     SugarParseOptions opts;
     opts.array_key = array_key;
-    return SugarParser::parse(content, opts);
+    return SugarParser::parse(std::string(content), opts);
 }
 
-// Unwrap array wrapper for output: {"array": [...]} -> [...]
-static auto unwrap_for_output(const jsom::JsonDocument& result,
-                              const std::string& array_key) -> jsom::JsonDocument {
+// Results are written to stdout's descriptor directly, past std::cout
+constexpr int STDOUT_FD = 1;
+
+// Serialize a result straight into out, unwrapping the array wrapper for clean
+// output: {"array": [...]} -> [...]
+static void write_result(OutputSink& out, const jsom::JsonDocument& result,
+                         const std::string& array_key, bool pretty) {
     if (result.is_object() && result.size() == 1 && result.contains(array_key)) {
-        return result[array_key];
+        write_json(out, result[array_key], pretty);
+    } else {
+        write_json(out, result, pretty);
+    }
+    out.put('\n');
+}
+
+// Compilation statistics as a JSON object on stderr, keeping stdout clean
+static void print_stats(const ProgramStats& stats) {
+    auto count = [](std::size_t value) { return jsom::JsonDocument(static_cast<int>(value)); };
+    jsom::JsonDocument report = jsom::JsonDocument::make_object();
+    report.set("nodes", count(stats.nodes));
+    report.set("folded_nodes", count(stats.folded_nodes));
+    report.set("hoisted_nodes", count(stats.hoisted_nodes));
+    report.set("resolved_variables", count(stats.resolved_variables));
+    report.set("bytecode_instructions", count(stats.bytecode_instructions));
+    report.set("bytecode_fallbacks", count(stats.bytecode_fallbacks));
+    std::cerr << "stats: " << report.to_json() << "\n";
+}
+
+// --- NDJSON Mode ---
+
+// Records parsed and run together; memory stays bounded by one batch of
+// records and their results, whatever the size of the stream
+constexpr std::size_t NDJSON_BATCH_RECORDS = 1024;
+
+// Run the program once per line of stream, writing one compact result line per
+// record in input order. Records that fail to parse or run are reported on
+// stderr with their line number and skipped. Returns the number of failures.
+static auto run_ndjson_stream(std::istream& stream, const std::string& name, const Program& program,
+                              const ComputoArgs& args, OutputSink& out) -> std::size_t {
+    BatchOptions options;
+    options.threads = args.threads;
+    std::vector<jsom::JsonDocument> records;
+    std::vector<std::size_t> line_numbers;
+    records.reserve(NDJSON_BATCH_RECORDS);
+    line_numbers.reserve(NDJSON_BATCH_RECORDS);
+    std::size_t failures = 0;
+
+    auto run_batch = [&]() {
+        auto results = program.run_batch(std::move(records), options);
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (results[i].ok()) {
+                write_result(out, results[i].value, args.array_key, false);
+            } else {
+                std::cerr << "Error: " << name << ":" << line_numbers[i] << ": "
+                          << results[i].error_message() << "\n";
+                ++failures;
+            }
+        }
+        out.flush(); // Results reach stdout batch by batch, ahead of later errors
+        records.clear();
+        line_numbers.clear();
+    };
+
+    std::string line;
+    std::size_t line_number = 0;
+    while (std::getline(stream, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue; // Blank lines separate nothing
+        }
+        try {
+            records.push_back(args.enable_comments
+                                  ? jsom::parse_document(line, jsom::ParsePresets::Comments)
+                                  : jsom::parse_document(line));
+            line_numbers.push_back(line_number);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << name << ":" << line_number << ": JSON parse error: "
+                      << e.what() << "\n";
+            ++failures;
+        }
+        if (records.size() == NDJSON_BATCH_RECORDS) {
+            run_batch();
+        }
+    }
+    if (!records.empty()) {
+        run_batch();
     }
-    return result;
+    return failures;
+}
+
+// Stream every input file (or stdin when there are none) through the program
+static auto run_ndjson_mode(const Program& program, const ComputoArgs& args) -> int {
+    // Nothing else reads or writes through C stdio in this mode
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    OutputSink out(STDOUT_FD);
+    std::size_t failures = 0;
+    if (args.input_files.empty()) {
+        failures += run_ndjson_stream(std::cin, "<stdin>", program, args, out);
+    }
+    for (const auto& filename : args.input_files) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+        failures += run_ndjson_stream(file, filename, program, args, out);
+    }
+    return failures == 0 ? 0 : 1;
 }
 
 // --- Script Execution Mode ---
@@ -69,14 +210,39 @@ auto run_script_mode(const ComputoArgs& args) -> int {
     try {
         // Load script with auto-detection
         auto script = load_script_file(args.script_file, args.enable_comments, args.array_key);
+        if (args.compile_to) {
+            std::ofstream out(args.compile_to_file, std::ios::binary);
+            out << encode_script_cache(script, args.array_key);
+            if (!out) {
+                throw std::runtime_error("Could not write file: " + args.compile_to_file);
+            }
+            return 0;
+        }
 
-        // Load inputs and execute
-        auto inputs = load_input_files(args.input_files, args.enable_comments);
-        auto result = computo::execute(script, inputs, nullptr, args.array_key);
+        // Resolve operators once, then load inputs and execute
+        auto backend = args.bytecode ? Backend::Bytecode : Backend::Tree;
+        auto program = computo::compile(script, args.array_key, backend);
+        if (args.ndjson) {
+            auto status = run_ndjson_mode(program, args);
+            if (args.show_stats) {
+                print_stats(program.stats());
+            }
+            return status;
+        }
+        auto access = program.input_access();
+        auto inputs = load_input_files(args.input_files, args.enable_comments,
+                                       args.lazy_input ? &access : nullptr);
+        ParallelOptions parallel;
+        parallel.threads = args.threads;
+        auto result = program.run(std::move(inputs), nullptr, parallel);
 
-        // Output result (unwrap array wrapper for clean output)
-        auto output = unwrap_for_output(result, args.array_key);
-        std::cout << output.to_json(true) << "\n";
+        // Stream the result out rather than building it as one string
+        OutputSink out(STDOUT_FD);
+        write_result(out, result, args.array_key, true);
+        out.flush();
+        if (args.show_stats) {
+            print_stats(program.stats());
+        }
         return 0;
 
     } catch (const std::exception& e) {
@@ -85,6 +251,35 @@ auto run_script_mode(const ComputoArgs& args) -> int {
     }
 }
 
+// --- Server Mode ---
+
+// Compile every script given on the command line, then serve them under their
+// file names without extension
+static auto run_serve_mode(const ComputoArgs& args) -> int {
+    try {
+        auto backend = args.bytecode ? Backend::Bytecode : Backend::Tree;
+        std::vector<ServedScript> scripts;
+        for (const auto& filename : args.input_files) {
+            auto id = std::filesystem::path(filename).stem().string();
+            if (id.empty() || id[0] == '$') {
+                throw std::runtime_error("Cannot serve " + filename
+                                         + ": script ids must not be empty or start with $");
+            }
+            for (const auto& served : scripts) {
+                if (served.id == id) {
+                    throw std::runtime_error("Two scripts share the id " + id + ": " + filename);
+                }
+            }
+            auto script = load_script_file(filename, args.enable_comments, args.array_key);
+            scripts.push_back({id, computo::compile(script, args.array_key, backend)});
+        }
+        return run_server(args.socket_path, scripts, args);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
+
 } // namespace computo
 
 // --- Main Entry Point ---
@@ -160,6 +355,8 @@ auto main(int argc, char* argv[]) -> int {
             return computo::run_script_mode(args);
         case computo::ComputoArgs::Mode::REPL:
             return computo::run_repl_mode(args);
+        case computo::ComputoArgs::Mode::SERVE:
+            return computo::run_serve_mode(args);
         }
 
         return 0;
@@ -0,0 +1,94 @@
+#include "mapped_file.hpp"
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace computo {
+
+namespace {
+
+constexpr std::size_t READ_CHUNK_SIZE = std::size_t{64} * 1024;
+
+// Whole contents of a file that could not be mapped, read in large chunks
+auto read_whole_file(const std::string& filename) -> std::string {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    std::string content;
+    std::array<char, READ_CHUNK_SIZE> chunk{};
+    while (file.read(chunk.data(), chunk.size()) || file.gcount() > 0) {
+        content.append(chunk.data(), static_cast<std::size_t>(file.gcount()));
+    }
+    return content;
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string& filename) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    struct stat info {};
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        auto size = static_cast<std::size_t>(info.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // Parsers read front to back: read ahead aggressively, drop pages behind
+            (void)madvise(mapping, size, MADV_SEQUENTIAL);
+            mapping_ = mapping;
+            size_ = size;
+        }
+    }
+    close(fd);
+    if (mapping_ != nullptr) {
+        return;
+    }
+#endif
+    buffer_ = read_whole_file(filename);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)), size_(std::exchange(other.size_, 0)),
+      buffer_(std::move(other.buffer_)) {}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+    if (this != &other) {
+        release();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() { release(); }
+
+auto MappedFile::view() const -> std::string_view {
+    if (mapping_ != nullptr) {
+        return {static_cast<const char*>(mapping_), size_};
+    }
+    return buffer_;
+}
+
+void MappedFile::release() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (mapping_ != nullptr) {
+        munmap(mapping_, size_);
+    }
+#endif
+    mapping_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace computo
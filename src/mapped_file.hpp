@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace computo {
+
+// --- Memory-Mapped Files ---
+
+/**
+ * Read-only view of a whole file. Regular files are mapped into memory and
+ * read in place, so parsing them needs no copy of their bytes; anything that
+ * cannot be mapped (pipes, empty files, platforms without mmap) is read into
+ * a buffer instead. The view stays valid for the lifetime of the object.
+ */
+class MappedFile {
+public:
+    // Throws std::runtime_error("Could not open file: <filename>")
+    explicit MappedFile(const std::string& filename);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+    ~MappedFile();
+
+    [[nodiscard]] auto view() const -> std::string_view;
+    [[nodiscard]] auto is_mapped() const -> bool { return mapping_ != nullptr; }
+
+private:
+    void release();
+
+    void* mapping_{nullptr};
+    std::size_t size_{0};
+    std::string buffer_; // Contents when the file could not be mapped
+};
+
+} // namespace computo
@@ -0,0 +1,226 @@
+#include "native_stack.hpp"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstddef>
+#include <new>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <system_error>
+#include <ucontext.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+// Sanitizers track which stack a thread is on; every switch to or from a
+// segment is announced to them, or they report the new stack as corrupt
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define COMPUTO_ASAN_FIBERS 1
+#endif
+#if __has_feature(thread_sanitizer)
+#define COMPUTO_TSAN_FIBERS 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) && !defined(COMPUTO_ASAN_FIBERS)
+#define COMPUTO_ASAN_FIBERS 1
+#endif
+#if defined(__SANITIZE_THREAD__) && !defined(COMPUTO_TSAN_FIBERS)
+#define COMPUTO_TSAN_FIBERS 1
+#endif
+
+#if defined(__linux__) && defined(COMPUTO_ASAN_FIBERS)
+#include <sanitizer/common_interface_defs.h>
+#endif
+#if defined(__linux__) && defined(COMPUTO_TSAN_FIBERS)
+#include <sanitizer/tsan_interface.h>
+#endif
+
+namespace computo::native_stack {
+
+#if defined(__linux__)
+
+namespace {
+
+// Evaluation switches stacks once fewer than RED_ZONE bytes remain, which
+// leaves room for the deepest single operator call (plus signal handlers).
+constexpr std::size_t RED_ZONE = std::size_t{256} * 1024;
+constexpr std::size_t SEGMENT_SIZE = std::size_t{16} * 1024 * 1024;
+constexpr std::size_t CACHED_SEGMENTS = 2;
+
+struct Segment {
+    char* base{nullptr}; // Lowest address, starting with a guard page
+};
+
+// Released segments are kept for reuse, so recursion hovering around a
+// segment boundary does not map and unmap a segment for every call
+struct SegmentCache {
+    std::vector<Segment> free;
+
+    SegmentCache() = default;
+    SegmentCache(const SegmentCache&) = delete;
+    SegmentCache(SegmentCache&&) = delete;
+    auto operator=(const SegmentCache&) -> SegmentCache& = delete;
+    auto operator=(SegmentCache&&) -> SegmentCache& = delete;
+    ~SegmentCache() {
+        for (const auto& segment : free) {
+            munmap(segment.base, SEGMENT_SIZE);
+        }
+    }
+};
+
+thread_local const char* stack_limit = nullptr; // Switch stacks below this address
+thread_local bool stack_limit_known = false;
+thread_local SegmentCache segment_cache;
+
+// One switch onto a segment and back. It lives on the caller's stack, so
+// segments started from inside a segment each keep their own.
+struct Switch {
+    void (*function)(void*){nullptr};
+    void* argument{nullptr};
+    const void* caller_bottom{nullptr}; // Caller's stack, for the sanitizers
+    std::size_t caller_size{0};
+    void* caller_fiber{nullptr};
+};
+
+// Hand-off to segment_entry(); makecontext() cannot portably pass pointers
+thread_local Switch* pending_switch = nullptr;
+
+auto page_size() -> std::size_t {
+    static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+void initialize_stack_limit() {
+    stack_limit_known = true;
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+        return; // Unknown bounds: never switch stacks
+    }
+    void* low = nullptr;
+    std::size_t size = 0;
+    if (pthread_attr_getstack(&attributes, &low, &size) == 0 && size > RED_ZONE) {
+        stack_limit = static_cast<const char*>(low) + RED_ZONE;
+    }
+    pthread_attr_destroy(&attributes);
+}
+
+auto acquire_segment() -> Segment {
+    if (!segment_cache.free.empty()) {
+        auto segment = segment_cache.free.back();
+        segment_cache.free.pop_back();
+        return segment;
+    }
+    void* memory = mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    // Overflowing a segment faults instead of writing into whatever is below;
+    // a segment without its guard page is never used
+    if (mprotect(memory, page_size(), PROT_NONE) != 0) {
+        auto error = errno;
+        munmap(memory, SEGMENT_SIZE);
+        throw std::system_error(error, std::generic_category(),
+                                "Could not protect the guard page of a stack segment");
+    }
+    return {static_cast<char*>(memory)};
+}
+
+void release_segment(const Segment& segment) {
+    if (segment_cache.free.size() < CACHED_SEGMENTS) {
+        segment_cache.free.push_back(segment);
+    } else {
+        munmap(segment.base, SEGMENT_SIZE);
+    }
+}
+
+// --- Sanitizer Annotations ---
+
+// Called just before leaving the current stack for [bottom, bottom + size).
+// fake_stack is null when the current stack will not be resumed.
+void before_switch([[maybe_unused]] void** fake_stack, [[maybe_unused]] const void* bottom,
+                   [[maybe_unused]] std::size_t size, [[maybe_unused]] void* fiber) {
+#if defined(COMPUTO_ASAN_FIBERS)
+    __sanitizer_start_switch_fiber(fake_stack, bottom, size);
+#endif
+#if defined(COMPUTO_TSAN_FIBERS)
+    __tsan_switch_to_fiber(fiber, 0);
+#endif
+}
+
+// Called first thing on the stack just switched to; records the stack that
+// was left when from is not null
+void after_switch([[maybe_unused]] void* fake_stack, [[maybe_unused]] Switch* from) {
+#if defined(COMPUTO_ASAN_FIBERS)
+    __sanitizer_finish_switch_fiber(fake_stack, from != nullptr ? &from->caller_bottom : nullptr,
+                                    from != nullptr ? &from->caller_size : nullptr);
+#endif
+}
+
+void segment_entry() {
+    auto* current = pending_switch;
+    after_switch(nullptr, current);
+    current->function(current->argument);
+    // Returning resumes the caller through uc_link; this segment is finished
+    before_switch(nullptr, current->caller_bottom, current->caller_size, current->caller_fiber);
+}
+
+} // namespace
+
+auto headroom_low() -> bool {
+    if (!stack_limit_known) {
+        initialize_stack_limit();
+    }
+    char marker = 0;
+    return &marker < stack_limit;
+}
+
+void run_on_new_segment(void (*function)(void*), void* argument) {
+    auto segment = acquire_segment();
+    const char* saved_limit = stack_limit;
+
+    ucontext_t caller;
+    ucontext_t callee;
+    if (getcontext(&callee) != 0) {
+        release_segment(segment);
+        function(argument); // Cannot switch: carry on where we are
+        return;
+    }
+    callee.uc_stack.ss_sp = segment.base;
+    callee.uc_stack.ss_size = SEGMENT_SIZE;
+    callee.uc_link = &caller; // Resume here once function returns
+    Switch current;
+    current.function = function;
+    current.argument = argument;
+    pending_switch = &current;
+    makecontext(&callee, segment_entry, 0);
+
+    void* fiber = nullptr;
+#if defined(COMPUTO_TSAN_FIBERS)
+    current.caller_fiber = __tsan_get_current_fiber();
+    fiber = __tsan_create_fiber(0);
+#endif
+    void* fake_stack = nullptr;
+    stack_limit = segment.base + page_size() + RED_ZONE;
+    before_switch(&fake_stack, segment.base, SEGMENT_SIZE, fiber);
+    swapcontext(&caller, &callee);
+    after_switch(fake_stack, nullptr);
+#if defined(COMPUTO_TSAN_FIBERS)
+    __tsan_destroy_fiber(fiber);
+#endif
+    stack_limit = saved_limit;
+    release_segment(segment);
+}
+
+#else
+
+// Without a way to switch stacks, recursion stays on the thread's own stack
+
+auto headroom_low() -> bool { return false; }
+
+void run_on_new_segment(void (*function)(void*), void* argument) { function(argument); }
+
+#endif
+
+} // namespace computo::native_stack
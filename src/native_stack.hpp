@@ -0,0 +1,60 @@
+#pragma once
+
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace computo::native_stack {
+
+// --- Native Stack Segments ---
+
+/**
+ * True when the calling thread is close to the end of the stack it is
+ * running on (its own stack or a segment from run_on_new_segment())
+ */
+auto headroom_low() -> bool;
+
+/**
+ * Run function(argument) on a freshly allocated stack segment and return once
+ * it has finished. Exceptions must not escape function.
+ *
+ * @throws std::bad_alloc if no segment can be mapped, std::system_error if
+ *         its guard page cannot be protected (function is not called)
+ */
+void run_on_new_segment(void (*function)(void*), void* argument);
+
+/**
+ * Call func, first moving to a new stack segment if the current stack is
+ * nearly exhausted. Recursion that passes through here is limited by memory
+ * rather than by the size of the thread's stack. Exceptions propagate to the
+ * caller as usual.
+ */
+template <typename Func> auto with_headroom(Func&& func) -> decltype(func()) {
+    if (!headroom_low()) {
+        return func();
+    }
+
+    struct Call {
+        Func& func;
+        std::optional<decltype(func())> result;
+        std::exception_ptr error;
+    } call{func, std::nullopt, nullptr};
+
+    run_on_new_segment(
+        [](void* argument) {
+            auto& pending = *static_cast<Call*>(argument);
+            try {
+                pending.result.emplace(pending.func());
+            } catch (...) {
+                pending.error = std::current_exception();
+            }
+        },
+        &call);
+
+    if (call.error) {
+        std::rethrow_exception(call.error);
+    }
+    return std::move(*call.result);
+}
+
+} // namespace computo::native_stack
@@ -3,14 +3,15 @@
 
 namespace computo::operators {
 
-auto addition(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto addition(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'+' requires at least 1 argument", ctx.get_path_string());
     }
 
     double result = 0.0;
-    for (const auto& arg_expr : args) {
-        auto arg = evaluate(arg_expr, ctx);
+    ForkJoinArguments values(args, ctx);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto arg = values.value(i);
         if (!arg.is_number()) {
             throw InvalidArgumentException("'+' requires numeric arguments", ctx.get_path_string());
         }
@@ -19,12 +20,13 @@ auto addition(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evaluati
     return EvaluationResult(result);
 }
 
-auto subtraction(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto subtraction(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'-' requires at least 1 argument", ctx.get_path_string());
     }
 
-    auto first_arg = evaluate(args[0], ctx);
+    ForkJoinArguments values(args, ctx);
+    auto first_arg = values.value(0);
     if (!first_arg.is_number()) {
         throw InvalidArgumentException("'-' requires numeric arguments", ctx.get_path_string());
     }
@@ -35,7 +37,7 @@ auto subtraction(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evalu
 
     double result = first_arg.as<double>();
     for (size_t i = 1; i < args.size(); ++i) {
-        auto arg = evaluate(args[i], ctx);
+        auto arg = values.value(i);
         if (!arg.is_number()) {
             throw InvalidArgumentException("'-' requires numeric arguments", ctx.get_path_string());
         }
@@ -44,14 +46,15 @@ auto subtraction(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evalu
     return EvaluationResult(result);
 }
 
-auto multiplication(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto multiplication(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'*' requires at least 1 argument", ctx.get_path_string());
     }
 
     double result = 1.0;
-    for (const auto& arg_expr : args) {
-        auto arg = evaluate(arg_expr, ctx);
+    ForkJoinArguments values(args, ctx);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto arg = values.value(i);
         if (!arg.is_number()) {
             throw InvalidArgumentException("'*' requires numeric arguments", ctx.get_path_string());
         }
@@ -61,12 +64,13 @@ auto multiplication(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Ev
 }
 
 // NOLINTBEGIN(readability-function-size)
-auto division(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto division(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'/' requires at least 1 argument", ctx.get_path_string());
     }
 
-    auto first_arg = evaluate(args[0], ctx);
+    ForkJoinArguments values(args, ctx);
+    auto first_arg = values.value(0);
     if (!first_arg.is_number()) {
         throw InvalidArgumentException("'/' requires numeric arguments", ctx.get_path_string());
     }
@@ -81,7 +85,7 @@ auto division(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evaluati
 
     double result = first_arg.as<double>();
     for (size_t i = 1; i < args.size(); ++i) {
-        auto arg = evaluate(args[i], ctx);
+        auto arg = values.value(i);
         if (!arg.is_number()) {
             throw InvalidArgumentException("'/' requires numeric arguments", ctx.get_path_string());
         }
@@ -95,19 +99,20 @@ auto division(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evaluati
 }
 // NOLINTEND(readability-function-size)
 
-auto modulo(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto modulo(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() < 2) {
         throw InvalidArgumentException("'%' requires at least 2 arguments", ctx.get_path_string());
     }
 
-    auto first_arg = evaluate(args[0], ctx);
+    ForkJoinArguments values(args, ctx);
+    auto first_arg = values.value(0);
     if (!first_arg.is_number()) {
         throw InvalidArgumentException("'%' requires numeric arguments", ctx.get_path_string());
     }
 
     double result = first_arg.as<double>();
     for (size_t i = 1; i < args.size(); ++i) {
-        auto arg = evaluate(args[i], ctx);
+        auto arg = values.value(i);
         if (!arg.is_number()) {
             throw InvalidArgumentException("'%' requires numeric arguments", ctx.get_path_string());
         }
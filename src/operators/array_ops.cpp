@@ -1,8 +1,162 @@
+#include "operators/array_pipeline.hpp"
 #include "operators/shared.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread_pool.hpp>
+#include <vector>
 
 namespace computo::operators {
 
-auto map_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+namespace {
+
+// Reducer lambdas whose fold gives the same value however it is grouped, so
+// chunks of the array can be folded separately and their results combined
+enum class Reducer : std::uint8_t {
+    None,
+    Sum,      // ["+", a, x]
+    Product,  // ["*", a, x]
+    Extremum, // ["if", ["<", a, x], a, x] and the other min / max spellings
+    Merge     // ["merge", a, x]
+};
+
+// Doubles hold every integer up to 2^53 exactly
+constexpr double EXACT_INTEGER_LIMIT = 9007199254740992.0;
+
+// ["$", "/name"] for a parameter name
+auto is_parameter(const jsom::JsonDocument& expr, const std::string& name) -> bool {
+    return expr.is_array() && expr.size() == 2 && expr[0].is_string()
+           && expr[0].as<std::string>() == "$" && expr[1].is_string()
+           && expr[1].as<std::string>() == "/" + name;
+}
+
+// The two expressions are the two parameters, in either order
+auto are_parameters(const jsom::JsonDocument& lhs, const jsom::JsonDocument& rhs,
+                    const std::string& first, const std::string& second) -> bool {
+    return (is_parameter(lhs, first) && is_parameter(rhs, second))
+           || (is_parameter(lhs, second) && is_parameter(rhs, first));
+}
+
+// NOLINTBEGIN(readability-function-size)
+auto classify_reducer(const LambdaDefinition& lambda) -> Reducer {
+    const auto& params = *lambda.params;
+    const auto& body = *lambda.body;
+    if (!params.is_array() || params.size() != 2 || !params[0].is_string() || !params[1].is_string()
+        || !body.is_array() || body.empty() || !body[0].is_string()) {
+        return Reducer::None;
+    }
+    auto first = params[0].as<std::string>();
+    auto second = params[1].as<std::string>();
+    if (first == second || first.find_first_of("/~") != std::string::npos
+        || second.find_first_of("/~") != std::string::npos) {
+        return Reducer::None;
+    }
+
+    auto name = body[0].as<std::string>();
+    if (body.size() == 3 && are_parameters(body[1], body[2], first, second)) {
+        if (name == "+") {
+            return Reducer::Sum;
+        }
+        if (name == "*") {
+            return Reducer::Product;
+        }
+        if (name == "merge") {
+            return Reducer::Merge;
+        }
+    }
+    // Picking one operand by comparing the two is a min or max, ties going to
+    // the same side every time
+    if (name == "if" && body.size() == 4 && body[1].is_array() && body[1].size() == 3
+        && body[1][0].is_string()) {
+        auto comparison = body[1][0].as<std::string>();
+        if ((comparison == "<" || comparison == ">" || comparison == "<=" || comparison == ">=")
+            && are_parameters(body[1][1], body[1][2], first, second)
+            && are_parameters(body[2], body[3], first, second)) {
+            return Reducer::Extremum;
+        }
+    }
+    return Reducer::None;
+}
+// NOLINTEND(readability-function-size)
+
+// Whether the values are ones the reducer combines without errors and, for
+// arithmetic, without rounding, so every grouping matches the sequential fold
+auto groups_exactly(Reducer reducer, const jsom::JsonDocument& initial,
+                    const jsom::JsonDocument& items) -> bool {
+    if (reducer == Reducer::Merge) {
+        return initial.is_object()
+               && std::all_of(items.begin(), items.end(),
+                              [](const jsom::JsonDocument& item) { return item.is_object(); });
+    }
+    double bound = reducer == Reducer::Product ? 1.0 : 0.0; // Of every partial result
+    auto exact = [&](const jsom::JsonDocument& value) {
+        if (!value.is_number()) {
+            return false;
+        }
+        if (reducer == Reducer::Extremum) {
+            return true;
+        }
+        auto number = value.as<double>();
+        if (number != std::floor(number)) {
+            return false;
+        }
+        if (reducer == Reducer::Sum) {
+            bound += std::fabs(number);
+        } else if (number != 0.0) {
+            bound *= std::fabs(number);
+        }
+        return bound <= EXACT_INTEGER_LIMIT;
+    };
+    return exact(initial) && std::all_of(items.begin(), items.end(), exact);
+}
+
+// Folds chunks of items on the thread pool, the first starting from initial
+// and the others from their first element, then combines neighbouring results
+// pairwise, level by level
+// NOLINTBEGIN(readability-function-size)
+auto tree_reduce(const LambdaDefinition& lambda, const SharedJson& initial,
+                 const SharedJson& array_input, const jsom::JsonDocument& items,
+                 const ParallelOptions& parallel, const ExecutionContext& ctx) -> jsom::JsonDocument {
+    auto count = items.size();
+    auto chunk_size = parallel.chunk_size > 0
+                          ? parallel.chunk_size
+                          : std::max<std::size_t>(count / (parallel.threads * 8), 1);
+    std::vector<SharedJson> partials((count + chunk_size - 1) / chunk_size);
+    auto chunk_ctx = ctx.as_concurrent();
+
+    thread_pool::parallel_for(count, chunk_size, parallel.threads,
+                              [&](std::size_t begin, std::size_t end) {
+                                  auto accumulator =
+                                      begin == 0 ? initial : array_input.share(items[begin]);
+                                  for (auto i = begin == 0 ? begin : begin + 1; i < end; ++i) {
+                                      accumulator = SharedJson(invoke_lambda(
+                                          lambda, {std::move(accumulator), array_input.share(items[i])},
+                                          chunk_ctx));
+                                  }
+                                  partials[begin / chunk_size] = std::move(accumulator);
+                              });
+
+    while (partials.size() > 1) {
+        std::vector<SharedJson> combined((partials.size() + 1) / 2);
+        thread_pool::parallel_for(partials.size() / 2, 1, parallel.threads,
+                                  [&](std::size_t begin, std::size_t end) {
+                                      for (auto i = begin; i < end; ++i) {
+                                          combined[i] = SharedJson(invoke_lambda(
+                                              lambda, {partials[2 * i], partials[2 * i + 1]}, chunk_ctx));
+                                      }
+                                  });
+        if (partials.size() % 2 == 1) {
+            combined.back() = std::move(partials.back());
+        }
+        partials = std::move(combined);
+    }
+    return std::move(partials.front()).take();
+}
+// NOLINTEND(readability-function-size)
+
+} // namespace
+
+auto map_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
 
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     auto processor = [](const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result,
@@ -14,7 +168,7 @@ auto map_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
         return true; // Continue processing all items
     };
 
-    auto result = process_array_with_lambda(args, ctx, "map", processor);
+    auto result = process_array_with_lambda(args, ctx, "map", processor, true);
     // Handle empty arrays
     if (result.is_null()) {
         result = jsom::JsonDocument::make_array();
@@ -22,7 +176,7 @@ auto map_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto filter_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto filter_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     auto processor = [](const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result,
                         jsom::JsonDocument& final_result) -> bool {
@@ -35,7 +189,7 @@ auto filter_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> E
         return true; // Continue processing all items
     };
 
-    auto result = process_array_with_lambda(args, ctx, "filter", processor);
+    auto result = process_array_with_lambda(args, ctx, "filter", processor, true);
     // Handle empty arrays
     if (result.is_null()) {
         result = jsom::JsonDocument::make_array();
@@ -44,54 +198,87 @@ auto filter_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> E
 }
 
 // NOLINTBEGIN(readability-function-size)
-auto reduce_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto reduce_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 3) {
         throw InvalidArgumentException(
             "'reduce' requires exactly 3 arguments (array, lambda, initial)",
             ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto initial_value = evaluate(args[2], ctx);
-    auto array_data
-        = extract_array_data(array_input, "reduce", ctx.get_path_string(), ctx.array_key);
+    jsom::JsonDocument lambda_storage;
 
-    // Evaluate the lambda expression first (handles ["lambda", ...] syntax)
-    auto lambda_expr = evaluate(args[1], ctx.with_path("lambda"));
+    // A map / filter chain as the array argument streams its elements here
+    if (auto pipeline = ArrayPipeline::match(args[0], ctx)) {
+        SharedJson accumulator;
+        LambdaDefinition lambda;
+        pipeline->run(
+            ctx,
+            [&]() {
+                accumulator = evaluate_shared(args[2], ctx);
+                lambda = resolve_lambda(args[1], ctx.with_path("lambda"), lambda_storage);
+            },
+            [&](const SharedJson& item) {
+                accumulator = SharedJson(invoke_lambda(lambda, {accumulator, item}, ctx));
+                return true;
+            });
+        return EvaluationResult(std::move(accumulator).take());
+    }
 
-    jsom::JsonDocument accumulator = initial_value;
+    auto array_input = evaluate_shared(args[0], ctx);
+    auto accumulator = evaluate_shared(args[2], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "reduce", ctx);
 
-    for (const auto& item : array_data) {
-        std::vector<jsom::JsonDocument> lambda_args = {accumulator, item};
-        auto lambda_result = evaluate_lambda(lambda_expr, lambda_args, ctx);
+    // Resolve the lambda once (["lambda", ...] is referenced, not copied)
+    auto lambda = resolve_lambda(args[1], ctx.with_path("lambda"), lambda_storage);
 
-        // Resolve any tail calls from lambda evaluation
-        while (lambda_result.is_tail_call) {
-            lambda_result = evaluate_internal(lambda_result.tail_call->expression,
-                                              lambda_result.tail_call->context);
+    const auto* parallel = ctx.parallel();
+    if (parallel != nullptr && parallel->threads > 1
+        && array_data.size() >= std::max<std::size_t>(parallel->min_elements, 2)) {
+        auto reducer = classify_reducer(lambda);
+        if (reducer != Reducer::None && groups_exactly(reducer, *accumulator, array_data)) {
+            try {
+                return EvaluationResult(
+                    tree_reduce(lambda, accumulator, array_input, array_data, *parallel, ctx));
+            } catch (const ComputoException&) {
+                // Errors are reported as the sequential fold below meets them
+            }
         }
+    }
 
-        accumulator = lambda_result.value;
+    // The accumulator and elements are passed by handle, never copied
+    for (const auto& item : array_data) {
+        accumulator =
+            SharedJson(invoke_lambda(lambda, {std::move(accumulator), array_input.share(item)}, ctx));
     }
 
-    return EvaluationResult(accumulator);
+    return EvaluationResult(std::move(accumulator).take());
 }
 // NOLINTEND(readability-function-size)
 
-auto count_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto count_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'count' requires exactly 1 argument",
                                        ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data
-        = extract_array_data(array_input, "count", ctx.get_path_string(), ctx.array_key);
+    if (auto pipeline = ArrayPipeline::match(args[0], ctx)) {
+        int count = 0;
+        pipeline->run(
+            ctx, []() {},
+            [&](const SharedJson& /*item*/) {
+                ++count;
+                return true;
+            });
+        return EvaluationResult(count);
+    }
+
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "count", ctx);
 
     return EvaluationResult(static_cast<int>(array_data.size()));
 }
 
-auto find_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto find_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     auto processor = [](const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result,
                         jsom::JsonDocument& final_result) -> bool {
@@ -110,7 +297,7 @@ auto find_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
     return EvaluationResult(result);
 }
 
-auto some_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto some_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     auto processor = [](const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result,
                         jsom::JsonDocument& final_result) -> bool {
@@ -129,7 +316,7 @@ auto some_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
     return EvaluationResult(result);
 }
 
-auto every_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto every_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     auto processor = [](const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result,
                         jsom::JsonDocument& final_result) -> bool {
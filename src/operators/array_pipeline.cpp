@@ -0,0 +1,140 @@
+#include "array_pipeline.hpp"
+#include "shared.hpp"
+#include <algorithm>
+#include <exception>
+#include <program.hpp>
+
+namespace computo {
+
+namespace {
+
+// ["map", array, lambda] or ["filter", array, lambda]; anything else (including
+// a call with the wrong number of arguments) is evaluated as usual
+auto is_stage_call(const jsom::JsonDocument& expr) -> bool {
+    if (!expr.is_array() || expr.size() != 3 || !expr[0].is_string()) {
+        return false;
+    }
+    const auto& name = expr[0].as<std::string>();
+    return name == "map" || name == "filter";
+}
+
+// A call a compiled program caches per enclosing loop call is cheaper to
+// reuse than to re-run element by element
+auto is_hoisted(const jsom::JsonDocument& expr, const ExecutionContext& ctx) -> bool {
+    if (ctx.program() == nullptr) {
+        return false;
+    }
+    const auto* node = ctx.program()->find_node(expr);
+    return node != nullptr && node->hoisted_in != nullptr;
+}
+
+// One map or filter call while the pipeline runs
+struct Stage {
+    bool filter{false};
+    jsom::JsonDocument lambda_storage;
+    LambdaDefinition lambda;
+    std::optional<HoistedValues> hoisted; // As evaluate_compiled() sets up for the call
+    std::optional<ExecutionContext> ctx;
+};
+
+} // namespace
+
+auto ArrayPipeline::match(const jsom::JsonDocument& array_arg, const ExecutionContext& ctx)
+    -> std::optional<ArrayPipeline> {
+    ArrayPipeline pipeline;
+    const auto* expr = &array_arg;
+    while (is_stage_call(*expr) && !is_hoisted(*expr, ctx)) {
+        pipeline.stages_.push_back(expr);
+        expr = &(*expr)[1];
+    }
+    if (pipeline.stages_.empty()) {
+        return std::nullopt;
+    }
+    pipeline.source_ = expr;
+    std::reverse(pipeline.stages_.begin(), pipeline.stages_.end());
+    return pipeline;
+}
+
+// Steps are the stages in order, then the consumer. Call by call, every step
+// finishes (setup, then each element) before the next begins, so the first
+// error that order meets is in the lowest failing step. Once a step fails, the
+// steps before it keep running on the remaining elements in case one of them
+// fails too; later steps stop.
+// NOLINTBEGIN(readability-function-size)
+void ArrayPipeline::run(const ExecutionContext& ctx, const std::function<void()>& setup,
+                        const std::function<bool(const SharedJson&)>& consume) const {
+    // Every stage runs in the consumer's context: evaluating an argument adds
+    // no path segment, so messages come out exactly as call by call
+    auto source = evaluate_shared(*source_, ctx);
+    const auto& items = borrow_array_data(source.get(), (*stages_.front())[0].as<std::string>(), ctx);
+
+    const auto consumer_step = stages_.size();
+    auto limit = consumer_step + 1; // Steps still running
+    std::exception_ptr error;
+    auto fail = [&](std::size_t step) {
+        error = std::current_exception();
+        limit = step;
+    };
+
+    std::vector<Stage> stages(stages_.size());
+    for (std::size_t step = 0; step < limit; ++step) {
+        try {
+            if (step == consumer_step) {
+                setup();
+                break;
+            }
+            const auto& call = *stages_[step];
+            auto& stage = stages[step];
+            stage.filter = call[0].as<std::string>() == "filter";
+            stage.ctx.emplace(ctx);
+            const auto* node = ctx.program() != nullptr ? ctx.program()->find_node(call) : nullptr;
+            if (node != nullptr && node->hoisted_count > 0) {
+                stage.hoisted.emplace();
+                stage.hoisted->loop = node;
+                stage.hoisted->parent = ctx.hoisted();
+                stage.hoisted->slots = std::make_unique<HoistedSlot[]>(node->hoisted_count);
+                stage.ctx.emplace(ctx.with_hoisted(&*stage.hoisted));
+            }
+            stage.lambda = resolve_lambda(call[2], ctx.with_path("lambda"), stage.lambda_storage);
+        } catch (const ComputoException&) {
+            fail(step);
+        }
+    }
+
+    for (const auto& item : items) {
+        if (limit == 0) {
+            break;
+        }
+        auto current = source.share(item);
+        bool survived = true;
+        for (std::size_t step = 0; step < limit && step < consumer_step && survived; ++step) {
+            auto& stage = stages[step];
+            try {
+                auto result = invoke_lambda(stage.lambda, {current}, *stage.ctx);
+                if (stage.filter) {
+                    survived = is_truthy(result);
+                } else {
+                    current = SharedJson(std::move(result));
+                }
+            } catch (const ComputoException&) {
+                fail(step);
+            }
+        }
+        if (survived && consumer_step < limit) {
+            try {
+                if (!consume(current)) {
+                    limit = consumer_step; // Done, but the stages still run to the end
+                }
+            } catch (const ComputoException&) {
+                fail(consumer_step);
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+// NOLINTEND(readability-function-size)
+
+} // namespace computo
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <computo.hpp>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace computo {
+
+// --- Array Operator Fusion ---
+
+/**
+ * A chain of map and filter calls feeding an array operator
+ *
+ * Evaluated call by call, ["reduce", ["filter", ["map", xs, f], p], g, 0]
+ * builds the mapped array, then the filtered one, before reduce sees a single
+ * element. A pipeline instead takes each element of xs through f and p in
+ * turn and hands the survivors straight to the consuming operator, so no
+ * intermediate array exists.
+ *
+ * Only the order of evaluation changes (element by element instead of call by
+ * call), and operators have no side effects, so only errors could tell the
+ * difference. run() therefore keeps evaluating whatever the call-by-call
+ * order would have evaluated before a failing step, and throws the error that
+ * order reaches first, with the same message and execution path.
+ */
+class ArrayPipeline {
+public:
+    /**
+     * Match the array argument of a consuming operator
+     *
+     * @param array_arg The unevaluated array argument
+     * @param ctx The consuming operator's context
+     * @return A pipeline if array_arg is a well-formed map or filter call
+     */
+    static auto match(const jsom::JsonDocument& array_arg, const ExecutionContext& ctx)
+        -> std::optional<ArrayPipeline>;
+
+    /**
+     * Stream the surviving elements to a consumer
+     *
+     * @param ctx The consuming operator's context
+     * @param setup The consumer's work before its first element (resolving its
+     *              lambda, evaluating reduce's initial value)
+     * @param consume Called per surviving element; returns false to stop early
+     */
+    void run(const ExecutionContext& ctx, const std::function<void()>& setup,
+             const std::function<bool(const SharedJson&)>& consume) const;
+
+private:
+    const jsom::JsonDocument* source_{nullptr};    // Array argument of the innermost call
+    std::vector<const jsom::JsonDocument*> stages_; // map / filter calls, innermost first
+};
+
+} // namespace computo
@@ -2,103 +2,80 @@
 
 namespace computo::operators {
 
-auto greater_than(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+namespace {
+
+// Chained numeric comparison: compare must hold for every adjacent pair.
+// Arguments are taken in order up to the first pair that fails. Expensive ones
+// may have been forked ahead of that pair (see ForkJoinArguments); only their
+// cost is wasted, and their errors are not reported.
+template <typename Compare>
+auto compare_chain(const OperatorArgs& args, ExecutionContext& ctx, const std::string& op_name,
+                   Compare compare) -> EvaluationResult {
     if (args.size() < 2) {
-        throw InvalidArgumentException("'>' requires at least 2 arguments", ctx.get_path_string());
+        throw InvalidArgumentException("'" + op_name + "' requires at least 2 arguments",
+                                       ctx.get_path_string());
     }
 
-    for (size_t i = 0; i < args.size() - 1; ++i) {
-        auto lhs = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
-        auto rhs = evaluate(args[i + 1], ctx.with_path("arg" + std::to_string(i + 1)));
+    ForkJoinArguments values(args, ctx, "arg");
+    auto lhs = values.value(0);
+    for (size_t i = 1; i < args.size(); ++i) {
+        auto rhs = values.value(i);
         if (!lhs.is_number() || !rhs.is_number()) {
-            throw InvalidArgumentException("'>' requires numeric arguments", ctx.get_path_string());
+            throw InvalidArgumentException("'" + op_name + "' requires numeric arguments",
+                                           ctx.get_path_string());
         }
-        if (!(lhs.as<double>() > rhs.as<double>())) {
+        if (!compare(lhs.as<double>(), rhs.as<double>())) {
             return EvaluationResult(false);
         }
+        lhs = std::move(rhs);
     }
     return EvaluationResult(true);
 }
 
-auto less_than(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
-    if (args.size() < 2) {
-        throw InvalidArgumentException("'<' requires at least 2 arguments", ctx.get_path_string());
-    }
+} // namespace
 
-    for (size_t i = 0; i < args.size() - 1; ++i) {
-        auto lhs = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
-        auto rhs = evaluate(args[i + 1], ctx.with_path("arg" + std::to_string(i + 1)));
-        if (!lhs.is_number() || !rhs.is_number()) {
-            throw InvalidArgumentException("'<' requires numeric arguments", ctx.get_path_string());
-        }
-        if (!(lhs.as<double>() < rhs.as<double>())) {
-            return EvaluationResult(false);
-        }
-    }
-    return EvaluationResult(true);
+auto greater_than(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
+    return compare_chain(args, ctx, ">", [](double lhs, double rhs) { return lhs > rhs; });
 }
 
-auto greater_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
-    if (args.size() < 2) {
-        throw InvalidArgumentException("'>=' requires at least 2 arguments", ctx.get_path_string());
-    }
-
-    for (size_t i = 0; i < args.size() - 1; ++i) {
-        auto lhs = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
-        auto rhs = evaluate(args[i + 1], ctx.with_path("arg" + std::to_string(i + 1)));
-        if (!lhs.is_number() || !rhs.is_number()) {
-            throw InvalidArgumentException("'>=' requires numeric arguments",
-                                           ctx.get_path_string());
-        }
-        if (!(lhs.as<double>() >= rhs.as<double>())) {
-            return EvaluationResult(false);
-        }
-    }
-    return EvaluationResult(true);
+auto less_than(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
+    return compare_chain(args, ctx, "<", [](double lhs, double rhs) { return lhs < rhs; });
 }
 
-auto less_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
-    if (args.size() < 2) {
-        throw InvalidArgumentException("'<=' requires at least 2 arguments", ctx.get_path_string());
-    }
+auto greater_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
+    return compare_chain(args, ctx, ">=", [](double lhs, double rhs) { return lhs >= rhs; });
+}
 
-    for (size_t i = 0; i < args.size() - 1; ++i) {
-        auto lhs = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
-        auto rhs = evaluate(args[i + 1], ctx.with_path("arg" + std::to_string(i + 1)));
-        if (!lhs.is_number() || !rhs.is_number()) {
-            throw InvalidArgumentException("'<=' requires numeric arguments",
-                                           ctx.get_path_string());
-        }
-        if (!(lhs.as<double>() <= rhs.as<double>())) {
-            return EvaluationResult(false);
-        }
-    }
-    return EvaluationResult(true);
+auto less_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
+    return compare_chain(args, ctx, "<=", [](double lhs, double rhs) { return lhs <= rhs; });
 }
 
-auto equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() < 2) {
         throw InvalidArgumentException("'==' requires at least 2 arguments", ctx.get_path_string());
     }
 
-    auto first = evaluate(args[0], ctx.with_path("arg0"));
+    // Operands are compared where they live (large input subtrees are not copied)
+    ForkJoinArguments values(args, ctx, "arg");
+    auto first = values.shared(0);
     for (size_t i = 1; i < args.size(); ++i) {
-        auto current = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
-        if (first != current) {
+        auto current = values.shared(i);
+        if (*first != *current) {
             return EvaluationResult(false);
         }
     }
     return EvaluationResult(true);
 }
 
-auto not_equal(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto not_equal(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'!=' requires exactly 2 arguments", ctx.get_path_string());
     }
 
-    auto lhs = evaluate(args[0], ctx.with_path("arg0"));
-    auto rhs = evaluate(args[1], ctx.with_path("arg1"));
-    return EvaluationResult(lhs != rhs);
+    ForkJoinArguments values(args, ctx, "arg");
+    auto lhs = values.shared(0);
+    auto rhs = values.shared(1);
+    return EvaluationResult(*lhs != *rhs);
 }
 
 } // namespace computo::operators
@@ -1,8 +1,11 @@
 #include "operators/shared.hpp"
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace computo::operators {
 
-auto input_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto input_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         return EvaluationResult(ctx.input());
     }
@@ -12,12 +15,11 @@ auto input_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Ev
                                        ctx.get_path_string());
     }
 
-    auto result = evaluate_json_pointer(ctx.input(), args[0].as<std::string>(),
-                                        ctx.get_path_string() + " (in $input)");
+    auto result = evaluate_json_pointer(ctx.input(), args[0].as<std::string>(), ctx, "$input");
     return EvaluationResult(result);
 }
 
-auto inputs_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto inputs_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     // No arguments - return entire inputs array
     if (args.empty()) {
         jsom::JsonDocument result = jsom::JsonDocument::make_array();
@@ -32,19 +34,23 @@ auto inputs_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> E
                                        ctx.get_path_string());
     }
 
-    // Create inputs array for JSON Pointer navigation
+    // A path into one input resolves in place; the array of all inputs is only
+    // built to report a path that does not exist
+    if (const auto* value = find_inputs_pointer(ctx.inputs(), args[0].as<std::string>())) {
+        return EvaluationResult(*value);
+    }
+
     jsom::JsonDocument inputs_array = jsom::JsonDocument::make_array();
     for (const auto& input : ctx.inputs()) {
         inputs_array.push_back(input);
     }
 
-    auto result = evaluate_json_pointer(inputs_array, args[0].as<std::string>(),
-                                        ctx.get_path_string() + " (in $inputs)");
+    auto result = evaluate_json_pointer(inputs_array, args[0].as<std::string>(), ctx, "$inputs");
     return EvaluationResult(result);
 }
 
 // NOLINTBEGIN(readability-function-size)
-auto variable_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto variable_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1 || !args[0].is_string()) {
         throw InvalidArgumentException("'$' requires exactly 1 string argument (JSON Pointer)",
                                        ctx.get_path_string());
@@ -59,70 +65,94 @@ auto variable_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) ->
             ctx.get_path_string());
     }
 
-    // Parse variable name and sub-path
+    // Parse variable name and sub-path, then look up the innermost binding
     auto parts = parse_variable_path(json_pointer);
+    return EvaluationResult(variable_value(ctx.find_variable(parts.variable_name), parts, ctx));
+}
+// NOLINTEND(readability-function-size)
 
-    // Look up the variable
-    auto iter = ctx.variables.find(parts.variable_name);
-    if (iter == ctx.variables.end()) {
-        // Extract available variable names for suggestions
-        std::vector<std::string> available_vars;
-        available_vars.reserve(ctx.variables.size());
-        for (const auto& [name, _] : ctx.variables) {
-            available_vars.push_back(name);
-        }
+namespace {
 
-        auto suggestions = suggest_similar_names(parts.variable_name, available_vars, 2);
+auto is_well_formed_binding(const jsom::JsonDocument& binding) -> bool {
+    return binding.is_array() && binding.size() == 2 && binding[0].is_string();
+}
 
-        std::string message = "Variable not found: '" + parts.variable_name + "'";
-        if (!suggestions.empty()) {
-            message += ". Did you mean '" + suggestions[0] + "'?";
+// Binding values evaluated ahead, concurrently where worthwhile (array format:
+// up to the first malformed binding, which let reports when it gets there)
+auto fork_binding_values(const jsom::JsonDocument& bindings, const ExecutionContext& ctx,
+                         std::vector<std::string>& names) -> std::optional<ForkJoinArguments> {
+    if (!ForkJoinArguments::enabled(ctx)) {
+        return std::nullopt;
+    }
+    std::vector<const jsom::JsonDocument*> exprs;
+    if (bindings.is_object()) {
+        names.reserve(bindings.size());
+        // Pointers into the script itself: items() may hand out copies
+        for (const auto& [key, value] : bindings.items()) {
+            names.push_back(key);
+            exprs.push_back(&bindings[key]);
+        }
+    } else {
+        names.reserve(bindings.size());
+        for (const auto& binding : bindings) {
+            if (!is_well_formed_binding(binding)) {
+                break;
+            }
+            names.push_back(binding[0].as<std::string>());
+            exprs.push_back(&binding[1]);
         }
-
-        throw InvalidArgumentException(message, ctx.get_path_string());
     }
-
-    // If no sub-path, return the variable directly
-    if (parts.sub_path.empty()) {
-        return EvaluationResult(iter->second);
+    std::vector<ExecutionContext> contexts;
+    contexts.reserve(names.size());
+    for (const auto& name : names) {
+        contexts.push_back(ctx.with_path("binding_value_for_", name));
     }
-
-    // Use shared JSON Pointer evaluation for sub-path
-    auto result = evaluate_json_pointer(iter->second, parts.sub_path,
-                                        ctx.get_path_string() + " (in variable '"
-                                            + parts.variable_name + "')");
-    return EvaluationResult(result);
+    return ForkJoinArguments(std::move(exprs), std::move(contexts));
 }
-// NOLINTEND(readability-function-size)
+
+} // namespace
 
 // NOLINTBEGIN(readability-function-size)
-auto let_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto let_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'let' requires exactly 2 arguments (bindings and body)",
                                        ctx.get_path_string());
     }
 
-    std::map<std::string, jsom::JsonDocument> new_variables;
+    // Values are evaluated in the outer scope before the new frame exists. A
+    // value read from the input or another variable is shared, not copied.
+    std::vector<VariableFrame::Binding> new_variables;
+    std::vector<std::string> forked_names; // Referenced by the paths of forked values
 
     // Support both object format {"x": 42} and array format [["x", 42]]
     if (args[0].is_object()) {
         // Object format: {"x": 42, "y": 100}
+        new_variables.reserve(args[0].size());
+        auto values = fork_binding_values(args[0], ctx, forked_names);
+        std::size_t i = 0;
         for (const auto& [key, value] : args[0].items()) {
-            new_variables[key] = evaluate(value, ctx.with_path("binding_value_for_" + key));
+            new_variables.push_back(
+                {key, values ? values->shared(i++)
+                             : evaluate_shared(args[0][key],
+                                               ctx.with_path("binding_value_for_", key))});
         }
     } else if (args[0].is_array()) {
         // Array format: [["x", 42], ["y", 100]]
+        new_variables.reserve(args[0].size());
+        auto values = fork_binding_values(args[0], ctx, forked_names);
         for (size_t i = 0; i < args[0].size(); ++i) {
             const auto& binding = args[0][i];
-            if (!binding.is_array() || binding.size() != 2 || !binding[0].is_string()) {
+            if (!is_well_formed_binding(binding)) {
                 throw InvalidArgumentException(
                     "'let' binding must be a [name, value] array where name is "
                     "a string",
                     ctx.get_path_string());
             }
             std::string var_name = binding[0].as<std::string>();
-            new_variables[var_name]
-                = evaluate(binding[1], ctx.with_path("binding_value_for_" + var_name));
+            auto value = values ? values->shared(i)
+                                : evaluate_shared(binding[1],
+                                                  ctx.with_path("binding_value_for_", var_name));
+            new_variables.push_back({std::move(var_name), std::move(value)});
         }
     } else {
         throw InvalidArgumentException(
@@ -131,7 +161,8 @@ auto let_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
             ctx.get_path_string());
     }
 
-    ExecutionContext new_ctx = ctx.with_variables(new_variables);
+    // Slot i of the frame holds binding i (a repeated name's last binding wins)
+    ExecutionContext new_ctx = ctx.with_bindings(std::move(new_variables));
     return {args[1], new_ctx.with_path("let_body")}; // Tail call
 }
 // NOLINTEND(readability-function-size)
@@ -2,13 +2,13 @@
 
 namespace computo::operators {
 
-auto car_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto car_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'car' requires exactly 1 argument", ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data = extract_array_data(array_input, "car", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "car", ctx);
 
     if (array_data.empty()) {
         throw InvalidArgumentException("'car' cannot be applied to empty array",
@@ -18,13 +18,13 @@ auto car_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
     return EvaluationResult(array_data[0]);
 }
 
-auto cdr_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto cdr_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'cdr' requires exactly 1 argument", ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data = extract_array_data(array_input, "cdr", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "cdr", ctx);
 
     if (array_data.empty()) {
         throw InvalidArgumentException("'cdr' cannot be applied to empty array",
@@ -41,15 +41,15 @@ auto cdr_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto cons_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto cons_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'cons' requires exactly 2 arguments (item, array)",
                                        ctx.get_path_string());
     }
 
     auto item = evaluate(args[0], ctx);
-    auto array_input = evaluate(args[1], ctx);
-    auto array_data = extract_array_data(array_input, "cons", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[1], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "cons", ctx);
 
     jsom::JsonDocument result = jsom::JsonDocument::make_array();
 
@@ -64,7 +64,7 @@ auto cons_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto append_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto append_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'append' requires at least 1 argument",
                                        ctx.get_path_string());
@@ -72,10 +72,10 @@ auto append_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> E
 
     jsom::JsonDocument result = jsom::JsonDocument::make_array();
 
-    for (const auto& arg_expr : args) {
-        auto array_input = evaluate(arg_expr, ctx);
-        auto array_data
-            = extract_array_data(array_input, "append", ctx.get_path_string(), ctx.array_key);
+    ForkJoinArguments values(args, ctx);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto array_input = values.shared(i);
+        const auto& array_data = borrow_array_data(array_input.get(), "append", ctx);
 
         // Add all elements from this array to the result
         for (const auto& element : array_data) {
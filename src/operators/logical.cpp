@@ -2,14 +2,14 @@
 
 namespace computo::operators {
 
-auto logical_and(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto logical_and(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'and' requires at least 1 argument", ctx.get_path_string());
     }
 
     // N-ary AND with short-circuit evaluation
     for (size_t i = 0; i < args.size(); ++i) {
-        auto value = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
+        auto value = evaluate(args[i], ctx.with_path("arg", i));
         if (!is_truthy(value)) {
             return EvaluationResult(jsom::JsonDocument(false));
         }
@@ -18,14 +18,14 @@ auto logical_and(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evalu
     return EvaluationResult(jsom::JsonDocument(true));
 }
 
-auto logical_or(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto logical_or(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'or' requires at least 1 argument", ctx.get_path_string());
     }
 
     // N-ary OR with short-circuit evaluation
     for (size_t i = 0; i < args.size(); ++i) {
-        auto value = evaluate(args[i], ctx.with_path("arg" + std::to_string(i)));
+        auto value = evaluate(args[i], ctx.with_path("arg", i));
         if (is_truthy(value)) {
             return EvaluationResult(jsom::JsonDocument(true));
         }
@@ -34,12 +34,12 @@ auto logical_or(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Evalua
     return EvaluationResult(jsom::JsonDocument(false));
 }
 
-auto logical_not(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto logical_not(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'not' requires exactly 1 argument", ctx.get_path_string());
     }
 
-    auto value = evaluate(args[0], ctx.with_path("arg0"));
+    auto value = evaluate(args[0], ctx.with_path("arg", 0));
     bool result = !is_truthy(value);
 
     return EvaluationResult(jsom::JsonDocument(result));
@@ -3,7 +3,7 @@
 
 namespace computo::operators {
 
-auto obj_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto obj_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() % 2 != 0) {
         throw InvalidArgumentException(
             "'obj' requires an even number of arguments (key-value pairs)", ctx.get_path_string());
@@ -12,9 +12,10 @@ auto obj_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
     jsom::JsonDocument result = jsom::JsonDocument::make_object();
 
     // Process key-value pairs
+    ForkJoinArguments values(args, ctx);
     for (size_t i = 0; i < args.size(); i += 2) {
-        auto key_val = evaluate(args[i], ctx);
-        auto value_val = evaluate(args[i + 1], ctx);
+        auto key_val = values.value(i);
+        auto value_val = values.value(i + 1);
 
         if (!key_val.is_string()) {
             throw InvalidArgumentException("'obj' requires string keys", ctx.get_path_string());
@@ -27,12 +28,13 @@ auto obj_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
     return EvaluationResult(result);
 }
 
-auto keys_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto keys_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'keys' requires exactly 1 argument", ctx.get_path_string());
     }
 
-    auto obj = evaluate(args[0], ctx);
+    auto obj_value = evaluate_shared(args[0], ctx);
+    const auto& obj = obj_value.get();
     if (!obj.is_object()) {
         throw InvalidArgumentException("'keys' requires an object argument", ctx.get_path_string());
     }
@@ -45,13 +47,14 @@ auto keys_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto values_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto values_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'values' requires exactly 1 argument",
                                        ctx.get_path_string());
     }
 
-    auto obj = evaluate(args[0], ctx);
+    auto obj_value = evaluate_shared(args[0], ctx);
+    const auto& obj = obj_value.get();
     if (!obj.is_object()) {
         throw InvalidArgumentException("'values' requires an object argument",
                                        ctx.get_path_string());
@@ -65,15 +68,14 @@ auto values_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> E
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto objFromPairs_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto objFromPairs_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'objFromPairs' requires exactly 1 argument",
                                        ctx.get_path_string());
     }
 
-    auto pairs_input = evaluate(args[0], ctx);
-    auto pairs
-        = extract_array_data(pairs_input, "objFromPairs", ctx.get_path_string(), ctx.array_key);
+    auto pairs_input = evaluate_shared(args[0], ctx);
+    const auto& pairs = borrow_array_data(pairs_input.get(), "objFromPairs", ctx);
 
     jsom::JsonDocument result = jsom::JsonDocument::make_object();
 
@@ -96,22 +98,22 @@ auto objFromPairs_operator(const jsom::JsonDocument& args, ExecutionContext& ctx
 }
 
 // NOLINTBEGIN(readability-function-size)
-auto pick_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto pick_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'pick' requires exactly 2 arguments (object, keys)",
                                        ctx.get_path_string());
     }
 
-    auto obj = evaluate(args[0], ctx);
-    auto keys_input = evaluate(args[1], ctx);
+    auto obj_value = evaluate_shared(args[0], ctx);
+    const auto& obj = obj_value.get();
+    auto keys_input = evaluate_shared(args[1], ctx);
 
     if (!obj.is_object()) {
         throw InvalidArgumentException("'pick' requires an object as first argument",
                                        ctx.get_path_string());
     }
 
-    auto keys_to_pick
-        = extract_array_data(keys_input, "pick", ctx.get_path_string(), ctx.array_key);
+    const auto& keys_to_pick = borrow_array_data(keys_input.get(), "pick", ctx);
 
     jsom::JsonDocument result = jsom::JsonDocument::make_object();
 
@@ -131,22 +133,22 @@ auto pick_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
 // NOLINTEND(readability-function-size)
 
 // NOLINTBEGIN(readability-function-size)
-auto omit_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto omit_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'omit' requires exactly 2 arguments (object, keys)",
                                        ctx.get_path_string());
     }
 
-    auto obj = evaluate(args[0], ctx);
-    auto keys_input = evaluate(args[1], ctx);
+    auto obj_value = evaluate_shared(args[0], ctx);
+    const auto& obj = obj_value.get();
+    auto keys_input = evaluate_shared(args[1], ctx);
 
     if (!obj.is_object()) {
         throw InvalidArgumentException("'omit' requires an object as first argument",
                                        ctx.get_path_string());
     }
 
-    auto keys_to_omit
-        = extract_array_data(keys_input, "omit", ctx.get_path_string(), ctx.array_key);
+    const auto& keys_to_omit = borrow_array_data(keys_input.get(), "omit", ctx);
 
     // Create set of keys to omit for O(1) lookup
     std::set<std::string> omit_keys;
@@ -169,7 +171,7 @@ auto omit_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
 }
 // NOLINTEND(readability-function-size)
 
-auto merge_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto merge_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'merge' requires at least 1 argument",
                                        ctx.get_path_string());
@@ -177,8 +179,11 @@ auto merge_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Ev
 
     jsom::JsonDocument result = jsom::JsonDocument::make_object();
 
-    for (const auto& arg_expr : args) {
-        auto obj = evaluate(arg_expr, ctx);
+    // The result is the only clone; the objects merged into it are read in place
+    ForkJoinArguments values(args, ctx);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto obj_value = values.shared(i);
+        const auto& obj = obj_value.get();
         if (!obj.is_object()) {
             throw InvalidArgumentException("'merge' requires object arguments",
                                            ctx.get_path_string());
@@ -1,6 +1,10 @@
 #include "shared.hpp"
+#include "array_pipeline.hpp"
 #include <algorithm>
+#include <optional>
+#include <program.hpp>
 #include <sstream>
+#include <thread_pool.hpp>
 #include <vector>
 
 namespace computo {
@@ -38,10 +42,46 @@ auto validate_numeric_args(const jsom::JsonDocument& args, const std::string& op
     }
 }
 
-// NOLINTBEGIN(readability-function-size)
-auto evaluate_lambda(const jsom::JsonDocument& lambda_expr,
-                     const std::vector<jsom::JsonDocument>& lambda_args, ExecutionContext& ctx)
-    -> EvaluationResult {
+namespace {
+
+// Binds lambda parameters into a new frame (slot i holds parameter i)
+auto bind_lambda_params(const jsom::JsonDocument& params, std::vector<SharedJson> lambda_args,
+                        const ExecutionContext& ctx) -> ExecutionContext {
+    // Check parameter count matches argument count
+    if (params.size() != lambda_args.size()) {
+        std::ostringstream oss;
+        oss << "Lambda expects " << params.size() << " arguments, got " << lambda_args.size();
+        throw InvalidArgumentException(oss.str(), ctx.get_path_string());
+    }
+
+    std::vector<VariableFrame::Binding> bindings;
+    bindings.reserve(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (!params[i].is_string()) {
+            throw InvalidArgumentException("Lambda parameter names must be strings",
+                                           ctx.get_path_string());
+        }
+        bindings.push_back({params[i].as<std::string>(), std::move(lambda_args[i])});
+    }
+    return ctx.with_bindings(std::move(bindings));
+}
+
+// Binds lambda parameters and returns the body as a tail call-capable result
+auto bind_and_evaluate_lambda(const jsom::JsonDocument& params, const jsom::JsonDocument& body,
+                              const std::vector<jsom::JsonDocument>& lambda_args,
+                              ExecutionContext& ctx) -> EvaluationResult {
+    std::vector<SharedJson> shared_args;
+    shared_args.reserve(lambda_args.size());
+    for (const auto& arg : lambda_args) {
+        shared_args.emplace_back(arg);
+    }
+    auto lambda_ctx = bind_lambda_params(params, std::move(shared_args), ctx);
+    return evaluate_internal(body, lambda_ctx.with_path("lambda_body"));
+}
+
+// Checks the shape of a [params, body] lambda value
+auto validate_lambda_value(const jsom::JsonDocument& lambda_expr, const ExecutionContext& ctx)
+    -> void {
     // Lambda must be an array with exactly 2 elements: [params, body]
     if (!lambda_expr.is_array() || lambda_expr.size() != 2) {
         throw InvalidArgumentException("Lambda must be an array with 2 elements: [params, body]",
@@ -52,31 +92,67 @@ auto evaluate_lambda(const jsom::JsonDocument& lambda_expr,
     if (!lambda_expr[0].is_array()) {
         throw InvalidArgumentException("Lambda parameters must be an array", ctx.get_path_string());
     }
+}
 
-    // Check parameter count matches argument count
-    if (lambda_expr[0].size() != lambda_args.size()) {
-        std::ostringstream oss;
-        oss << "Lambda expects " << lambda_expr[0].size() << " arguments, got "
-            << lambda_args.size();
-        throw InvalidArgumentException(oss.str(), ctx.get_path_string());
+} // namespace
+
+auto evaluate_lambda(const jsom::JsonDocument& lambda_expr,
+                     const std::vector<jsom::JsonDocument>& lambda_args, ExecutionContext& ctx)
+    -> EvaluationResult {
+    validate_lambda_value(lambda_expr, ctx);
+    return bind_and_evaluate_lambda(lambda_expr[0], lambda_expr[1], lambda_args, ctx);
+}
+
+auto resolve_lambda(const jsom::JsonDocument& lambda_arg, const ExecutionContext& ctx,
+                    jsom::JsonDocument& lambda_storage) -> LambdaDefinition {
+    // Literal ["lambda", params, body]: reference it in place
+    if (lambda_arg.is_array() && lambda_arg.size() == 3 && lambda_arg[0].is_string()
+        && lambda_arg[0].as<std::string>() == "lambda") {
+        validate_lambda_params(lambda_arg[1], ctx);
+        return {&lambda_arg[1], &lambda_arg[2], nullptr};
+    }
+
+    // Anything else evaluates to a lambda value, checked when invoked
+    lambda_storage = evaluate(lambda_arg, ctx);
+    return {nullptr, nullptr, &lambda_storage};
+}
+
+auto evaluate_lambda(const LambdaDefinition& lambda,
+                     const std::vector<jsom::JsonDocument>& lambda_args, ExecutionContext& ctx)
+    -> EvaluationResult {
+    if (lambda.value != nullptr) {
+        return evaluate_lambda(*lambda.value, lambda_args, ctx);
+    }
+    return bind_and_evaluate_lambda(*lambda.params, *lambda.body, lambda_args, ctx);
+}
+
+auto invoke_lambda(const LambdaDefinition& lambda, std::vector<SharedJson> lambda_args,
+                   const ExecutionContext& ctx) -> jsom::JsonDocument {
+    const auto* params = lambda.params;
+    const auto* body = lambda.body;
+    if (lambda.value != nullptr) {
+        validate_lambda_value(*lambda.value, ctx);
+        params = &(*lambda.value)[0];
+        body = &(*lambda.value)[1];
     }
+    auto lambda_ctx = bind_lambda_params(*params, std::move(lambda_args), ctx);
+    return evaluate(*body, lambda_ctx.with_path("lambda_body"));
+}
 
-    // Build variable bindings
-    std::map<std::string, jsom::JsonDocument> bindings;
-    for (size_t i = 0; i < lambda_expr[0].size(); ++i) {
-        if (!lambda_expr[0][i].is_string()) {
+auto validate_lambda_params(const jsom::JsonDocument& params, const ExecutionContext& ctx)
+    -> void {
+    // Parameters must be an array of parameter names
+    if (!params.is_array()) {
+        throw InvalidArgumentException("Lambda parameters must be an array", ctx.get_path_string());
+    }
+
+    for (const auto& param : params) {
+        if (!param.is_string()) {
             throw InvalidArgumentException("Lambda parameter names must be strings",
                                            ctx.get_path_string());
         }
-        std::string param_name = lambda_expr[0][i].as<std::string>();
-        bindings[param_name] = lambda_args[i];
     }
-
-    // Execute lambda body with parameter bindings
-    auto lambda_ctx = ctx.with_variables(bindings);
-    return evaluate_internal(lambda_expr[1], lambda_ctx.with_path("lambda_body"));
 }
-// NOLINTEND(readability-function-size)
 
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 auto to_numeric(const jsom::JsonDocument& value, const std::string& op_name, const std::string& path)
@@ -127,6 +203,328 @@ auto extract_array_data(const jsom::JsonDocument& array_input, const std::string
     throw InvalidArgumentException("'" + op_name + "' requires an array argument", path);
 }
 
+auto extract_array_data(const jsom::JsonDocument& array_input, const std::string& op_name,
+                        const ExecutionContext& ctx) -> jsom::JsonDocument {
+    return borrow_array_data(array_input, op_name, ctx);
+}
+
+auto borrow_array_data(const jsom::JsonDocument& array_input, const std::string& op_name,
+                       const ExecutionContext& ctx) -> const jsom::JsonDocument& {
+    if (array_input.is_object() && array_input.contains(ctx.array_key)
+        && array_input[ctx.array_key].is_array()) {
+        return array_input[ctx.array_key];
+    }
+    if (array_input.is_array()) {
+        return array_input;
+    }
+
+    throw InvalidArgumentException("'" + op_name + "' requires an array argument",
+                                   ctx.get_path_string());
+}
+
+// --- Borrowed Operands ---
+
+auto parse_array_index(std::string_view token) -> std::optional<std::size_t> {
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0')) {
+        return std::nullopt;
+    }
+    std::size_t index = 0;
+    for (char digit : token) {
+        if (digit < '0' || digit > '9') {
+            return std::nullopt;
+        }
+        index = index * 10 + static_cast<std::size_t>(digit - '0');
+    }
+    return index;
+}
+
+namespace {
+
+// Handle to the value at pointer inside root's value, if there is one
+auto share_pointer(const SharedJson& root, std::string_view pointer) -> std::optional<SharedJson> {
+    if (const auto* value = find_json_pointer(*root, pointer)) {
+        return root.share(*value);
+    }
+    return std::nullopt;
+}
+
+// ["$", "/name/..."] against a binding found by name or slot
+auto share_variable(const SharedJson* binding, const std::string& sub_path)
+    -> std::optional<SharedJson> {
+    if (binding == nullptr) {
+        return std::nullopt;
+    }
+    return sub_path.empty() ? *binding : share_pointer(*binding, sub_path);
+}
+
+// A script value outlives any operator reading it (see TailCall)
+auto share_script_value(const jsom::JsonDocument& value) -> SharedJson { return {nullptr, value}; }
+
+// ["$inputs", "/i/..."]
+auto share_inputs_pointer(const ExecutionContext& ctx, std::string_view pointer)
+    -> std::optional<SharedJson> {
+    if (const auto* value = find_inputs_pointer(ctx.inputs(), pointer)) {
+        return SharedJson(ctx.shared_inputs(), *value);
+    }
+    return std::nullopt;
+}
+
+// The value of expr where it already lives: in the input, a variable or the
+// script. Empty if it has to be computed (or evaluating expr throws).
+// NOLINTBEGIN(readability-function-size)
+auto find_shared_value(const jsom::JsonDocument& expr, const ExecutionContext& ctx)
+    -> std::optional<SharedJson> {
+    if (ctx.program() != nullptr) {
+        if (const auto* node = ctx.program()->find_node(expr)) {
+            if (const auto* value = hoisted_value(*node, ctx)) {
+                return share_script_value(*value); // Cached for the running loop call
+            }
+            switch (node->kind) {
+            case NodeKind::Literal:
+                return share_script_value(*node->literal);
+            case NodeKind::VariableLoad:
+                return share_variable(find_compiled_binding(*node, ctx), node->variable.sub_path);
+            case NodeKind::OperatorCall:
+                break; // $input below
+            default:
+                return std::nullopt;
+            }
+        }
+    }
+
+    if (!expr.is_array()) {
+        if (expr.is_object() && expr.size() == 1 && expr.contains(ctx.array_key)) {
+            if (!expr[ctx.array_key].is_array()) {
+                return std::nullopt;
+            }
+            return share_script_value(expr[ctx.array_key]);
+        }
+        return share_script_value(expr);
+    }
+    if (expr.empty()) {
+        return share_script_value(expr);
+    }
+    if (!expr[0].is_string() || expr.size() > 2 || (expr.size() == 2 && !expr[1].is_string())) {
+        return std::nullopt;
+    }
+
+    const auto& name = expr[0].as<std::string>();
+    if (name == "$input") {
+        return expr.size() == 1 ? ctx.shared_input()
+                                : share_pointer(ctx.shared_input(), expr[1].as<std::string>());
+    }
+    if (name == "$inputs" && expr.size() == 2) {
+        return share_inputs_pointer(ctx, expr[1].as<std::string>());
+    }
+    if (name == "$" && expr.size() == 2) {
+        auto pointer = expr[1].as<std::string>();
+        if (pointer.empty() || pointer[0] != '/') {
+            return std::nullopt;
+        }
+        auto parts = parse_variable_path(pointer);
+        return share_variable(ctx.find_binding(parts.variable_name), parts.sub_path);
+    }
+    return std::nullopt;
+}
+// NOLINTEND(readability-function-size)
+
+} // namespace
+
+auto find_json_pointer(const jsom::JsonDocument& root, std::string_view pointer_str)
+    -> const jsom::JsonDocument* {
+    if (pointer_str.empty() || pointer_str[0] != '/') {
+        return nullptr;
+    }
+    const auto* current = &root;
+    std::size_t start = 1;
+    while (true) {
+        auto end = pointer_str.find('/', start);
+        auto token = pointer_str.substr(start, end == std::string_view::npos ? end : end - start);
+        if (token.empty() || token.find('~') != std::string_view::npos) {
+            return nullptr;
+        }
+        if (current->is_object()) {
+            std::string key(token);
+            if (!current->contains(key)) {
+                return nullptr;
+            }
+            current = &(*current)[key];
+        } else if (current->is_array()) {
+            auto index = parse_array_index(token);
+            if (!index || *index >= current->size()) {
+                return nullptr;
+            }
+            current = &(*current)[*index];
+        } else {
+            return nullptr;
+        }
+        if (end == std::string_view::npos) {
+            return current;
+        }
+        start = end + 1;
+    }
+}
+
+auto find_inputs_pointer(const std::vector<jsom::JsonDocument>& inputs, std::string_view pointer_str)
+    -> const jsom::JsonDocument* {
+    if (pointer_str.empty() || pointer_str[0] != '/') {
+        return nullptr;
+    }
+    auto end = pointer_str.find('/', 1);
+    auto index =
+        parse_array_index(pointer_str.substr(1, end == std::string_view::npos ? end : end - 1));
+    if (!index || *index >= inputs.size()) {
+        return nullptr;
+    }
+    if (end == std::string_view::npos) {
+        return &inputs[*index];
+    }
+    return find_json_pointer(inputs[*index], pointer_str.substr(end));
+}
+
+auto evaluate_shared(const jsom::JsonDocument& expr, const ExecutionContext& ctx) -> SharedJson {
+    if (auto value = find_shared_value(expr, ctx)) {
+        return std::move(*value);
+    }
+    return SharedJson(evaluate(expr, ctx));
+}
+
+namespace {
+
+// Elements a loop is assumed to run over when estimating costs
+constexpr std::size_t ASSUMED_ELEMENTS = 1000;
+
+auto is_loop_operator(const std::string& name) -> bool {
+    return name == "map" || name == "filter" || name == "reduce" || name == "find"
+           || name == "some" || name == "every" || name == "sort";
+}
+
+// Rough number of evaluation steps in expr, counting a loop's arguments once
+// per assumed element. Literals cost nothing; counting stops at limit.
+auto estimate_cost(const jsom::JsonDocument& expr, std::size_t limit) -> std::size_t {
+    if (!expr.is_array() || expr.empty()) {
+        return 0;
+    }
+    std::size_t weight = 1;
+    if (expr[0].is_string() && is_loop_operator(expr[0].as<std::string>())) {
+        weight = ASSUMED_ELEMENTS;
+    }
+    std::size_t cost = 1;
+    for (const auto& element : expr) {
+        auto element_cost = estimate_cost(element, limit);
+        auto added = element_cost > limit / weight ? limit : element_cost * weight;
+        if (cost >= limit || added >= limit - cost) {
+            return limit;
+        }
+        cost += added;
+    }
+    return cost;
+}
+
+} // namespace
+
+ForkJoinArguments::ForkJoinArguments(const OperatorArgs& args, const ExecutionContext& ctx,
+                                     const char* label)
+    : args_(&args), ctx_(&ctx), label_(label) {
+    if (enabled(ctx) && args.size() >= 2) {
+        fork();
+    }
+}
+
+ForkJoinArguments::ForkJoinArguments(std::vector<const jsom::JsonDocument*> exprs,
+                                     std::vector<ExecutionContext> contexts)
+    : exprs_(std::move(exprs)), contexts_(std::move(contexts)) {
+    if (!contexts_.empty() && enabled(contexts_.front()) && exprs_.size() >= 2) {
+        fork();
+    }
+}
+
+auto ForkJoinArguments::enabled(const ExecutionContext& ctx) -> bool {
+    return ctx.parallel() != nullptr && ctx.parallel()->threads > 1;
+}
+
+auto ForkJoinArguments::size() const -> std::size_t {
+    return args_ != nullptr ? args_->size() : exprs_.size();
+}
+
+auto ForkJoinArguments::expression(std::size_t index) const -> const jsom::JsonDocument& {
+    return args_ != nullptr ? (*args_)[index] : *exprs_[index];
+}
+
+auto ForkJoinArguments::context(std::size_t index) const -> const ExecutionContext& {
+    return ctx_ != nullptr ? *ctx_ : contexts_[index];
+}
+
+template <typename Evaluator>
+auto ForkJoinArguments::evaluate_argument(std::size_t index, Evaluator evaluator) const {
+    if (label_ != nullptr) {
+        return evaluator(expression(index), ctx_->with_path(label_, index));
+    }
+    return evaluator(expression(index), context(index));
+}
+
+void ForkJoinArguments::fork() {
+    const auto& options = *context(0).parallel();
+    std::vector<std::size_t> expensive;
+    for (std::size_t i = 0; i < size(); ++i) {
+        if (estimate_cost(expression(i), options.min_argument_cost) >= options.min_argument_cost) {
+            expensive.push_back(i);
+        }
+    }
+    if (expensive.size() < 2) {
+        return;
+    }
+
+    values_.resize(size());
+    errors_.resize(size());
+    thread_pool::parallel_for(expensive.size(), 1, options.threads,
+                              [&](std::size_t begin, std::size_t end) {
+                                  for (auto k = begin; k < end; ++k) {
+                                      auto i = expensive[k];
+                                      try {
+                                          values_[i] = evaluate_argument(
+                                              i, [](const jsom::JsonDocument& expr,
+                                                    const ExecutionContext& arg_ctx) {
+                                                  return evaluate_shared(expr,
+                                                                         arg_ctx.as_concurrent());
+                                              });
+                                      } catch (...) {
+                                          errors_[i] = std::current_exception();
+                                      }
+                                  }
+                              });
+}
+
+auto ForkJoinArguments::forked_value(std::size_t index) -> std::optional<SharedJson>* {
+    if (values_.empty()) {
+        return nullptr;
+    }
+    if (errors_[index]) {
+        std::rethrow_exception(errors_[index]);
+    }
+    return values_[index] ? &values_[index] : nullptr;
+}
+
+auto ForkJoinArguments::value(std::size_t index) -> jsom::JsonDocument {
+    if (auto* forked = forked_value(index)) {
+        return std::move(**forked).take();
+    }
+    return evaluate_argument(index,
+                             [](const jsom::JsonDocument& expr, const ExecutionContext& arg_ctx) {
+                                 return evaluate(expr, arg_ctx);
+                             });
+}
+
+auto ForkJoinArguments::shared(std::size_t index) -> SharedJson {
+    if (auto* forked = forked_value(index)) {
+        return std::move(**forked);
+    }
+    return evaluate_argument(index,
+                             [](const jsom::JsonDocument& expr, const ExecutionContext& arg_ctx) {
+                                 return evaluate_shared(expr, arg_ctx);
+                             });
+}
+
 // NOLINTBEGIN(readability-function-size)
 auto calculate_levenshtein_distance(const std::string& first_string,
                                     const std::string& second_string) -> int {
@@ -202,37 +600,67 @@ auto suggest_similar_names(const std::string& target, const std::vector<std::str
 
 // NOLINTBEGIN(readability-function-size)
 auto process_array_with_lambda(
-    const jsom::JsonDocument& args, ExecutionContext& ctx, const std::string& op_name,
+    const OperatorArgs& args, ExecutionContext& ctx, const std::string& op_name,
     const std::function<bool(const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result,
-                             jsom::JsonDocument& final_result)>& processor) -> jsom::JsonDocument {
+                             jsom::JsonDocument& final_result)>& processor,
+    bool every_element) -> jsom::JsonDocument {
     if (args.size() != 2) {
         throw InvalidArgumentException("'" + op_name
                                            + "' requires exactly 2 arguments (array, lambda)",
                                        ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data
-        = extract_array_data(array_input, op_name, ctx.get_path_string(), ctx.array_key);
-
     jsom::JsonDocument final_result; // The processor will populate this
+    jsom::JsonDocument lambda_storage;
+
+    // A map / filter chain as the array argument streams its elements here
+    if (auto pipeline = ArrayPipeline::match(args[0], ctx)) {
+        LambdaDefinition lambda;
+        pipeline->run(
+            ctx, [&]() { lambda = resolve_lambda(args[1], ctx.with_path("lambda"), lambda_storage); },
+            [&](const SharedJson& item) {
+                auto lambda_result = invoke_lambda(lambda, {item}, ctx);
+                return processor(*item, lambda_result, final_result);
+            });
+        return final_result;
+    }
 
-    // Evaluate the lambda expression first (handles ["lambda", ...] syntax)
-    auto lambda_expr = evaluate(args[1], ctx.with_path("lambda"));
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), op_name, ctx);
+
+    // Resolve the lambda once (["lambda", ...] is referenced, not copied)
+    auto lambda = resolve_lambda(args[1], ctx.with_path("lambda"), lambda_storage);
+
+    const auto* parallel = ctx.parallel();
+    if (every_element && parallel != nullptr && parallel->threads > 1
+        && array_data.size() >= std::max<std::size_t>(parallel->min_elements, 2)) {
+        // Chunks evaluate the lambda concurrently; the processor then sees
+        // the results in order, as it would have sequentially
+        auto count = array_data.size();
+        auto chunk_size = parallel->chunk_size > 0
+                              ? parallel->chunk_size
+                              : std::max<std::size_t>(count / (parallel->threads * 8), 1);
+        std::vector<jsom::JsonDocument> lambda_results(count);
+        auto chunk_ctx = ctx.as_concurrent();
+        thread_pool::parallel_for(count, chunk_size, parallel->threads,
+                                  [&](std::size_t begin, std::size_t end) {
+                                      for (auto i = begin; i < end; ++i) {
+                                          lambda_results[i] = invoke_lambda(
+                                              lambda, {array_input.share(array_data[i])}, chunk_ctx);
+                                      }
+                                  });
+        for (std::size_t i = 0; i < count; ++i) {
+            (void)processor(array_data[i], lambda_results[i], final_result);
+        }
+        return final_result;
+    }
 
     for (const auto& item : array_data) {
-        std::vector<jsom::JsonDocument> lambda_args = {item};
-        auto lambda_result = evaluate_lambda(lambda_expr, lambda_args, ctx);
-
-        // Resolve any tail calls from lambda evaluation
-        while (lambda_result.is_tail_call) {
-            lambda_result = evaluate_internal(lambda_result.tail_call->expression,
-                                              lambda_result.tail_call->context);
-        }
+        auto lambda_result = invoke_lambda(lambda, {array_input.share(item)}, ctx);
 
         // Let the processor handle the item and lambda result
         // The processor returns true to continue, false to break early (for find, some, every)
-        bool should_continue = processor(item, lambda_result.value, final_result);
+        bool should_continue = processor(item, lambda_result, final_result);
         if (!should_continue) {
             break;
         }
@@ -257,6 +685,28 @@ auto evaluate_json_pointer(const jsom::JsonDocument& root, const std::string& po
     }
 }
 
+auto evaluate_json_pointer(const jsom::JsonDocument& root, const std::string& pointer_str,
+                           const ExecutionContext& ctx, std::string_view source,
+                           std::string_view name) -> jsom::JsonDocument {
+    if (!pointer_str.empty() && pointer_str[0] == '/') {
+        try {
+            return root.at(pointer_str);
+        } catch (const std::exception&) {
+            // Reported below with the rendered location
+        }
+    }
+
+    std::string where = ctx.get_path_string() + " (in ";
+    where += source;
+    if (!name.empty()) {
+        where += " '";
+        where += name;
+        where += "'";
+    }
+    where += ")";
+    return evaluate_json_pointer(root, pointer_str, where);
+}
+
 auto parse_variable_path(const std::string& full_path) -> VariablePathParts {
     VariablePathParts parts;
 
@@ -276,4 +726,34 @@ auto parse_variable_path(const std::string& full_path) -> VariablePathParts {
     return parts;
 }
 
+auto variable_value(const jsom::JsonDocument* binding, const VariablePathParts& parts,
+                    const ExecutionContext& ctx) -> jsom::JsonDocument {
+    if (binding == nullptr) {
+        // Extract available variable names for suggestions
+        auto visible = ctx.variables();
+        std::vector<std::string> available_vars;
+        available_vars.reserve(visible.size());
+        for (const auto& [name, _] : visible) {
+            available_vars.push_back(name);
+        }
+
+        auto suggestions = suggest_similar_names(parts.variable_name, available_vars, 2);
+
+        std::string message = "Variable not found: '" + parts.variable_name + "'";
+        if (!suggestions.empty()) {
+            message += ". Did you mean '" + suggestions[0] + "'?";
+        }
+
+        throw InvalidArgumentException(message, ctx.get_path_string());
+    }
+
+    // If no sub-path, return the variable directly
+    if (parts.sub_path.empty()) {
+        return *binding;
+    }
+
+    // Use shared JSON Pointer evaluation for sub-path
+    return evaluate_json_pointer(*binding, parts.sub_path, ctx, "variable", parts.variable_name);
+}
+
 } // namespace computo
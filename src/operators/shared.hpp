@@ -1,8 +1,11 @@
 #pragma once
 
 #include <computo.hpp>
+#include <exception>
+#include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace computo {
 
@@ -36,6 +39,56 @@ auto evaluate_lambda(const jsom::JsonDocument& lambda_expr,
                      const std::vector<jsom::JsonDocument>& lambda_args,
                      ExecutionContext& ctx) -> EvaluationResult;
 
+/**
+ * A lambda resolved once for repeated invocation by map, filter, reduce, etc.
+ * Either points straight into a ["lambda", params, body] expression, or at a
+ * lambda value (e.g. one stored in a variable) kept alive by the caller.
+ */
+struct LambdaDefinition {
+    const jsom::JsonDocument* params{nullptr};
+    const jsom::JsonDocument* body{nullptr};
+    const jsom::JsonDocument* value{nullptr}; // [params, body] value, validated per call
+};
+
+/**
+ * Resolve the lambda argument of an array operator without copying it
+ *
+ * A literal ["lambda", params, body] is referenced in place, so its body is
+ * never copied (and stays part of a compiled program). Any other expression
+ * is evaluated into lambda_storage.
+ *
+ * @param lambda_arg The unevaluated lambda argument
+ * @param ctx The execution context for the lambda argument
+ * @param lambda_storage Holds an evaluated lambda value; must outlive the result
+ */
+auto resolve_lambda(const jsom::JsonDocument& lambda_arg, const ExecutionContext& ctx,
+                    jsom::JsonDocument& lambda_storage) -> LambdaDefinition;
+
+/**
+ * Invoke a lambda returned by resolve_lambda()
+ */
+auto evaluate_lambda(const LambdaDefinition& lambda,
+                     const std::vector<jsom::JsonDocument>& lambda_args,
+                     ExecutionContext& ctx) -> EvaluationResult;
+
+/**
+ * Invoke a lambda returned by resolve_lambda() through evaluate(), so its
+ * tail calls and any deep recursion are handled by the one trampoline
+ *
+ * Arguments are bound by handle: an element of an input array is shared with
+ * the input rather than copied into the parameter.
+ *
+ * @return The final value of the lambda body
+ */
+auto invoke_lambda(const LambdaDefinition& lambda, std::vector<SharedJson> lambda_args,
+                   const ExecutionContext& ctx) -> jsom::JsonDocument;
+
+/**
+ * Validate a lambda parameter list: an array of parameter name strings
+ * Throws InvalidArgumentException otherwise
+ */
+auto validate_lambda_params(const jsom::JsonDocument& params, const ExecutionContext& ctx) -> void;
+
 /**
  * Convert a JSON value to a numeric double
  * Throws InvalidArgumentException if the value is not numeric
@@ -62,6 +115,112 @@ auto extract_array_data(const jsom::JsonDocument& array_input,
                         const std::string& path,
                         const std::string& array_key = "array") -> jsom::JsonDocument;
 
+/**
+ * extract_array_data() for operators: uses ctx.array_key, and only renders
+ * the execution path if the input is not an array
+ */
+auto extract_array_data(const jsom::JsonDocument& array_input, const std::string& op_name,
+                        const ExecutionContext& ctx) -> jsom::JsonDocument;
+
+/**
+ * Evaluate an operator argument without copying a value that already exists
+ *
+ * Literals (including the contents of {"array": [...]}), ["$input"],
+ * ["$input", "/ptr"], ["$inputs", "/i/ptr"], ["$", "/name/..."] and hoisted
+ * loop invariants come back as handles sharing the storage they live in, in
+ * O(1). Everything else, including lookups that fail, goes through
+ * evaluate(), so results and errors are exactly those of evaluate().
+ */
+auto evaluate_shared(const jsom::JsonDocument& expr, const ExecutionContext& ctx) -> SharedJson;
+
+// --- Fork-Join Argument Evaluation ---
+
+/**
+ * The arguments of one operator call, expensive ones evaluated concurrently
+ *
+ * With ctx.parallel() set, arguments whose estimated cost reaches
+ * ParallelOptions::min_argument_cost are evaluated up front on the shared
+ * thread pool, when there are at least two of them; the rest are evaluated
+ * when the operator asks for them. Operators still take their arguments one
+ * by one, in order: value(i) / shared(i) return argument i or rethrow the
+ * error evaluating it raised, so the first error an operator meets is the one
+ * sequential evaluation would have met. Arguments after a failing one may have
+ * been evaluated in vain, which scripts cannot observe.
+ *
+ * Without ctx.parallel() nothing is allocated and each argument is evaluated
+ * exactly as evaluate() / evaluate_shared() would.
+ */
+class ForkJoinArguments {
+public:
+    // Argument i is args[i], evaluated in ctx, or in ctx.with_path(label, i)
+    // when label is set (operators whose errors name the argument)
+    ForkJoinArguments(const OperatorArgs& args, const ExecutionContext& ctx,
+                      const char* label = nullptr);
+
+    // Argument i is *exprs[i], evaluated in contexts[i] (let binding values)
+    ForkJoinArguments(std::vector<const jsom::JsonDocument*> exprs,
+                      std::vector<ExecutionContext> contexts);
+
+    // Whether ctx allows evaluating arguments concurrently at all
+    static auto enabled(const ExecutionContext& ctx) -> bool;
+
+    // Argument i; each argument is taken once
+    auto value(std::size_t index) -> jsom::JsonDocument;
+    auto shared(std::size_t index) -> SharedJson;
+
+private:
+    const OperatorArgs* args_{nullptr};
+    const ExecutionContext* ctx_{nullptr};
+    const char* label_{nullptr};
+    std::vector<const jsom::JsonDocument*> exprs_;
+    std::vector<ExecutionContext> contexts_;
+    std::vector<std::optional<SharedJson>> values_; // By index; empty unless forked
+    std::vector<std::exception_ptr> errors_;
+
+    [[nodiscard]] auto size() const -> std::size_t;
+    [[nodiscard]] auto expression(std::size_t index) const -> const jsom::JsonDocument&;
+    [[nodiscard]] auto context(std::size_t index) const -> const ExecutionContext&;
+    // Evaluates argument i with evaluator in its context
+    template <typename Evaluator>
+    auto evaluate_argument(std::size_t index, Evaluator evaluator) const;
+    void fork();
+    // Argument i if it was forked (rethrowing its error), else nullptr
+    auto forked_value(std::size_t index) -> std::optional<SharedJson>*;
+};
+
+/**
+ * extract_array_data() without the copy
+ *
+ * @return The array inside array_input; valid as long as array_input is
+ */
+auto borrow_array_data(const jsom::JsonDocument& array_input, const std::string& op_name,
+                       const ExecutionContext& ctx) -> const jsom::JsonDocument&;
+
+/**
+ * Array index from a JSON Pointer reference token, as jsom reads it: digits
+ * without leading zeros
+ *
+ * @return The index, or std::nullopt if token is not one
+ */
+auto parse_array_index(std::string_view token) -> std::optional<std::size_t>;
+
+/**
+ * Resolve a JSON Pointer in place, without copying or throwing
+ * Only plain reference tokens are resolved: pointers with "~" escapes, empty
+ * tokens or non-canonical array indices return nullptr, to be handled by
+ * evaluate_json_pointer()
+ *
+ * @return The value at pointer_str, or nullptr
+ */
+auto find_json_pointer(const jsom::JsonDocument& root, std::string_view pointer_str)
+    -> const jsom::JsonDocument*;
+
+/**
+ * find_json_pointer() over $inputs, the array of all inputs, without building it
+ */
+auto find_inputs_pointer(const std::vector<jsom::JsonDocument>& inputs, std::string_view pointer_str)
+    -> const jsom::JsonDocument*;
+
 /**
  * Calculate Levenshtein distance between two strings
  * Used for typo detection in operator and variable names
@@ -93,10 +252,13 @@ auto suggest_similar_names(const std::string& target,
  * @param ctx The execution context
  * @param op_name The operator name for error messages  
  * @param processor A callback that processes each (item, lambda_result) pair and can modify final_result
+ * @param every_element True when processor never stops early, so with ctx.parallel() set the
+ *                      lambda may run on chunks of a large array concurrently (map, filter)
  * @return The processor's populated result
  */
-auto process_array_with_lambda(const jsom::JsonDocument& args, ExecutionContext& ctx, const std::string& op_name,
-                               const std::function<bool(const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result, jsom::JsonDocument& final_result)>& processor) -> jsom::JsonDocument;
+auto process_array_with_lambda(const OperatorArgs& args, ExecutionContext& ctx, const std::string& op_name,
+                               const std::function<bool(const jsom::JsonDocument& item, const jsom::JsonDocument& lambda_result, jsom::JsonDocument& final_result)>& processor,
+                               bool every_element = false) -> jsom::JsonDocument;
 
 /**
  * Evaluate a JSON Pointer path against a JSON object
@@ -110,6 +272,14 @@ auto process_array_with_lambda(const jsom::JsonDocument& args, ExecutionContext&
  */
 auto evaluate_json_pointer(const jsom::JsonDocument& root, const std::string& pointer_str, const std::string& path_context) -> jsom::JsonDocument;
 
+/**
+ * evaluate_json_pointer() for operators: the error location is rendered from
+ * ctx only on failure, as "<path> (in <source>)" or "<path> (in <source> '<name>')"
+ */
+auto evaluate_json_pointer(const jsom::JsonDocument& root, const std::string& pointer_str,
+                           const ExecutionContext& ctx, std::string_view source,
+                           std::string_view name = {}) -> jsom::JsonDocument;
+
 /**
  * Parse a variable path like "/varname/sub/path" into variable name and sub-path
  * Used by the $ operator to separate variable lookup from sub-path evaluation
@@ -123,4 +293,17 @@ struct VariablePathParts {
 };
 auto parse_variable_path(const std::string& full_path) -> VariablePathParts;
 
+/**
+ * Finish a $ lookup once the variable binding has been located
+ * Shared by the $ operator and compiled slot loads
+ *
+ * @param binding The bound value, or nullptr if the variable is not in scope
+ * @param parts The parsed variable name and sub-path
+ * @param ctx The execution context (for suggestions and error paths)
+ * @return The variable value, or the value at its sub-path
+ * @throws InvalidArgumentException if the variable or sub-path does not exist
+ */
+auto variable_value(const jsom::JsonDocument* binding, const VariablePathParts& parts,
+                    const ExecutionContext& ctx) -> jsom::JsonDocument;
+
 } // namespace computo
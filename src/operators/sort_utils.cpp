@@ -149,7 +149,7 @@ auto parse_field_descriptor(const jsom::JsonDocument& field_spec) -> FieldDescri
 // NOLINTEND(readability-function-size)
 
 // NOLINTBEGIN(readability-function-size)
-auto parse_sort_arguments(const jsom::JsonDocument& args) -> SortConfig {
+auto parse_sort_arguments(const OperatorArgs& args) -> SortConfig {
     SortConfig config;
 
     if (args.size() == 1) {
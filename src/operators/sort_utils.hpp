@@ -78,7 +78,7 @@ auto parse_field_descriptor(const jsom::JsonDocument& field_spec) -> FieldDescri
  * Parse sort operator arguments to determine sorting configuration
  * Handles disambiguation between simple array sorting and object field sorting
  */
-auto parse_sort_arguments(const jsom::JsonDocument& args) -> SortConfig;
+auto parse_sort_arguments(const OperatorArgs& args) -> SortConfig;
 
 // --- DSU Comparator Functions ---
 
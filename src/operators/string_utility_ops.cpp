@@ -17,13 +17,13 @@ namespace computo::operators {
 // lexicographic sorting.
 
 // NOLINTBEGIN(readability-function-size)
-auto join_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto join_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'join' requires exactly 2 arguments (array, delimiter)",
                                        ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
+    auto array_input = evaluate_shared(args[0], ctx);
     auto delim_val = evaluate(args[1], ctx);
 
     if (!delim_val.is_string()) {
@@ -31,7 +31,7 @@ auto join_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
                                        ctx.get_path_string());
     }
 
-    auto array_data = extract_array_data(array_input, "join", ctx.get_path_string(), ctx.array_key);
+    const auto& array_data = borrow_array_data(array_input.get(), "join", ctx);
 
     std::string delimiter = delim_val.as<std::string>();
     std::string result;
@@ -59,7 +59,7 @@ auto join_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
 }
 // NOLINTEND(readability-function-size)
 
-auto strConcat_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto strConcat_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'strConcat' requires at least 1 argument",
                                        ctx.get_path_string());
@@ -67,8 +67,9 @@ auto strConcat_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -
 
     std::string result;
 
-    for (const auto& arg_expr : args) {
-        auto arg = evaluate(arg_expr, ctx);
+    ForkJoinArguments values(args, ctx);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto arg = values.value(i);
 
         if (arg.is_string()) {
             result += arg.as<std::string>();
@@ -89,15 +90,15 @@ auto strConcat_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -
 // --- Sort Operator Implementation ---
 
 // The new, clean main operator
-auto sort_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto sort_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty()) {
         throw InvalidArgumentException("'sort' requires at least 1 argument",
                                        ctx.get_path_string());
     }
 
     // 1. Argument parsing and data extraction remain here
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data = extract_array_data(array_input, "sort", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "sort", ctx);
 
     // Parse arguments to determine sorting strategy
     SortConfig config;
@@ -107,7 +108,7 @@ auto sort_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
         throw InvalidArgumentException(e.what(), ctx.get_path_string());
     }
 
-    // Make a copy to sort
+    // Sorting is the one step that needs its own copy
     jsom::JsonDocument result = array_data;
 
     // 2. Dispatch to the correct helper
@@ -120,15 +121,14 @@ auto sort_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eva
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto reverse_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto reverse_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'reverse' requires exactly 1 argument",
                                        ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data
-        = extract_array_data(array_input, "reverse", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "reverse", ctx);
 
     jsom::JsonDocument result = jsom::JsonDocument::make_array();
 
@@ -140,15 +140,14 @@ auto reverse_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) ->
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto unique_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto unique_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 1) {
         throw InvalidArgumentException("'unique' requires exactly 1 argument",
                                        ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data
-        = extract_array_data(array_input, "unique", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "unique", ctx);
 
     jsom::JsonDocument result = jsom::JsonDocument::make_array();
     std::set<jsom::JsonDocument> seen;
@@ -192,7 +191,7 @@ auto extract_unique_key(const jsom::JsonDocument& element, const std::string& fi
 }
 
 // NOLINTBEGIN(readability-function-size)
-auto parse_unique_sorted_config(const jsom::JsonDocument& args) -> UniqueSortedConfig {
+auto parse_unique_sorted_config(const OperatorArgs& args) -> UniqueSortedConfig {
     UniqueSortedConfig config;
     config.mode = "firsts"; // Default mode
 
@@ -237,15 +236,14 @@ auto parse_unique_sorted_config(const jsom::JsonDocument& args) -> UniqueSortedC
 // NOLINTEND(readability-function-size)
 
 // NOLINTBEGIN(readability-function-size)
-auto unique_sorted_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto unique_sorted_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.empty() || args.size() > 3) {
         throw InvalidArgumentException("'uniqueSorted' requires 1-3 arguments",
                                        ctx.get_path_string());
     }
 
-    auto array_input = evaluate(args[0], ctx);
-    auto array_data
-        = extract_array_data(array_input, "uniqueSorted", ctx.get_path_string(), ctx.array_key);
+    auto array_input = evaluate_shared(args[0], ctx);
+    const auto& array_data = borrow_array_data(array_input.get(), "uniqueSorted", ctx);
 
     // Parse configuration
     UniqueSortedConfig config;
@@ -300,18 +298,17 @@ auto unique_sorted_operator(const jsom::JsonDocument& args, ExecutionContext& ct
 }
 // NOLINTEND(readability-function-size)
 
-auto zip_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto zip_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 2) {
         throw InvalidArgumentException("'zip' requires exactly 2 arguments", ctx.get_path_string());
     }
 
-    auto array1_input = evaluate(args[0], ctx);
-    auto array2_input = evaluate(args[1], ctx);
+    ForkJoinArguments values(args, ctx);
+    auto array1_input = values.shared(0);
+    auto array2_input = values.shared(1);
 
-    auto array1_data
-        = extract_array_data(array1_input, "zip", ctx.get_path_string(), ctx.array_key);
-    auto array2_data
-        = extract_array_data(array2_input, "zip", ctx.get_path_string(), ctx.array_key);
+    const auto& array1_data = borrow_array_data(array1_input.get(), "zip", ctx);
+    const auto& array2_data = borrow_array_data(array2_input.get(), "zip", ctx);
 
     jsom::JsonDocument result = jsom::JsonDocument::make_array();
 
@@ -326,7 +323,7 @@ auto zip_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> Eval
     return EvaluationResult(jsom::JsonDocument{{ctx.array_key, result}});
 }
 
-auto approx_operator(const jsom::JsonDocument& args, ExecutionContext& ctx) -> EvaluationResult {
+auto approx_operator(const OperatorArgs& args, ExecutionContext& ctx) -> EvaluationResult {
     if (args.size() != 3) {
         throw InvalidArgumentException("'approx' requires exactly 3 arguments (a, b, tolerance)",
                                        ctx.get_path_string());
@@ -0,0 +1,182 @@
+#include <optimizer.hpp>
+#include <optional>
+#include <set>
+
+namespace computo {
+
+namespace {
+
+// Operators whose value depends only on their arguments. Variable and input
+// access, binding forms and the lambda-taking array operators are excluded.
+auto is_pure_operator(const std::string& name) -> bool {
+    static const std::set<std::string> pure = {
+        "+",      "-",         "*",        "/",       "%",            ">",
+        "<",      ">=",        "<=",       "==",      "!=",           "and",
+        "or",     "not",       "if",       "obj",     "keys",         "values",
+        "objFromPairs", "pick", "omit",    "merge",   "count",        "car",
+        "cdr",    "cons",      "append",   "join",    "strConcat",    "sort",
+        "reverse", "unique",   "uniqueSorted", "zip", "approx"};
+    return pure.count(name) > 0;
+}
+
+// Operators whose arguments after the first are configuration (sort field
+// descriptors, uniqueSorted modes) rather than expressions
+auto takes_literal_options(const std::string& name) -> bool {
+    return name == "sort" || name == "uniqueSorted";
+}
+
+class ConstantFolder {
+public:
+    explicit ConstantFolder(const std::string& array_key) : array_key_(array_key) {}
+
+    struct Folded {
+        jsom::JsonDocument expr;                // Rewritten expression
+        std::optional<jsom::JsonDocument> value; // Its value, if constant
+        std::size_t evaluated_nodes{0};          // Nodes left to evaluate in expr
+    };
+
+    // NOLINTBEGIN(readability-function-size)
+    auto fold(const jsom::JsonDocument& expr) -> Folded {
+        if (!expr.is_array()) {
+            if (expr.is_object() && expr.size() == 1 && expr.contains(array_key_)) {
+                if (expr[array_key_].is_array()) {
+                    return {expr, expr[array_key_], 0};
+                }
+                return {expr, std::nullopt, 0}; // Malformed wrapper: an error at run time
+            }
+            return {expr, expr, 0}; // Scalars and objects are literal
+        }
+        if (expr.empty()) {
+            return {expr, expr, 0};
+        }
+
+        // Rule 3: a literal array is constant when all of its elements are
+        if (!expr[0].is_string()) {
+            Folded result{jsom::JsonDocument::make_array(), jsom::JsonDocument::make_array(), 1};
+            for (const auto& element : expr) {
+                auto folded = fold(element);
+                result.evaluated_nodes += folded.evaluated_nodes;
+                if (result.value && folded.value) {
+                    result.value->push_back(std::move(*folded.value));
+                } else {
+                    result.value.reset();
+                }
+                result.expr.push_back(std::move(folded.expr));
+            }
+            return replace_if_constant(std::move(result));
+        }
+
+        auto name = expr[0].as<std::string>();
+        Folded result{jsom::JsonDocument::make_array(), std::nullopt, 1};
+        result.expr.push_back(expr[0]);
+        bool constant_args = true;
+        auto fold_arg = [&](const jsom::JsonDocument& arg) {
+            auto folded = fold(arg);
+            constant_args = constant_args && folded.value.has_value();
+            result.evaluated_nodes += folded.evaluated_nodes;
+            result.expr.push_back(std::move(folded.expr));
+        };
+
+        if (name == "let" && expr.size() == 3) {
+            result.expr.push_back(fold_let_bindings(expr[1], result.evaluated_nodes));
+            fold_arg(expr[2]);
+            return result;
+        }
+        if (name == "lambda" && expr.size() == 3) {
+            result.expr.push_back(expr[1]); // Parameter names
+            fold_arg(expr[2]);
+            return result;
+        }
+        if (name == "$" || name == "$input" || name == "$inputs") {
+            return {expr, std::nullopt, 1}; // Arguments are JSON Pointer strings
+        }
+
+        for (size_t i = 1; i < expr.size(); ++i) {
+            if (i > 1 && takes_literal_options(name)) {
+                result.expr.push_back(expr[i]);
+            } else {
+                fold_arg(expr[i]);
+            }
+        }
+        if (constant_args && is_pure_operator(name)) {
+            result.value = evaluate_constant(result.expr);
+        }
+        return replace_if_constant(std::move(result));
+    }
+    // NOLINTEND(readability-function-size)
+
+    [[nodiscard]] auto folded_nodes() const -> std::size_t { return folded_nodes_; }
+
+private:
+    const std::string& array_key_;
+    std::size_t folded_nodes_{0};
+
+    // Binding values are expressions; names and the binding structure are not
+    auto fold_let_bindings(const jsom::JsonDocument& bindings, std::size_t& evaluated_nodes)
+        -> jsom::JsonDocument {
+        if (bindings.is_object()) {
+            auto result = jsom::JsonDocument::make_object();
+            for (const auto& [key, value] : bindings.items()) {
+                auto folded = fold(value);
+                evaluated_nodes += folded.evaluated_nodes;
+                result.set(key, std::move(folded.expr));
+            }
+            return result;
+        }
+        if (!bindings.is_array()) {
+            return bindings;
+        }
+        auto result = jsom::JsonDocument::make_array();
+        for (const auto& binding : bindings) {
+            if (!binding.is_array() || binding.size() != 2 || !binding[0].is_string()) {
+                return bindings; // Reported by let at run time
+            }
+            auto folded = fold(binding[1]);
+            evaluated_nodes += folded.evaluated_nodes;
+            auto pair = jsom::JsonDocument::make_array();
+            pair.push_back(binding[0]);
+            pair.push_back(std::move(folded.expr));
+            result.push_back(std::move(pair));
+        }
+        return result;
+    }
+
+    // Runs a constant expression once; errors are left for run time
+    auto evaluate_constant(const jsom::JsonDocument& expr) const
+        -> std::optional<jsom::JsonDocument> {
+        try {
+            return execute(expr, {}, nullptr, array_key_);
+        } catch (const ComputoException&) {
+            return std::nullopt;
+        }
+    }
+
+    // Swaps a constant expression for a literal of its value, where one exists
+    auto replace_if_constant(Folded folded) -> Folded {
+        if (!folded.value) {
+            return folded;
+        }
+        const auto& value = *folded.value;
+        if (value.is_array()) {
+            folded.expr = jsom::JsonDocument{{array_key_, value}};
+        } else if (value.is_object() && value.size() == 1 && value.contains(array_key_)) {
+            return folded; // Would be unwrapped if written as a literal
+        } else {
+            folded.expr = value;
+        }
+        folded_nodes_ += folded.evaluated_nodes;
+        folded.evaluated_nodes = 0;
+        return folded;
+    }
+};
+
+} // namespace
+
+auto fold_constants(const jsom::JsonDocument& script, const std::string& array_key)
+    -> FoldedScript {
+    ConstantFolder folder(array_key);
+    auto folded = folder.fold(script);
+    return {std::move(folded.expr), folder.folded_nodes()};
+}
+
+} // namespace computo
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <computo.hpp>
+#include <string>
+
+namespace computo {
+
+// --- Script Optimization Passes ---
+
+/**
+ * A script rewritten by fold_constants()
+ */
+struct FoldedScript {
+    jsom::JsonDocument script;
+    std::size_t folded_nodes{0}; // Operator calls and literal arrays no longer evaluated
+};
+
+/**
+ * Pre-evaluate constant subtrees of a script
+ *
+ * Calls to pure operators whose arguments are all literals (after folding
+ * their own arguments), and Rule 3 literal arrays of literals, are replaced by
+ * a literal of their value: scalars and objects as themselves, arrays wrapped
+ * as {array_key: [...]}. Values that cannot be written as a literal (a single
+ * array_key member object) and subtrees that would throw are left as they are,
+ * so run-time results and errors do not change.
+ *
+ * @param script The script to fold (not modified)
+ * @param array_key The array wrapper key the script will run with
+ */
+auto fold_constants(const jsom::JsonDocument& script, const std::string& array_key) -> FoldedScript;
+
+} // namespace computo
@@ -0,0 +1,500 @@
+#include "program.hpp"
+#include <algorithm>
+#include <bytecode.hpp>
+#include <optimizer.hpp>
+#include <set>
+#include <thread>
+#include <thread_pool.hpp>
+
+namespace computo {
+
+namespace {
+
+// Names bound by one let or inline lambda frame, in slot order. A null scope
+// means nothing is known statically (the top level, or the body of a lambda
+// value that may be called from anywhere) and lookups happen at run time.
+struct StaticScope {
+    const StaticScope* parent{nullptr};
+    std::vector<std::string> names;
+};
+
+auto resolve_slot(const StaticScope* scope, const std::string& name) -> std::optional<VariableSlot> {
+    for (std::uint32_t hops = 0; scope != nullptr; scope = scope->parent, ++hops) {
+        // Search backwards: a repeated name binds its last occurrence
+        for (auto slot = scope->names.size(); slot > 0; --slot) {
+            if (scope->names[slot - 1] == name) {
+                return VariableSlot{hops, static_cast<std::uint32_t>(slot - 1)};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+// Names of a let binding list, in the order let_operator binds them
+auto let_binding_names(const jsom::JsonDocument& bindings) -> std::vector<std::string> {
+    std::vector<std::string> names;
+    if (bindings.is_object()) {
+        for (const auto& [key, value] : bindings.items()) {
+            names.push_back(key);
+        }
+    } else if (bindings.is_array()) {
+        for (const auto& binding : bindings) {
+            if (binding.is_array() && binding.size() == 2 && binding[0].is_string()) {
+                names.push_back(binding[0].as<std::string>());
+            }
+        }
+    }
+    return names;
+}
+
+// A ["lambda", params, body] literal that resolve_lambda() invokes in place
+auto is_inline_lambda(const jsom::JsonDocument& expr) -> bool {
+    if (!expr.is_array() || expr.size() != 3 || !expr[0].is_string()
+        || expr[0].as<std::string>() != "lambda" || !expr[1].is_array()) {
+        return false;
+    }
+    for (const auto& param : expr[1]) {
+        if (!param.is_string()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Operators whose second argument is a lambda called with frames parented to
+// the operator's own scope
+auto takes_inline_lambda(const std::string& name) -> bool {
+    return name == "map" || name == "filter" || name == "reduce" || name == "find"
+           || name == "some" || name == "every";
+}
+
+// Lowers one expression into program.nodes and returns its node. Mirrors the
+// classification in evaluate_internal(): array objects, literal arrays
+// (Rule 3) and operator calls; everything else is a literal. lambda_scope is
+// the frame a ["lambda", ...] expression's body will run in, if known.
+// NOLINTBEGIN(readability-function-size)
+auto lower_expression(const jsom::JsonDocument& expr, CompiledProgram& program,
+                      const StaticScope* scope, const StaticScope* lambda_scope = nullptr)
+    -> CompiledNode& {
+    auto& node = program.nodes.emplace_back();
+    node.expression = &expr;
+    node.literal = &expr;
+    program.index.emplace(&expr, &node);
+
+    if (!expr.is_array()) {
+        if (expr.is_object() && expr.size() == 1 && expr.contains(program.array_key)) {
+            if (expr[program.array_key].is_array()) {
+                node.literal = &expr[program.array_key];
+            } else {
+                node.kind = NodeKind::ArrayObject;
+            }
+        } else if (expr.is_object()) {
+            // Object members are not evaluated by default, but let bindings are.
+            // Members are indexed by their address in expr: items() may hand
+            // out copies, so only its keys are used.
+            for (const auto& [key, value] : expr.items()) {
+                lower_expression(expr[key], program, scope);
+            }
+        }
+        return node;
+    }
+
+    if (expr.empty()) {
+        return node; // Rule 3: empty arrays are literal
+    }
+
+    if (!expr[0].is_string()) {
+        node.kind = NodeKind::LiteralArray;
+        node.children.reserve(expr.size());
+        for (const auto& element : expr) {
+            node.children.push_back(&lower_expression(element, program, scope));
+        }
+        return node;
+    }
+
+    node.kind = NodeKind::OperatorCall;
+    node.operator_name = expr[0].as<std::string>();
+    node.opcode = OperatorRegistry::get_instance().find_opcode(node.operator_name);
+
+    // ["$", "/name/sub/path"]: a slot load when the binding is lexically visible
+    if (node.operator_name == "$" && node.opcode && expr.size() == 2 && expr[1].is_string()) {
+        auto pointer = expr[1].as<std::string>();
+        if (!pointer.empty() && pointer[0] == '/') {
+            node.kind = NodeKind::VariableLoad;
+            node.variable = parse_variable_path(pointer);
+            node.variable_slot = resolve_slot(scope, node.variable.variable_name);
+            if (node.variable_slot) {
+                ++program.resolved_variables;
+            }
+        }
+    }
+
+    // Scopes introduced by this call for its body argument (expr[2])
+    StaticScope body_scope{scope, {}};
+    const StaticScope* body_lambda_scope = nullptr;
+    if (node.operator_name == "let" && expr.size() == 3) {
+        body_scope.names = let_binding_names(expr[1]);
+    } else if (takes_inline_lambda(node.operator_name) && expr.size() >= 3
+               && is_inline_lambda(expr[2])) {
+        for (const auto& param : expr[2][1]) {
+            body_scope.names.push_back(param.as<std::string>());
+        }
+        body_lambda_scope = &body_scope;
+    }
+
+    node.children.reserve(expr.size() - 1);
+    for (size_t i = 1; i < expr.size(); ++i) {
+        const StaticScope* child_scope = scope;
+        const StaticScope* child_lambda_scope = nullptr;
+        if (i == 2 && node.operator_name == "let") {
+            child_scope = &body_scope;
+        } else if (i == 2 && node.operator_name == "lambda") {
+            child_scope = lambda_scope; // Unknown (null) unless invoked in place
+        } else if (i == 2) {
+            child_lambda_scope = body_lambda_scope;
+        }
+        node.children.push_back(
+            &lower_expression(expr[i], program, child_scope, child_lambda_scope));
+    }
+    return node;
+}
+// NOLINTEND(readability-function-size)
+
+// Variables an expression reads from the scopes around it. dynamic is set when
+// that is not known statically: a lambda value invoked by an array operator
+// sees whatever its caller has bound.
+struct FreeVariables {
+    std::set<std::string> names;
+    bool dynamic{false};
+
+    void add(const FreeVariables& other, const std::vector<std::string>& bound = {}) {
+        for (const auto& name : other.names) {
+            if (std::find(bound.begin(), bound.end(), name) == bound.end()) {
+                names.insert(name);
+            }
+        }
+        dynamic = dynamic || other.dynamic;
+    }
+};
+
+// Finds lambda body nodes that do not depend on the lambda's parameters and
+// marks each with the outermost loop call it is invariant in (see
+// HoistedValues). Walks the script the way the evaluator does: let binding
+// values in the outer scope, inline lambda bodies below their parameters.
+class LoopInvariantAnalysis {
+public:
+    explicit LoopInvariantAnalysis(CompiledProgram& program) : program_(program) {}
+
+    void run() {
+        (void)analyze(program_.script);
+        for (const auto& candidate : candidates_) {
+            candidate.node->hoisted_in = candidate.loop;
+            candidate.node->hoist_slot = candidate.loop->hoisted_count++;
+        }
+        program_.hoisted_nodes = candidates_.size();
+    }
+
+private:
+    struct ActiveLoop {
+        CompiledNode* node;
+        std::size_t bound_mark; // bound_ size when its lambda body was entered
+    };
+    struct Candidate {
+        CompiledNode* node;
+        CompiledNode* loop;
+        std::size_t depth; // Index of loop in loops_
+    };
+
+    CompiledProgram& program_;
+    std::vector<ActiveLoop> loops_;
+    std::vector<std::string> bound_; // Names bound between the outermost loop and here
+    std::vector<Candidate> candidates_;
+
+    // Nodes worth caching: ones that compute something each time they run
+    static auto is_hoistable(const CompiledNode& node) -> bool {
+        return (node.kind == NodeKind::OperatorCall && node.operator_name != "lambda")
+               || (node.kind == NodeKind::VariableLoad && !node.variable.sub_path.empty())
+               || node.kind == NodeKind::LiteralArray;
+    }
+
+    auto analyze_scoped(const jsom::JsonDocument& body, const std::vector<std::string>& names)
+        -> FreeVariables {
+        bound_.insert(bound_.end(), names.begin(), names.end());
+        auto body_variables = analyze(body);
+        bound_.resize(bound_.size() - names.size());
+        FreeVariables result;
+        result.add(body_variables, names);
+        return result;
+    }
+
+    // NOLINTBEGIN(readability-function-size)
+    auto analyze(const jsom::JsonDocument& expr) -> FreeVariables {
+        FreeVariables result;
+        auto* node = program_.index.at(&expr);
+        if (node->kind == NodeKind::Literal || node->kind == NodeKind::ArrayObject) {
+            return result; // Object members are only evaluated as let bindings
+        }
+
+        auto first_candidate = candidates_.size();
+        if (node->kind == NodeKind::LiteralArray) {
+            for (const auto& element : expr) {
+                result.add(analyze(element));
+            }
+        } else if (node->kind == NodeKind::VariableLoad) {
+            result.names.insert(node->variable.variable_name);
+        } else if (node->operator_name == "$") {
+            result.dynamic = true; // Malformed; reported at run time
+        } else if (node->operator_name == "lambda") {
+            // A value: its body runs wherever it is invoked
+        } else if (node->operator_name == "let" && expr.size() == 3) {
+            if (expr[1].is_object()) {
+                for (const auto& [key, value] : expr[1].items()) {
+                    result.add(analyze(expr[1][key])); // The indexed member, not a copy
+                }
+            } else if (expr[1].is_array()) {
+                for (const auto& binding : expr[1]) {
+                    if (binding.is_array() && binding.size() == 2) {
+                        result.add(analyze(binding[1]));
+                    }
+                }
+            }
+            result.add(analyze_scoped(expr[2], let_binding_names(expr[1])));
+        } else if (takes_inline_lambda(node->operator_name) && expr.size() >= 3) {
+            for (size_t i = 1; i < expr.size(); ++i) {
+                if (i != 2) {
+                    result.add(analyze(expr[i]));
+                }
+            }
+            if (is_inline_lambda(expr[2])) {
+                std::vector<std::string> params;
+                for (const auto& param : expr[2][1]) {
+                    params.push_back(param.as<std::string>());
+                }
+                loops_.push_back({node, bound_.size()});
+                result.add(analyze_scoped(expr[2][2], params));
+                loops_.pop_back();
+            } else {
+                result.add(analyze(expr[2]));
+                result.dynamic = true;
+            }
+        } else if ((node->operator_name == "sort" || node->operator_name == "uniqueSorted")
+                   && expr.size() >= 2) {
+            result.add(analyze(expr[1])); // Later arguments are options, not expressions
+        } else {
+            for (size_t i = 1; i < expr.size(); ++i) {
+                result.add(analyze(expr[i]));
+            }
+        }
+
+        if (!result.dynamic && is_hoistable(*node)) {
+            consider(*node, result, first_candidate);
+        }
+        return result;
+    }
+    // NOLINTEND(readability-function-size)
+
+    // Hoists node to the outermost enclosing loop none of whose bindings it reads
+    void consider(CompiledNode& node, const FreeVariables& variables, std::size_t first_candidate) {
+        for (std::size_t depth = 0; depth < loops_.size(); ++depth) {
+            bool invariant = std::none_of(
+                bound_.begin() + static_cast<std::ptrdiff_t>(loops_[depth].bound_mark),
+                bound_.end(), [&](const std::string& name) { return variables.names.count(name) > 0; });
+            if (!invariant) {
+                continue;
+            }
+            // Descendants hoisted no further out than this node now run once
+            // per node evaluation anyway
+            auto redundant = [&](const Candidate& candidate) {
+                return candidate.depth >= depth && candidate.depth < loops_.size();
+            };
+            candidates_.erase(std::remove_if(candidates_.begin()
+                                                 + static_cast<std::ptrdiff_t>(first_candidate),
+                                             candidates_.end(), redundant),
+                              candidates_.end());
+            candidates_.push_back({&node, loops_[depth].node, depth});
+            return;
+        }
+    }
+};
+
+// Records the input parts read by every $input / $inputs call in expr. Walks
+// the whole script, literal data included, so a lambda value built from
+// literals is covered too; only literal pointers narrow what is read.
+void collect_input_access(const jsom::JsonDocument& expr, InputAccess& access) {
+    if (expr.is_object()) {
+        for (const auto& [key, value] : expr.items()) {
+            collect_input_access(expr[key], access);
+        }
+        return;
+    }
+    if (!expr.is_array()) {
+        return;
+    }
+    for (const auto& element : expr) {
+        collect_input_access(element, access);
+    }
+    if (expr.empty() || !expr[0].is_string()) {
+        return;
+    }
+
+    auto name = expr[0].as<std::string>();
+    bool literal_pointer = expr.size() == 2 && expr[1].is_string();
+    auto pointer = literal_pointer ? expr[1].as<std::string>() : std::string();
+    if (name == "$input") {
+        if (!literal_pointer) {
+            access.pointers[0].emplace_back(); // Whole input, or a computed pointer
+        } else if (!pointer.empty() && pointer[0] == '/') {
+            access.pointers[0].push_back(pointer);
+        }
+    } else if (name == "$inputs") {
+        if (!literal_pointer) {
+            access.all_inputs = true;
+            return;
+        }
+        if (pointer.empty() || pointer[0] != '/') {
+            return; // Rejected before any input is read
+        }
+        auto end = pointer.find('/', 1);
+        auto index = parse_array_index(
+            std::string_view(pointer).substr(1, end == std::string::npos ? end : end - 1));
+        if (!index) {
+            access.all_inputs = true;
+        } else {
+            access.pointers[*index].push_back(end == std::string::npos ? std::string()
+                                                                       : pointer.substr(end));
+        }
+    }
+}
+
+} // namespace
+
+auto InputAccess::reads_whole(std::size_t input) const -> bool {
+    if (all_inputs) {
+        return true;
+    }
+    auto iter = pointers.find(input);
+    return iter != pointers.end()
+           && std::find(iter->second.begin(), iter->second.end(), "") != iter->second.end();
+}
+
+auto compile(const jsom::JsonDocument& script, std::string array_key, Backend backend)
+    -> Program {
+    auto impl = std::make_shared<CompiledProgram>();
+    auto folded = fold_constants(script, array_key);
+    impl->script = std::move(folded.script);
+    impl->folded_nodes = folded.folded_nodes;
+    impl->array_key = std::move(array_key);
+    impl->backend = backend;
+
+    lower_expression(impl->script, *impl, nullptr);
+    LoopInvariantAnalysis(*impl).run();
+    if (backend == Backend::Bytecode) {
+        impl->bytecode = std::make_shared<const BytecodeProgram>(generate_bytecode(*impl));
+    }
+
+    Program program;
+    program.impl_ = std::move(impl);
+    return program;
+}
+
+auto Program::run(const std::vector<jsom::JsonDocument>& inputs, DebugContext* debug_context,
+                  const ParallelOptions& parallel) const -> jsom::JsonDocument {
+    return run(std::vector<jsom::JsonDocument>(inputs), debug_context, parallel);
+}
+
+auto Program::run(std::vector<jsom::JsonDocument>&& inputs, DebugContext* debug_context,
+                  const ParallelOptions& parallel) const -> jsom::JsonDocument {
+    if (!impl_) {
+        throw ComputoException("Program has not been compiled");
+    }
+    ExecutionContext ctx(std::make_shared<const std::vector<jsom::JsonDocument>>(std::move(inputs)),
+                         impl_->array_key);
+    auto program_ctx = ctx.with_program(impl_.get()).with_parallel(&parallel);
+    bool debugging = debug_context != nullptr && debug_context->is_debug_enabled();
+    if (impl_->bytecode && !debugging) {
+        return run_bytecode(*impl_->bytecode, program_ctx);
+    }
+    return evaluate(impl_->script, program_ctx, debug_context);
+}
+
+auto Program::run_batch(const std::vector<jsom::JsonDocument>& inputs,
+                        const BatchOptions& options) const -> std::vector<BatchResult> {
+    // Copied one at a time, so only the documents in flight exist twice
+    return run_batch(inputs.size(), options, [&](std::size_t i) { return inputs[i]; });
+}
+
+auto Program::run_batch(std::vector<jsom::JsonDocument>&& inputs, const BatchOptions& options) const
+    -> std::vector<BatchResult> {
+    return run_batch(inputs.size(), options, [&](std::size_t i) { return std::move(inputs[i]); });
+}
+
+auto Program::run_batch(std::size_t count, const BatchOptions& options,
+                        const std::function<jsom::JsonDocument(std::size_t)>& input) const
+    -> std::vector<BatchResult> {
+    if (!impl_) {
+        throw ComputoException("Program has not been compiled");
+    }
+    auto threads = options.threads;
+    if (threads == 0) {
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    auto chunk_size = options.chunk_size;
+    if (chunk_size == 0) {
+        // Several chunks per thread, so a run of slow documents evens out
+        chunk_size = std::max<std::size_t>(count / (threads * 8), 1);
+    }
+
+    std::vector<BatchResult> results(count);
+    thread_pool::parallel_for(count, chunk_size, threads, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            try {
+                std::vector<jsom::JsonDocument> single;
+                single.push_back(input(i));
+                results[i].value = run(std::move(single), nullptr, options.parallel);
+            } catch (...) {
+                results[i].error = std::current_exception();
+            }
+        }
+    });
+    return results;
+}
+
+auto Program::script() const -> const jsom::JsonDocument& {
+    static const jsom::JsonDocument empty_script;
+    return impl_ ? impl_->script : empty_script;
+}
+
+auto Program::array_key() const -> const std::string& {
+    static const std::string default_array_key = "array";
+    return impl_ ? impl_->array_key : default_array_key;
+}
+
+auto Program::node_count() const -> std::size_t { return impl_ ? impl_->nodes.size() : 0; }
+
+auto Program::backend() const -> Backend { return impl_ ? impl_->backend : Backend::Tree; }
+
+auto Program::stats() const -> ProgramStats {
+    ProgramStats stats;
+    if (!impl_) {
+        return stats;
+    }
+    stats.nodes = impl_->nodes.size();
+    stats.folded_nodes = impl_->folded_nodes;
+    stats.hoisted_nodes = impl_->hoisted_nodes;
+    stats.resolved_variables = impl_->resolved_variables;
+    if (impl_->bytecode) {
+        stats.bytecode_instructions = impl_->bytecode->code.size();
+        stats.bytecode_fallbacks = impl_->bytecode->fallbacks;
+    }
+    return stats;
+}
+
+auto Program::input_access() const -> InputAccess {
+    InputAccess access;
+    if (impl_) {
+        collect_input_access(impl_->script, access);
+    }
+    return access;
+}
+
+} // namespace computo
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <computo.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <operators/shared.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace computo {
+
+// --- Compiled Program Representation ---
+
+/**
+ * Classification of a script node, decided once when the script is compiled
+ */
+enum class NodeKind : std::uint8_t {
+    Literal,      // Scalars, objects and unwrapped {"array": [...]} values
+    ArrayObject,  // Malformed {"array": ...} wrapper, reported when evaluated
+    LiteralArray, // Rule 3 arrays whose elements are evaluated
+    OperatorCall, // ["op", args...] with the operator resolved ahead of time
+    VariableLoad  // ["$", "/name..."], resolved to a frame slot where possible
+};
+
+/**
+ * Position of a let or lambda binding relative to the innermost frame
+ * hops counts parent links to follow; slot is the binding's index in that frame
+ */
+struct VariableSlot {
+    std::uint32_t hops{0};
+    std::uint32_t slot{0};
+};
+
+/**
+ * A single node of the compiled script tree
+ *
+ * Nodes are owned by a CompiledProgram and never move once created, so tail
+ * calls can refer to them by address for the lifetime of the program.
+ */
+struct CompiledNode {
+    NodeKind kind{NodeKind::Literal};
+    const jsom::JsonDocument* expression{nullptr}; // Source expression (for debugging and errors)
+    const jsom::JsonDocument* literal{nullptr};    // Value returned by Literal nodes
+    std::string operator_name;                     // OperatorCall only (debugging, errors)
+    std::optional<OpCode> opcode;                  // Empty for unknown operators
+    std::vector<const CompiledNode*> children;     // Argument or element nodes, in order
+    VariablePathParts variable;                    // VariableLoad only
+    std::optional<VariableSlot> variable_slot;     // Empty when only known at run time
+    const CompiledNode* hoisted_in{nullptr};       // Loop call this node is invariant in
+    std::uint32_t hoist_slot{0};                   // Its index in that call's HoistedValues
+    std::uint32_t hoisted_count{0};                // Loop calls: invariant body nodes
+};
+
+/**
+ * The cached value of one loop-invariant node in one loop call
+ *
+ * Chunks of a parallel map or filter that reach an empty slot at the same time
+ * each evaluate the node, without holding any lock; the first to finish
+ * publishes its value and the others adopt it.
+ */
+struct HoistedSlot {
+    std::atomic<const jsom::JsonDocument*> ready{nullptr}; // &*value once published
+    std::optional<jsom::JsonDocument> value;
+    std::mutex publish; // Held only to store value
+};
+
+/**
+ * Values of the loop-invariant nodes of one map, filter, reduce, find, some or
+ * every call with an inline lambda
+ *
+ * A node with hoisted_in set does not depend on the lambda's parameters or on
+ * anything bound between them and the node, so it is evaluated the first time
+ * the lambda reaches it and reused for every later element. Lives on the stack
+ * of the loop call; contexts inside the call link to it.
+ */
+struct HoistedValues {
+    const CompiledNode* loop{nullptr};
+    HoistedValues* parent{nullptr};      // Enclosing loop call, if any
+    std::unique_ptr<HoistedSlot[]> slots; // Indexed by hoist_slot
+};
+
+struct BytecodeProgram; // See bytecode.hpp
+
+/**
+ * Storage behind a computo::Program
+ *
+ * The index maps every subtree of the owned script to its compiled node.
+ * Operators receive views into that script, so whatever they hand back to
+ * evaluate() (arguments, lambda bodies, let bindings) resolves to a node.
+ */
+struct CompiledProgram {
+    jsom::JsonDocument script; // After constant folding
+    std::string array_key;
+    std::deque<CompiledNode> nodes; // nodes.front() is the root
+    std::unordered_map<const jsom::JsonDocument*, CompiledNode*> index;
+    std::size_t folded_nodes{0};       // Constant subtrees replaced by their value
+    std::size_t hoisted_nodes{0};      // Loop-invariant lambda body nodes
+    std::size_t resolved_variables{0}; // VariableLoad nodes with a static slot
+    Backend backend{Backend::Tree};
+    std::shared_ptr<const BytecodeProgram> bytecode; // Set for Backend::Bytecode
+
+    [[nodiscard]] auto find_node(const jsom::JsonDocument& expr) const -> const CompiledNode* {
+        auto iter = index.find(&expr);
+        return iter == index.end() ? nullptr : iter->second;
+    }
+};
+
+/**
+ * Evaluate a compiled node without re-classifying its expression
+ * Returns tail calls exactly like evaluate_internal()
+ */
+auto evaluate_compiled(const CompiledNode& node, const ExecutionContext& ctx,
+                       DebugContext* debug_ctx = nullptr) -> EvaluationResult;
+
+/**
+ * Binding of a VariableLoad node's variable: its frame slot if that still
+ * matches, otherwise a lookup by name
+ *
+ * @return The bound value, or nullptr if the variable is not in scope
+ */
+auto find_compiled_binding(const CompiledNode& node, const ExecutionContext& ctx)
+    -> const SharedJson*;
+
+/**
+ * Value of a VariableLoad node (see find_compiled_binding())
+ */
+auto load_compiled_variable(const CompiledNode& node, const ExecutionContext& ctx)
+    -> jsom::JsonDocument;
+
+/**
+ * Cached value of a hoisted node, evaluated first if this is the loop call's
+ * first use of it
+ *
+ * @return The value, owned by the running loop call; nullptr if the node is
+ *         not hoisted or its loop is not running on the tree
+ */
+auto hoisted_value(const CompiledNode& node, const ExecutionContext& ctx,
+                   DebugContext* debug_ctx = nullptr) -> const jsom::JsonDocument*;
+
+} // namespace computo
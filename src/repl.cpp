@@ -1,10 +1,16 @@
 #include "repl.hpp"
+#include "lazy_input.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
 #include <computo.hpp>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -18,12 +24,9 @@ namespace computo {
 // --- File Utilities (used by REPL) ---
 
 auto load_json_file(const std::string& filename, bool enable_comments) -> jsom::JsonDocument {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file: " + filename);
-    }
-
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    // Parsed straight from the mapped file, without a copy of its bytes
+    MappedFile file(filename);
+    auto content = file.view();
 
     try {
         if (enable_comments) {
@@ -36,15 +39,45 @@ auto load_json_file(const std::string& filename, bool enable_comments) -> jsom::
     }
 }
 
-auto load_input_files(const std::vector<std::string>& filenames, bool enable_comments)
-    -> std::vector<jsom::JsonDocument> {
-    std::vector<jsom::JsonDocument> inputs;
-    inputs.reserve(filenames.size());
-
-    for (const auto& filename : filenames) {
-        inputs.push_back(load_json_file(filename, enable_comments));
+auto load_input_files(const std::vector<std::string>& filenames, bool enable_comments,
+                      const InputAccess* access) -> std::vector<jsom::JsonDocument> {
+    std::vector<jsom::JsonDocument> inputs(filenames.size());
+    // The structural scan behind parse_selected() only reads plain JSON
+    bool selective = access != nullptr && !access->all_inputs && !enable_comments;
+    std::atomic<bool> reload_whole{false};
+
+    auto load = [&](std::size_t i) {
+        if (!selective || access->reads_whole(i)) {
+            inputs[i] = load_json_file(filenames[i], enable_comments);
+            return;
+        }
+        static const std::vector<std::string> no_pointers;
+        auto pointers = access->pointers.find(i);
+        MappedFile file(filenames[i]);
+        auto selected = parse_selected(
+            file.view(), pointers == access->pointers.end() ? no_pointers : pointers->second);
+        if (selected) {
+            inputs[i] = std::move(*selected);
+        } else {
+            // Reports a parse error; otherwise the file may hold code reading other inputs
+            inputs[i] = load_json_file(filenames[i], enable_comments);
+            reload_whole = true;
+        }
+    };
+
+    // One file per task on the shared pool; each result lands in its own slot,
+    // and a failure reports the first failing file, as a sequential loop would
+    auto threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    thread_pool::parallel_for(filenames.size(), 1, threads,
+                              [&](std::size_t begin, std::size_t end) {
+                                  for (auto i = begin; i < end; ++i) {
+                                      load(i);
+                                  }
+                              });
+
+    if (reload_whole) {
+        return load_input_files(filenames, enable_comments, nullptr);
     }
-
     return inputs;
 }
 
@@ -495,7 +528,7 @@ auto run_repl_mode(const ComputoArgs& args) -> int {
         ReplState state;
         state.args = &args;
         // Load input files if provided
-        state.inputs = load_input_files(args.input_files, args.enable_comments);
+        state.inputs = load_input_files(args.input_files, args.enable_comments, nullptr);
         if (!args.input_files.empty()) {
             std::cout << "Loaded " << state.inputs.size() << " input file(s)\n";
         }
@@ -0,0 +1,270 @@
+#include "script_cache.hpp"
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace computo {
+
+namespace {
+
+constexpr std::string_view MAGIC = "COMPUTOC";
+constexpr std::size_t HEADER_SIZE = 24; // Magic, version, array key, record and string counts
+constexpr std::size_t RECORD_SIZE = 16; // Tag, 3 bytes padding, key, value
+constexpr std::uint32_t NO_KEY = std::numeric_limits<std::uint32_t>::max();
+
+enum class RecordTag : std::uint8_t {
+    Null,
+    False,
+    True,
+    Number, // value: string index of the number's text
+    String, // value: string index
+    Array,  // value: element count; the elements follow
+    Object  // value: member count; the members follow, each with its key
+};
+
+void put_u32(std::string& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFFU));
+    }
+}
+
+void put_u64(std::string& out, std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFFU));
+    }
+}
+
+auto get_u32(std::string_view bytes, std::size_t offset) -> std::uint32_t {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[offset + i]))
+                 << (8 * i);
+    }
+    return value;
+}
+
+auto get_u64(std::string_view bytes, std::size_t offset) -> std::uint64_t {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[offset + i]))
+                 << (8 * i);
+    }
+    return value;
+}
+
+auto damaged(const std::string& reason) -> std::runtime_error {
+    return std::runtime_error("Invalid compiled script: " + reason);
+}
+
+struct Record {
+    RecordTag tag;
+    std::uint32_t key;
+    std::uint64_t value;
+};
+
+// Flattens a script into pre-order records over a table of interned strings
+class Encoder {
+public:
+    auto intern(const std::string& text) -> std::uint32_t {
+        auto id = static_cast<std::uint32_t>(strings_.size());
+        auto [iter, inserted] = ids_.try_emplace(text, id);
+        if (inserted) {
+            strings_.push_back(&iter->first);
+        }
+        return iter->second;
+    }
+
+    void add(const jsom::JsonDocument& value, std::uint32_t key, std::size_t depth = 0) {
+        if ((value.is_array() || value.is_object()) && depth >= SCRIPT_CACHE_MAX_DEPTH) {
+            throw std::runtime_error("Script nests deeper than "
+                                     + std::to_string(SCRIPT_CACHE_MAX_DEPTH)
+                                     + " levels and cannot be compiled");
+        }
+        if (value.is_array()) {
+            records_.push_back({RecordTag::Array, key, static_cast<std::uint64_t>(value.size())});
+            for (const auto& element : value) {
+                add(element, NO_KEY, depth + 1);
+            }
+        } else if (value.is_object()) {
+            records_.push_back({RecordTag::Object, key, static_cast<std::uint64_t>(value.size())});
+            for (const auto& [name, member] : value.items()) {
+                add(member, intern(std::string(name)), depth + 1);
+            }
+        } else if (value.is_string()) {
+            records_.push_back({RecordTag::String, key, intern(value.as<std::string>())});
+        } else if (value.is_number()) {
+            records_.push_back({RecordTag::Number, key, intern(value.to_json())});
+        } else if (value.is_bool()) {
+            records_.push_back({value.as<bool>() ? RecordTag::True : RecordTag::False, key, 0});
+        } else {
+            records_.push_back({RecordTag::Null, key, 0});
+        }
+    }
+
+    [[nodiscard]] auto finish(std::uint32_t array_key) const -> std::string {
+        std::string out(MAGIC);
+        put_u32(out, SCRIPT_CACHE_VERSION);
+        put_u32(out, array_key);
+        put_u32(out, static_cast<std::uint32_t>(records_.size()));
+        put_u32(out, static_cast<std::uint32_t>(strings_.size()));
+        for (const auto& record : records_) {
+            out.push_back(static_cast<char>(record.tag));
+            out.append(3, '\0');
+            put_u32(out, record.key);
+            put_u64(out, record.value);
+        }
+        std::uint32_t offset = 0;
+        put_u32(out, offset);
+        for (const auto* text : strings_) {
+            offset += static_cast<std::uint32_t>(text->size());
+            put_u32(out, offset);
+        }
+        for (const auto* text : strings_) {
+            out += *text;
+        }
+        return out;
+    }
+
+private:
+    std::unordered_map<std::string, std::uint32_t> ids_;
+    std::vector<const std::string*> strings_; // Keys of ids_, in index order
+    std::vector<Record> records_;
+};
+
+// Rebuilds values straight from the records, checking every index and count
+class Decoder {
+public:
+    explicit Decoder(std::string_view bytes) : bytes_(bytes) {
+        record_count_ = get_u32(bytes_, 16);
+        string_count_ = get_u32(bytes_, 20);
+        offsets_ = HEADER_SIZE + (static_cast<std::size_t>(record_count_) * RECORD_SIZE);
+        strings_ = offsets_ + ((static_cast<std::size_t>(string_count_) + 1) * 4);
+        if (strings_ > bytes_.size()
+            || strings_ + get_u32(bytes_, offsets_ + (string_count_ * std::size_t{4}))
+                   != bytes_.size()) {
+            throw damaged("truncated or trailing data");
+        }
+    }
+
+    [[nodiscard]] auto string(std::uint64_t index) const -> std::string_view {
+        if (index >= string_count_) {
+            throw damaged("string index out of range");
+        }
+        auto start = get_u32(bytes_, offsets_ + (index * 4));
+        auto end = get_u32(bytes_, offsets_ + ((index + 1) * 4));
+        if (start > end || strings_ + end > bytes_.size()) {
+            throw damaged("string table out of range");
+        }
+        return bytes_.substr(strings_ + start, end - start);
+    }
+
+    auto document() -> jsom::JsonDocument {
+        auto root = next();
+        if (next_ != record_count_) {
+            throw damaged("records left after the script");
+        }
+        return root;
+    }
+
+private:
+    std::string_view bytes_;
+    std::uint32_t record_count_;
+    std::uint32_t string_count_;
+    std::size_t offsets_; // Offset of the string offset table
+    std::size_t strings_; // Offset of the string bytes
+    std::uint32_t next_{0};
+
+    [[nodiscard]] auto remaining() const -> std::uint64_t { return record_count_ - next_; }
+
+    [[nodiscard]] auto next_key() const -> std::uint32_t {
+        if (next_ >= record_count_) {
+            throw damaged("missing records");
+        }
+        return get_u32(bytes_, HEADER_SIZE + (static_cast<std::size_t>(next_) * RECORD_SIZE) + 4);
+    }
+
+    // NOLINTNEXTLINE(readability-function-size)
+    auto next(std::size_t depth = 0) -> jsom::JsonDocument {
+        if (next_ >= record_count_) {
+            throw damaged("missing records");
+        }
+        auto offset = HEADER_SIZE + (static_cast<std::size_t>(next_++) * RECORD_SIZE);
+        auto tag = static_cast<RecordTag>(static_cast<unsigned char>(bytes_[offset]));
+        auto value = get_u64(bytes_, offset + 8);
+        switch (tag) {
+        case RecordTag::Null:
+            return jsom::JsonDocument(nullptr);
+        case RecordTag::False:
+            return jsom::JsonDocument(false);
+        case RecordTag::True:
+            return jsom::JsonDocument(true);
+        case RecordTag::Number:
+            return jsom::JsonDocument::from_lazy_number(std::string(string(value)));
+        case RecordTag::String:
+            return jsom::JsonDocument(std::string(string(value)));
+        case RecordTag::Array: {
+            if (depth >= SCRIPT_CACHE_MAX_DEPTH) {
+                throw damaged("nested too deeply");
+            }
+            if (value > remaining()) {
+                throw damaged("array longer than the file");
+            }
+            auto array = jsom::JsonDocument::make_array();
+            for (std::uint64_t i = 0; i < value; ++i) {
+                array.push_back(next(depth + 1));
+            }
+            return array;
+        }
+        case RecordTag::Object: {
+            if (depth >= SCRIPT_CACHE_MAX_DEPTH) {
+                throw damaged("nested too deeply");
+            }
+            if (value > remaining()) {
+                throw damaged("object longer than the file");
+            }
+            auto object = jsom::JsonDocument::make_object();
+            for (std::uint64_t i = 0; i < value; ++i) {
+                auto key = std::string(string(next_key()));
+                object.set(key, next(depth + 1));
+            }
+            return object;
+        }
+        }
+        throw damaged("unknown record tag");
+    }
+};
+
+} // namespace
+
+auto encode_script_cache(const jsom::JsonDocument& script, const std::string& array_key)
+    -> std::string {
+    Encoder encoder;
+    auto key = encoder.intern(array_key);
+    encoder.add(script, NO_KEY);
+    return encoder.finish(key);
+}
+
+auto is_script_cache(std::string_view bytes) -> bool {
+    return bytes.substr(0, MAGIC.size()) == MAGIC;
+}
+
+auto decode_script_cache(std::string_view bytes) -> CachedScript {
+    if (!is_script_cache(bytes) || bytes.size() < HEADER_SIZE) {
+        throw damaged("not a compiled script");
+    }
+    auto version = get_u32(bytes, MAGIC.size());
+    if (version != SCRIPT_CACHE_VERSION) {
+        throw std::runtime_error("Compiled script has format version " + std::to_string(version)
+                                 + ", this build reads version "
+                                 + std::to_string(SCRIPT_CACHE_VERSION)
+                                 + "; recompile it with --compile-to");
+    }
+    Decoder decoder(bytes);
+    CachedScript cached;
+    cached.array_key = std::string(decoder.string(get_u32(bytes, 12)));
+    cached.script = decoder.document();
+    return cached;
+}
+
+} // namespace computo
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <computo.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace computo {
+
+// --- Compiled Script Files (.computoc) ---
+
+/**
+ * Format version written into every compiled script; files of any other
+ * version are rejected and have to be compiled again
+ */
+constexpr std::uint32_t SCRIPT_CACHE_VERSION = 1;
+
+/**
+ * Deepest nesting of arrays and objects a compiled script may have; the
+ * decoder recurses once per level, so damaged files must not go deeper
+ */
+constexpr std::size_t SCRIPT_CACHE_MAX_DEPTH = 4096;
+
+/**
+ * A script read back from its compiled form, with the array wrapper key it
+ * was compiled under
+ */
+struct CachedScript {
+    jsom::JsonDocument script;
+    std::string array_key;
+};
+
+/**
+ * Encode a parsed script (JSON or sugar) into the compiled binary form
+ *
+ * The file is flat and read in place: a header (magic, version, counts), one
+ * fixed 16-byte record per JSON value in pre-order, then a table of interned
+ * strings. Operator names, object keys, pointers and strings are each stored
+ * once and referred to by their index; numbers keep their source text. All
+ * integers are little-endian.
+ *
+ * @throws std::runtime_error if the script nests deeper than
+ *         SCRIPT_CACHE_MAX_DEPTH
+ */
+auto encode_script_cache(const jsom::JsonDocument& script, const std::string& array_key)
+    -> std::string;
+
+/**
+ * True if bytes start like a compiled script, whatever its version
+ */
+auto is_script_cache(std::string_view bytes) -> bool;
+
+/**
+ * Rebuild the script from its compiled form, without tokenizing any text
+ *
+ * @throws std::runtime_error if the version differs from SCRIPT_CACHE_VERSION
+ *         or the file is truncated or damaged
+ */
+auto decode_script_cache(std::string_view bytes) -> CachedScript;
+
+} // namespace computo
@@ -0,0 +1,413 @@
+#include "server.hpp"
+#include "json_writer.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace computo {
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace {
+
+constexpr std::size_t MAX_SCRIPT_ID_BYTES = 4096;
+constexpr std::size_t RESPONSE_BUFFER_BYTES = std::size_t{64} * 1024;
+constexpr char STATUS_OK = 0;
+constexpr char STATUS_ERROR = 1;
+
+// Counts exactly, however large they grow
+auto count_json(std::uint64_t value) -> jsom::JsonDocument {
+    return jsom::JsonDocument::from_lazy_number(std::to_string(value));
+}
+
+// Request latencies in power-of-two buckets of microseconds: bucket i counts
+// requests that took [2^i, 2^(i+1)) us, bucket 0 everything under 2 us
+class LatencyHistogram {
+public:
+    static constexpr std::size_t BUCKETS = 40;
+
+    void record(std::chrono::nanoseconds elapsed) {
+        auto micros = static_cast<std::uint64_t>(std::max<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 1));
+        std::size_t bucket = 0;
+        while (micros > 1 && bucket + 1 < BUCKETS) {
+            micros >>= 1U;
+            ++bucket;
+        }
+        counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Percentiles are the upper bound of the bucket they fall in
+    [[nodiscard]] auto to_json() const -> jsom::JsonDocument {
+        std::array<std::uint64_t, BUCKETS> counts{};
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            counts[i] = counts_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        auto percentile = [&](std::uint64_t percent) -> std::uint64_t {
+            auto rank = ((total * percent) + 99) / 100;
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                seen += counts[i];
+                if (seen >= rank && seen > 0) {
+                    return upper_bound(i);
+                }
+            }
+            return 0;
+        };
+
+        auto report = jsom::JsonDocument::make_object();
+        report.set("p50", count_json(percentile(50)));
+        report.set("p99", count_json(percentile(99)));
+        auto buckets = jsom::JsonDocument::make_array();
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            if (counts[i] > 0) {
+                auto bucket = jsom::JsonDocument::make_object();
+                bucket.set("below", count_json(upper_bound(i)));
+                bucket.set("count", count_json(counts[i]));
+                buckets.push_back(std::move(bucket));
+            }
+        }
+        report.set("histogram", std::move(buckets));
+        return report;
+    }
+
+private:
+    static auto upper_bound(std::size_t bucket) -> std::uint64_t {
+        return std::uint64_t{2} << bucket;
+    }
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> counts_{};
+};
+
+struct ScriptState {
+    ServedScript script;
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::uint64_t> errors{0};
+    LatencyHistogram latency;
+};
+
+// Reads exactly size bytes; false if the peer closed the connection or failed
+auto read_exact(int fd, char* data, std::size_t size) -> bool {
+    while (size > 0) {
+        auto count = ::read(fd, data, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+enum class FieldStatus : std::uint8_t { Read, Closed, TooLarge };
+
+// One length-prefixed field of a request. A field longer than limit is not
+// read: its length is left in size for the error message.
+auto read_field(int fd, std::string& field, std::size_t limit, std::uint32_t& size)
+    -> FieldStatus {
+    std::array<char, 4> header{};
+    if (!read_exact(fd, header.data(), header.size())) {
+        return FieldStatus::Closed;
+    }
+    size = 0;
+    for (std::size_t i = 0; i < header.size(); ++i) {
+        size |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+    }
+    if (size > limit) {
+        return FieldStatus::TooLarge;
+    }
+    field.resize(size);
+    return read_exact(fd, field.data(), size) ? FieldStatus::Read : FieldStatus::Closed;
+}
+
+class Server {
+public:
+    Server(const std::vector<ServedScript>& scripts, const ComputoArgs& args)
+        : enable_comments_(args.enable_comments), max_request_bytes_(args.max_request_bytes),
+          max_connections_(args.max_connections) {
+        parallel_.threads = args.threads;
+        for (const auto& script : scripts) {
+            auto state = std::make_unique<ScriptState>();
+            state->script = script;
+            scripts_.emplace(script.id, std::move(state));
+        }
+    }
+
+    // Answers requests until the client closes the connection. Runs on the
+    // connection's own thread, which only reads, writes and waits: scripts run
+    // on the pool, so open connections never hold its workers.
+    void serve_connection(int fd) {
+        OutputSink out(fd, RESPONSE_BUFFER_BYTES, OutputFraming::LengthPrefixed);
+        std::string id;
+        std::string input;
+        std::uint32_t size = 0;
+        try {
+            while (true) {
+                auto status = read_field(fd, id, MAX_SCRIPT_ID_BYTES, size);
+                if (status == FieldStatus::Read) {
+                    status = read_field(fd, input, max_request_bytes_, size);
+                }
+                if (status == FieldStatus::Closed) {
+                    return;
+                }
+                if (status == FieldStatus::TooLarge) {
+                    // The oversized field is still on its way; the connection
+                    // cannot be resynchronized, so it ends after the error
+                    rejected_requests_.fetch_add(1, std::memory_order_relaxed);
+                    respond_error(out, "Request too large: " + std::to_string(size)
+                                           + " bytes (limit "
+                                           + std::to_string(max_request_bytes_) + ")");
+                    return;
+                }
+                handle(out, id, input);
+            }
+        } catch (const std::exception&) {
+            // The client went away while its response was being written
+        }
+    }
+
+    // Waits until fewer than max_connections connections are open, then
+    // counts one more. Each one holds a thread and up to max_request_bytes
+    // of input, so this bounds what a burst of clients can take.
+    void acquire_connection_slot() {
+        std::unique_lock<std::mutex> lock(connections_mutex_);
+        connection_closed_.wait(lock, [&] { return open_connections_ < max_connections_; });
+        ++open_connections_;
+    }
+
+    void release_connection_slot() {
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            --open_connections_;
+        }
+        connection_closed_.notify_one();
+    }
+
+private:
+    std::map<std::string, std::unique_ptr<ScriptState>, std::less<>> scripts_;
+    std::atomic<std::uint64_t> unknown_requests_{0};
+    std::atomic<std::uint64_t> rejected_requests_{0}; // Script id or input over the size limit
+    bool enable_comments_;
+    std::size_t max_request_bytes_;
+    std::size_t max_connections_;
+    std::mutex connections_mutex_;
+    std::condition_variable connection_closed_;
+    std::size_t open_connections_{0};
+    ParallelOptions parallel_;
+
+    static void respond_error(OutputSink& out, const std::string& message) {
+        out.put(STATUS_ERROR);
+        out.write(message);
+        out.end_message();
+    }
+
+    // Run program on a pool worker and wait for its result or exception
+    auto evaluate(const Program& program, std::vector<jsom::JsonDocument> inputs) const
+        -> jsom::JsonDocument {
+        auto result = std::make_shared<std::promise<jsom::JsonDocument>>();
+        auto shared_inputs = std::make_shared<std::vector<jsom::JsonDocument>>(std::move(inputs));
+        auto future = result->get_future();
+        thread_pool::submit([&program, result, shared_inputs, parallel = parallel_]() {
+            try {
+                result->set_value(program.run(std::move(*shared_inputs), nullptr, parallel));
+            } catch (...) {
+                result->set_exception(std::current_exception());
+            }
+        });
+        return future.get();
+    }
+
+    // NOLINTNEXTLINE(readability-function-size)
+    void handle(OutputSink& out, const std::string& id, const std::string& input) {
+        if (id == SERVER_STATS_ID) {
+            out.put(STATUS_OK);
+            write_json(out, stats(), false);
+            out.end_message();
+            return;
+        }
+        auto iter = scripts_.find(id);
+        if (iter == scripts_.end()) {
+            unknown_requests_.fetch_add(1, std::memory_order_relaxed);
+            respond_error(out, "Unknown script: " + id);
+            return;
+        }
+
+        auto& state = *iter->second;
+        auto start = std::chrono::steady_clock::now();
+        state.requests.fetch_add(1, std::memory_order_relaxed);
+        auto fail = [&](const std::string& message) {
+            state.errors.fetch_add(1, std::memory_order_relaxed);
+            respond_error(out, message);
+            state.latency.record(std::chrono::steady_clock::now() - start);
+        };
+
+        std::vector<jsom::JsonDocument> inputs;
+        try {
+            inputs.push_back(enable_comments_
+                                 ? jsom::parse_document(input, jsom::ParsePresets::Comments)
+                                 : jsom::parse_document(input));
+        } catch (const std::exception& e) {
+            fail(std::string("JSON parse error: ") + e.what());
+            return;
+        }
+        jsom::JsonDocument result;
+        try {
+            result = evaluate(state.script.program, std::move(inputs));
+        } catch (const std::exception& e) {
+            fail(e.what());
+            return;
+        }
+
+        // Unwrap the array wrapper, as the CLI does
+        const auto& array_key = state.script.program.array_key();
+        out.put(STATUS_OK);
+        if (result.is_object() && result.size() == 1 && result.contains(array_key)) {
+            write_json(out, result[array_key], false);
+        } else {
+            write_json(out, result, false);
+        }
+        out.end_message();
+        state.latency.record(std::chrono::steady_clock::now() - start);
+    }
+
+    [[nodiscard]] auto stats() const -> jsom::JsonDocument {
+        std::uint64_t requests = unknown_requests_.load(std::memory_order_relaxed)
+                                 + rejected_requests_.load(std::memory_order_relaxed);
+        std::uint64_t errors = requests;
+        auto scripts = jsom::JsonDocument::make_object();
+        for (const auto& [id, state] : scripts_) {
+            auto script_requests = state->requests.load(std::memory_order_relaxed);
+            auto script_errors = state->errors.load(std::memory_order_relaxed);
+            requests += script_requests;
+            errors += script_errors;
+            auto entry = jsom::JsonDocument::make_object();
+            entry.set("requests", count_json(script_requests));
+            entry.set("errors", count_json(script_errors));
+            entry.set("latency_us", state->latency.to_json());
+            scripts.set(id, std::move(entry));
+        }
+        auto report = jsom::JsonDocument::make_object();
+        report.set("requests", count_json(requests));
+        report.set("errors", count_json(errors));
+        report.set("scripts", std::move(scripts));
+        return report;
+    }
+};
+
+// Socket file to remove when a signal ends the server
+std::array<char, sizeof(sockaddr_un::sun_path)> signal_socket_path{};
+
+extern "C" void remove_socket_and_exit(int /*signal*/) {
+    ::unlink(signal_socket_path.data());
+    _exit(0);
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-function-size)
+auto run_server(const std::string& socket_path, const std::vector<ServedScript>& scripts,
+                const ComputoArgs& args) -> int {
+    sockaddr_un address{};
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is empty or too long: " << socket_path << "\n";
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(socket_path.begin(), socket_path.end(), address.sun_path);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::cerr << "Error: Could not create socket: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    // A socket left behind by an earlier server is replaced; any other file is not
+    struct stat existing {};
+    if (::lstat(socket_path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        ::unlink(socket_path.c_str());
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "Error: Could not listen on " << socket_path << ": " << std::strerror(errno)
+                  << "\n";
+        ::close(listener);
+        return 1;
+    }
+
+    std::copy(socket_path.begin(), socket_path.end(), signal_socket_path.begin());
+    std::signal(SIGINT, remove_socket_and_exit);
+    std::signal(SIGTERM, remove_socket_and_exit);
+    std::signal(SIGPIPE, SIG_IGN); // Clients that disconnect early fail the write instead
+
+    auto server = std::make_shared<Server>(scripts, args);
+    thread_pool::reserve(std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+    std::cerr << "Serving " << scripts.size() << " script(s) on " << socket_path << "\n";
+
+    while (true) {
+        // Clients beyond the limit wait in the listen backlog until one closes
+        server->acquire_connection_slot();
+        int connection = ::accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            auto error = errno;
+            server->release_connection_slot();
+            if (error == EINTR || error == ECONNABORTED) {
+                continue;
+            }
+            std::cerr << "Error: Could not accept connections: " << std::strerror(error) << "\n";
+            ::close(listener);
+            ::unlink(socket_path.c_str());
+            return 1;
+        }
+        try {
+            std::thread([server, connection]() {
+                server->serve_connection(connection);
+                ::close(connection);
+                server->release_connection_slot();
+            }).detach();
+        } catch (const std::system_error& e) {
+            std::cerr << "Error: Could not start a connection thread: " << e.what() << "\n";
+            ::close(connection);
+            server->release_connection_slot();
+        }
+    }
+}
+
+#else
+
+auto run_server(const std::string& /*socket_path*/, const std::vector<ServedScript>& /*scripts*/,
+                const ComputoArgs& /*args*/) -> int {
+    std::cerr << "Error: --serve needs Unix domain sockets, which this platform lacks\n";
+    return 1;
+}
+
+#endif
+
+} // namespace computo
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cli_args.hpp"
+#include <computo.hpp>
+#include <string>
+#include <vector>
+
+namespace computo {
+
+// --- Server Mode ---
+
+/**
+ * A compiled script kept resident by the server, and the id requests name it by
+ */
+struct ServedScript {
+    std::string id;
+    Program program;
+};
+
+/**
+ * Script id whose requests return the server's statistics instead of running
+ * a script
+ */
+constexpr const char* SERVER_STATS_ID = "$stats";
+
+/**
+ * Serve scripts over a Unix domain socket at socket_path until the process is
+ * terminated (SIGINT / SIGTERM remove the socket file on the way out)
+ *
+ * Every message is little-endian and length-prefixed. A request is the script
+ * id and the input JSON text, each as a 4-byte length followed by that many
+ * bytes; a connection may send any number of requests, one after another. The
+ * response streams back as chunks, each a 4-byte length followed by that many
+ * bytes, ended by an empty chunk. The first byte of the joined chunks is 0 for
+ * success, followed by the compact result, or 1 for an error, followed by its
+ * message. An input longer than args.max_request_bytes is answered with an
+ * error before any of it is read, and the connection is then closed. At most
+ * args.max_connections connections are served at once; further clients stay
+ * in the listen backlog until one closes.
+ *
+ * Each open connection has a thread of its own for reading requests and
+ * writing responses; scripts run on the shared thread pool, so any number of
+ * idle connections can stay open without starving evaluation. Requests for
+ * SERVER_STATS_ID return per-script request and error counts and latency
+ * histograms.
+ *
+ * @return Exit status if the socket could not be set up (the message is
+ *         printed on stderr); does not return otherwise
+ */
+auto run_server(const std::string& socket_path, const std::vector<ServedScript>& scripts,
+                const ComputoArgs& args) -> int;
+
+} // namespace computo
@@ -0,0 +1,220 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace computo::thread_pool {
+
+namespace {
+
+constexpr std::size_t NOT_A_WORKER = std::numeric_limits<std::size_t>::max();
+
+thread_local std::size_t current_worker = NOT_A_WORKER; // Index of the calling worker
+
+struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks; // Owner at the back, thieves at the front
+};
+
+class Pool {
+public:
+    Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool(Pool&&) = delete;
+    auto operator=(const Pool&) -> Pool& = delete;
+    auto operator=(Pool&&) -> Pool& = delete;
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void reserve(std::size_t count) {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        count = std::min(count, MAX_WORKERS);
+        for (auto index = started_.load(); index < count; ++index) {
+            // Published before the thread starts and before thieves can see it
+            workers_[index] = std::make_unique<Worker>();
+            threads_.emplace_back([this, index] { work(index); });
+            started_.store(index + 1, std::memory_order_release);
+        }
+    }
+
+    [[nodiscard]] auto worker_count() const -> std::size_t {
+        return started_.load(std::memory_order_acquire);
+    }
+
+    void submit(std::function<void()> task) {
+        auto count = worker_count();
+        if (count == 0) {
+            task();
+            return;
+        }
+        auto target = current_worker != NOT_A_WORKER ? current_worker : next_target_++ % count;
+        {
+            std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+            workers_[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            ++queued_;
+        }
+        wake_.notify_one();
+    }
+
+private:
+    std::array<std::unique_ptr<Worker>, MAX_WORKERS> workers_;
+    std::atomic<std::size_t> started_{0};
+    std::atomic<std::size_t> next_target_{0};
+    std::mutex start_mutex_;
+    std::vector<std::thread> threads_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::size_t queued_{0}; // Tasks in any deque
+    bool stopping_{false};
+
+    // The newest task of worker index, else the oldest one of another worker
+    auto take(std::size_t index, std::function<void()>& task) -> bool {
+        auto count = worker_count();
+        for (std::size_t offset = 0; offset < count; ++offset) {
+            auto& worker = *workers_[(index + offset) % count];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.tasks.empty()) {
+                continue;
+            }
+            if (offset == 0) {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+            } else {
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void work(std::size_t index) {
+        current_worker = index;
+        while (true) {
+            std::function<void()> task;
+            if (take(index, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleep_mutex_);
+                    --queued_;
+                }
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (stopping_) {
+                return;
+            }
+        }
+    }
+};
+
+auto pool() -> Pool& {
+    static Pool instance;
+    return instance;
+}
+
+// One parallel_for call, shared with the helpers it queued. Helpers that
+// start after every chunk has been handed out return without touching body.
+struct ChunkedLoop {
+    std::size_t count{0};
+    std::size_t chunk_size{0};
+    std::size_t chunks{0};
+    const std::function<void(std::size_t, std::size_t)>* body{nullptr};
+
+    std::atomic<std::size_t> next_chunk{0};
+    std::atomic<std::size_t> first_failed; // chunks while none has failed
+    std::vector<std::exception_ptr> errors; // Written only by the thread running the chunk
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t finished{0};
+
+    ChunkedLoop(std::size_t count, std::size_t chunk_size,
+                const std::function<void(std::size_t, std::size_t)>& body)
+        : count(count), chunk_size(chunk_size), chunks((count + chunk_size - 1) / chunk_size),
+          body(&body), first_failed(chunks), errors(chunks) {}
+
+    void record_failure(std::size_t chunk) {
+        errors[chunk] = std::current_exception();
+        auto lowest = first_failed.load();
+        while (chunk < lowest && !first_failed.compare_exchange_weak(lowest, chunk)) {
+        }
+    }
+
+    void run() {
+        for (auto chunk = next_chunk++; chunk < chunks; chunk = next_chunk++) {
+            // A lower chunk's error is the one reported; later work is wasted
+            if (chunk < first_failed.load()) {
+                try {
+                    (*body)(chunk * chunk_size, std::min(count, (chunk + 1) * chunk_size));
+                } catch (...) {
+                    record_failure(chunk);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished == chunks) {
+                done.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace
+
+void reserve(std::size_t count) { pool().reserve(count); }
+
+auto worker_count() -> std::size_t { return pool().worker_count(); }
+
+void submit(std::function<void()> task) { pool().submit(std::move(task)); }
+
+void parallel_for(std::size_t count, std::size_t chunk_size, std::size_t threads,
+                  const std::function<void(std::size_t begin, std::size_t end)>& body) {
+    if (count == 0) {
+        return;
+    }
+    auto loop = std::make_shared<ChunkedLoop>(count, std::max<std::size_t>(chunk_size, 1), body);
+    auto helpers = std::min({threads > 0 ? threads - 1 : 0, loop->chunks - 1, MAX_WORKERS});
+    if (helpers > 0) {
+        reserve(helpers);
+        for (std::size_t i = 0; i < helpers; ++i) {
+            submit([loop] { loop->run(); });
+        }
+    }
+    loop->run();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->done.wait(lock, [&] { return loop->finished == loop->chunks; });
+    auto failed = loop->first_failed.load();
+    if (failed < loop->chunks) {
+        // Taken out, since a helper still finishing up may free the loop
+        auto error = std::move(loop->errors[failed]);
+        lock.unlock();
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace computo::thread_pool
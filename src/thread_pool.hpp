@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace computo::thread_pool {
+
+// --- Work-Stealing Thread Pool ---
+
+/**
+ * Most workers the process-wide pool starts; callers asking for more threads
+ * share these
+ */
+constexpr std::size_t MAX_WORKERS = 64;
+
+/**
+ * Start pool workers until there are at least count of them (at most
+ * MAX_WORKERS). Workers live until the process exits.
+ */
+void reserve(std::size_t count);
+
+/**
+ * Number of workers started so far
+ */
+auto worker_count() -> std::size_t;
+
+/**
+ * Queue task on the pool. A worker queues on its own deque, which it runs
+ * newest first while idle workers steal its oldest tasks; other threads' tasks
+ * are dealt out round robin. Runs task on the calling thread if no worker has
+ * been started. Exceptions must not escape task.
+ */
+void submit(std::function<void()> task);
+
+/**
+ * Run body(begin, end) over [0, count) in chunks of chunk_size elements, on up
+ * to threads threads (the calling one included), and return once every chunk
+ * has finished
+ *
+ * Chunks are handed out in index order. When body throws, chunks after the
+ * lowest failing one are skipped and that chunk's exception is rethrown, so
+ * the caller sees the error a sequential loop over the chunks would have met
+ * first.
+ */
+void parallel_for(std::size_t count, std::size_t chunk_size, std::size_t threads,
+                  const std::function<void(std::size_t begin, std::size_t end)>& body);
+
+} // namespace computo::thread_pool
@@ -0,0 +1,176 @@
+#pragma once
+
+// Minimal client for `computo --serve`, shared by the server tests and benchmarks
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace test_utils {
+
+struct ServerReply {
+    bool ok{false};
+    std::string body; // Compact result, or the error message
+};
+
+/**
+ * One connection to a running server; requests are sent one at a time
+ */
+class ServerClient {
+public:
+    // Retries for a few seconds while the server starts up. Replies that take
+    // longer than ten seconds fail instead of hanging the test.
+    explicit ServerClient(const std::string& socket_path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        socket_path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        for (int attempt = 0; attempt < 500; ++attempt) {
+            fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto* target = reinterpret_cast<const sockaddr*>(&address);
+            if (::connect(fd_, target, sizeof(address)) == 0) {
+                timeval timeout{};
+                timeout.tv_sec = 10;
+                ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                return;
+            }
+            ::close(fd_);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        throw std::runtime_error("Could not connect to " + socket_path);
+    }
+    ServerClient(const ServerClient&) = delete;
+    ServerClient(ServerClient&&) = delete;
+    auto operator=(const ServerClient&) -> ServerClient& = delete;
+    auto operator=(ServerClient&&) -> ServerClient& = delete;
+    ~ServerClient() { ::close(fd_); }
+
+    auto request(const std::string& script_id, const std::string& input) -> ServerReply {
+        std::string message;
+        append_field(message, script_id);
+        append_field(message, input);
+        write_all(message);
+        return read_reply();
+    }
+
+    // Send a script id and an input length without the input that should follow
+    void announce(const std::string& script_id, std::uint32_t input_size) {
+        std::string message;
+        append_field(message, script_id);
+        for (int shift = 0; shift < 32; shift += 8) {
+            message.push_back(static_cast<char>((input_size >> shift) & 0xFFU));
+        }
+        write_all(message);
+    }
+
+    auto read_reply() -> ServerReply {
+        std::string payload;
+        while (true) {
+            auto size = read_length();
+            if (size == 0) {
+                break;
+            }
+            auto offset = payload.size();
+            payload.resize(offset + size);
+            read_exact(payload.data() + offset, size);
+        }
+        if (payload.empty()) {
+            throw std::runtime_error("Empty response");
+        }
+        return {payload[0] == 0, payload.substr(1)};
+    }
+
+private:
+    int fd_{-1};
+
+    static void append_field(std::string& message, const std::string& field) {
+        auto size = static_cast<std::uint32_t>(field.size());
+        for (int shift = 0; shift < 32; shift += 8) {
+            message.push_back(static_cast<char>((size >> shift) & 0xFFU));
+        }
+        message += field;
+    }
+
+    void write_all(const std::string& bytes) {
+        std::size_t sent = 0;
+        while (sent < bytes.size()) {
+            auto count = ::write(fd_, bytes.data() + sent, bytes.size() - sent);
+            if (count <= 0) {
+                throw std::runtime_error("Could not send request");
+            }
+            sent += static_cast<std::size_t>(count);
+        }
+    }
+
+    void read_exact(char* data, std::size_t size) {
+        while (size > 0) {
+            auto count = ::read(fd_, data, size);
+            if (count <= 0) {
+                throw std::runtime_error("Connection closed mid-response");
+            }
+            data += count;
+            size -= static_cast<std::size_t>(count);
+        }
+    }
+
+    auto read_length() -> std::uint32_t {
+        std::array<char, 4> header{};
+        read_exact(header.data(), header.size());
+        std::uint32_t size = 0;
+        for (std::size_t i = 0; i < header.size(); ++i) {
+            size |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+        }
+        return size;
+    }
+};
+
+/**
+ * Start `binary --serve socket_path options... scripts...` with stderr discarded
+ * @return The server's process id; pass it to stop_server()
+ */
+inline auto start_server(const std::string& binary, const std::string& socket_path,
+                         const std::vector<std::string>& scripts,
+                         const std::vector<std::string>& options = {}) -> pid_t {
+    std::vector<std::string> args = {binary, "--serve", socket_path};
+    args.insert(args.end(), options.begin(), options.end());
+    args.insert(args.end(), scripts.begin(), scripts.end());
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::vector<char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+        if (std::freopen("/dev/null", "w", stderr) == nullptr) {
+            _exit(127);
+        }
+        execv(binary.c_str(), argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+// SIGTERM, then wait; returns the exit status
+inline auto stop_server(pid_t pid) -> int {
+    ::kill(pid, SIGTERM);
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+} // namespace test_utils
+
+#endif
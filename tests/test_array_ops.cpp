@@ -237,3 +237,85 @@ TEST_F(ArrayOpsTest, EveryOperatorErrors) {
     EXPECT_THROW(execute_script(R"(["every", "not an array", ["lambda", ["x"], true]])"),
                  computo::InvalidArgumentException);
 }
+
+// --- Fused map / filter chains ---
+
+TEST_F(ArrayOpsTest, ChainedOperatorsFuse) {
+    auto input = jsom::parse_document("[1, 2, 3, 4]");
+    const std::vector<std::pair<std::string, std::string>> cases = {
+        {R"(["reduce", ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 10]]],
+                                  ["lambda", ["x"], [">", ["$", "/x"], 15]]],
+                       ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]], 0])",
+         "90"},
+        {R"(["count", ["filter", ["$input"], ["lambda", ["x"], [">", ["$", "/x"], 1]]]])", "3"},
+        {R"(["map", ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]],
+                               ["lambda", ["x"], [">", ["$", "/x"], 4]]],
+                    ["lambda", ["x"], ["+", ["$", "/x"], 1]]])",
+         R"({"array": [7, 9]})"},
+        {R"(["find", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 10]]],
+                     ["lambda", ["x"], [">", ["$", "/x"], 15]]])",
+         "20"},
+        {R"(["some", ["filter", ["$input"], ["lambda", ["x"], [">", ["$", "/x"], 3]]],
+                     ["lambda", ["x"], ["==", ["$", "/x"], 4]]])",
+         "true"},
+        {R"(["every", ["map", ["$input"], ["lambda", ["x"], ["-", ["$", "/x"], 1]]],
+                      ["lambda", ["x"], [">", ["$", "/x"], 0]]])",
+         "false"},
+        {R"(["filter", ["map", [], ["lambda", ["x"], ["/", 1, 0]]], ["lambda", ["x"], true]])",
+         R"({"array": []})"},
+        // Stage lambdas see the consumer's scope, including lambda values
+        {R"(["let", {"k": 3, "f": ["lambda", ["x"], ["*", ["$", "/x"], ["$", "/k"]]]},
+                    ["reduce", ["map", ["$input"], ["$", "/f"]],
+                               ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]], 0]])",
+         "30"},
+    };
+    for (const auto& [script_json, expected] : cases) {
+        auto script = jsom::parse_document(script_json);
+        EXPECT_EQ(computo::execute(script, {input}), jsom::parse_document(expected)) << script_json;
+        EXPECT_EQ(computo::compile(script).run({input}), jsom::parse_document(expected))
+            << script_json;
+    }
+}
+
+TEST_F(ArrayOpsTest, ChainedOperatorsReportErrorsCallByCall) {
+    // Each chain would fail in more than one place; the error is the one
+    // evaluating each call in full before the next reaches first
+    auto input = jsom::parse_document("[1, 2, 3]");
+    const std::vector<std::pair<std::string, std::string>> cases = {
+        // find stops at the first element, but map still runs on the rest
+        {R"(["find", ["map", ["$input"], ["lambda", ["x"],
+                         ["if", ["==", ["$", "/x"], 3], ["car", 5], ["$", "/x"]]]],
+                     ["lambda", ["y"], true]])",
+         "Invalid argument: 'car' requires an array argument at /lambda_body/then"},
+        // map fails on element 2 after filter would already have failed on element 1
+        {R"(["count", ["filter", ["map", ["$input"], ["lambda", ["x"],
+                          ["if", ["==", ["$", "/x"], 2], ["car", 5], ["$", "/x"]]]],
+                      ["lambda", ["y"], ["cdr", 7]]]])",
+         "Invalid argument: 'car' requires an array argument at /lambda_body/then"},
+        // reduce's initial value is evaluated after its array argument
+        {R"(["reduce", ["map", ["$input"], ["lambda", ["x"], ["car", ["$", "/x"]]]],
+                       ["lambda", ["a", "x"], 1], ["cdr", 3]])",
+         "Invalid argument: 'car' requires an array argument at /lambda_body"},
+        {R"(["map", ["filter", ["map", 5, ["lambda", ["x"], 1]], ["lambda", ["x"], 1]], 7])",
+         "Invalid argument: 'map' requires an array argument at /"},
+        {R"(["some", ["filter", ["$input"], ["lambda", ["x"], [">", ["$", "/x"], 1]]],
+                     ["lambda", ["x"], ["==", ["$", "/x"], ["$", "/y"]]]])",
+         "Invalid argument: Variable not found: 'y'. Did you mean 'x'? at /lambda_body/arg1"},
+    };
+    for (const auto& [script_json, expected] : cases) {
+        auto script = jsom::parse_document(script_json);
+        for (bool compiled : {false, true}) {
+            std::string message;
+            try {
+                if (compiled) {
+                    (void)computo::compile(script).run({input});
+                } else {
+                    (void)computo::execute(script, {input});
+                }
+            } catch (const computo::ComputoException& e) {
+                message = e.what();
+            }
+            EXPECT_EQ(message, expected) << script_json;
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#include <computo.hpp>
+#include <functional>
+#include <gtest/gtest.h>
+
+using json = jsom::JsonDocument;
+
+class BytecodeTest : public ::testing::Test {
+protected:
+    // Runs a script on the interpreter and on the bytecode backend, and checks
+    // they agree on the result
+    static auto run_both(const std::string& script_json, const std::vector<json>& inputs = {})
+        -> json {
+        auto script = jsom::parse_document(script_json);
+        auto interpreted = computo::execute(script, inputs);
+        auto program = computo::compile(script, "array", computo::Backend::Bytecode);
+        EXPECT_EQ(program.backend(), computo::Backend::Bytecode);
+        auto result = program.run(inputs);
+        EXPECT_EQ(result, interpreted) << "script: " << script_json;
+        return result;
+    }
+
+    static auto error_of(const std::function<void()>& run) -> std::string {
+        try {
+            run();
+        } catch (const computo::ComputoException& e) {
+            return e.what();
+        }
+        return {};
+    }
+
+    static auto bytecode_stats(const std::string& script_json) -> computo::ProgramStats {
+        return computo::compile(jsom::parse_document(script_json), "array",
+                                computo::Backend::Bytecode)
+            .stats();
+    }
+};
+
+// --- Core Operators ---
+
+TEST_F(BytecodeTest, Arithmetic) {
+    EXPECT_EQ(run_both(R"(["+", 1, 2, 3])"), json(6));
+    EXPECT_EQ(run_both(R"(["-", 10, 4, 1])"), json(5));
+    EXPECT_EQ(run_both(R"(["-", 7])"), json(-7));
+    EXPECT_EQ(run_both(R"(["*", 2, ["+", 1, 2]])"), json(6));
+    EXPECT_EQ(run_both(R"(["/", 4])"), json(0.25));
+    EXPECT_EQ(run_both(R"(["/", 12, 2, 3])"), json(2));
+    EXPECT_EQ(run_both(R"(["%", 17, 5])"), json(2));
+}
+
+TEST_F(BytecodeTest, ComparisonAndLogic) {
+    EXPECT_EQ(run_both(R"(["<", 1, 2])"), json(true));
+    EXPECT_EQ(run_both(R"([">=", 1, 2])"), json(false));
+    EXPECT_EQ(run_both(R"(["<", 1, 2, 3])"), json(true)); // Chained: tree subtree
+    EXPECT_EQ(run_both(R"(["==", {"a": [1]}, {"a": [1]}])"), json(true));
+    EXPECT_EQ(run_both(R"(["!=", "a", "b"])"), json(true));
+    EXPECT_EQ(run_both(R"(["and", 1, "x", true])"), json(true));
+    EXPECT_EQ(run_both(R"(["or", 0, "", null])"), json(false));
+    EXPECT_EQ(run_both(R"(["not", []])"), json(true));
+    // Short-circuiting never evaluates the failing argument
+    EXPECT_EQ(run_both(R"(["and", false, ["/", 1, 0]])"), json(false));
+    EXPECT_EQ(run_both(R"(["or", true, ["/", 1, 0]])"), json(true));
+}
+
+TEST_F(BytecodeTest, ControlFlowAndVariables) {
+    EXPECT_EQ(run_both(R"(["if", [">", 3, 2], "yes", ["/", 1, 0]])"), json("yes"));
+    EXPECT_EQ(run_both(R"(["let", {"x": 1}, ["let", {"x": 2, "y": ["$", "/x"]},
+                          ["+", ["$", "/x"], ["$", "/y"]]]])"),
+              json(3));
+    EXPECT_EQ(run_both(R"(["let", [["x", 1], ["x", 2]], ["$", "/x"]])"), json(2));
+    EXPECT_EQ(run_both(R"(["let", {"p": {"a": [4, 5]}}, ["$", "/p/a/1"]])"), json(5));
+    EXPECT_EQ(run_both(R"([["+", 1, 1], "two", ["if", true, 3, 0]])"),
+              jsom::parse_document(R"([2, "two", 3])"));
+}
+
+TEST_F(BytecodeTest, Inputs) {
+    auto input = jsom::parse_document(R"({"items": [1, 2, 3]})");
+    EXPECT_EQ(run_both(R"(["$input"])", {input}), input);
+    EXPECT_EQ(run_both(R"(["$input", "/items/2"])", {input}), json(3));
+    EXPECT_EQ(run_both(R"(["$inputs", "/1"])", {input, json(7)}), json(7)); // Tree subtree
+}
+
+TEST_F(BytecodeTest, ArrayOperators) {
+    auto input = jsom::parse_document(R"([1, 2, 3, 4, 5])");
+    EXPECT_EQ(run_both(R"(["reduce",
+                             ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 10]]],
+                                        ["lambda", ["x"], [">", ["$", "/x"], 20]]],
+                             ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]],
+                             0])",
+                       {input}),
+              json(120));
+    // Nested loops see outer parameters and let bindings
+    EXPECT_EQ(run_both(R"(["let", {"k": 10}, ["map", {"array": [1, 2]},
+                          ["lambda", ["x"], ["reduce", {"array": [1, 2, 3]},
+                              ["lambda", ["a", "y"], ["+", ["$", "/a"], ["*", ["$", "/x"], ["$", "/k"]]]],
+                              0]]]])"),
+              jsom::parse_document(R"({"array": [30, 60]})"));
+    EXPECT_EQ(run_both(R"(["map", [], ["lambda", ["x"], ["/", 1, 0]]])"),
+              jsom::parse_document(R"({"array": []})"));
+    // Lambda values run on the tree with the VM's variables in scope
+    EXPECT_EQ(run_both(R"(["let", {"f": ["lambda", ["x"], ["+", ["$", "/x"], ["$", "/k"]]]},
+                          ["let", {"k": 100}, ["map", {"array": [1, 2]}, ["$", "/f"]]]])"),
+              jsom::parse_document(R"({"array": [101, 102]})"));
+}
+
+TEST_F(BytecodeTest, CustomArrayKey) {
+    auto script = jsom::parse_document(R"(["filter", {"@items": [1, 2, 3]},
+                                           ["lambda", ["x"], [">", ["$", "/x"], 1]]])");
+    auto program = computo::compile(script, "@items", computo::Backend::Bytecode);
+    EXPECT_EQ(program.run(), jsom::parse_document(R"({"@items": [2, 3]})"));
+}
+
+// --- Code Generation ---
+
+TEST_F(BytecodeTest, UnsupportedSubtreesFallBack) {
+    // Core operators only: everything runs on the VM
+    auto core = bytecode_stats(R"(["let", {"x": 2}, ["map", ["$input"],
+                                  ["lambda", ["y"], ["if", ["<", ["$", "/y"], ["$", "/x"]], 0, 1]]]])");
+    EXPECT_GT(core.bytecode_instructions, 0U);
+    EXPECT_EQ(core.bytecode_fallbacks, 0U);
+
+    // One tree subtree per unsupported operator call, however large
+    auto mixed = bytecode_stats(R"(["+", 1, ["count", ["$input"]],
+                                   ["car", ["cdr", ["$input"]]]])");
+    EXPECT_EQ(mixed.bytecode_fallbacks, 2U);
+
+    // The tree backend generates no bytecode
+    auto tree = computo::compile(jsom::parse_document(R"(["+", 1, 2])")).stats();
+    EXPECT_EQ(tree.bytecode_instructions, 0U);
+    EXPECT_GT(tree.nodes, 0U);
+}
+
+// --- Errors and Debugging ---
+
+TEST_F(BytecodeTest, ErrorsMatchInterpreter) {
+    const std::vector<std::string> scripts = {
+        R"(["+", 1, "two"])",
+        R"(["/", 1, 0])",
+        R"(["%", 1, 0])",
+        R"(["<", 1, null])",
+        R"(["let", {"x": 1}, ["$", "/y"]])",
+        R"(["$input", "/missing"])",
+        R"(["map", 5, ["lambda", ["x"], 1]])",
+        R"(["map", [1], ["lambda", ["x", "y"], 1]])",
+        R"(["reduce", [1, 2], ["lambda", ["a", "x"], ["car", ["$", "/x"]]], 0])",
+        R"(["if", true, ["let", {"y": 1}, ["==", 1, ["nope"]]], 0])",
+        R"(["+"])",
+        // The first failing operand wins, as the tree checks them in order
+        R"(["+", "a", ["/", 1, 0]])",
+        R"(["-", 5, 0, ["$input", "/missing"], "b"])",
+        R"(["/", 0])",
+        // Paths of nested nodes, including subtrees left to the tree
+        R"(["let", {"x": ["*", 2, null]}, 1])",
+        R"(["if", ["not", ["$", "/nope"]], 1, 2])",
+        R"(["and", true, [">", 1, [1]]])",
+        R"(["map", [1, 2], ["lambda", ["x"], ["if", [">", ["$", "/x"], 1], ["%", 1, 0], 0]]])",
+        R"(["filter", [1], ["lambda", ["x"], [1, ["strConcat", ["keys", 1]]]]])",
+        R"(["let", {"v": [1]}, ["reduce", ["$", "/v"], ["lambda", ["a", "x"], ["$", "/v/3"]], 0]])",
+    };
+    for (const auto& script_json : scripts) {
+        auto script = jsom::parse_document(script_json);
+        auto interpreted = error_of([&]() { (void)computo::execute(script); });
+        auto program = computo::compile(script, "array", computo::Backend::Bytecode);
+        auto bytecode = error_of([&]() { (void)program.run(); });
+        EXPECT_FALSE(bytecode.empty()) << script_json;
+        EXPECT_EQ(bytecode, interpreted) << script_json;
+    }
+}
+
+TEST_F(BytecodeTest, DebuggingRunsOnTheTree) {
+    auto program = computo::compile(jsom::parse_document(R"(["+", ["$input"], ["*", 2, 3]])"), "array",
+                                    computo::Backend::Bytecode);
+    computo::DebugContext debug_ctx;
+    debug_ctx.set_debug_enabled(true);
+    debug_ctx.set_operator_breakpoint("+");
+    EXPECT_THROW((void)program.run({json(1)}, &debug_ctx), computo::DebugBreakException);
+}
+
+TEST_F(BytecodeTest, DeepRecursionThroughFallbacks) {
+    constexpr int RECURSION_DEPTH = 5000;
+    EXPECT_EQ(run_both(R"(["let", {"f": ["lambda", ["n"],
+                          ["if", ["<=", ["$", "/n"], 0], 0,
+                              ["+", 1, ["car", ["map", [["-", ["$", "/n"], 1]], ["$", "/f"]]]]]]},
+                          ["car", ["map", [["$input"]], ["$", "/f"]]]])",
+                       {json(RECURSION_DEPTH)}),
+              json(RECURSION_DEPTH));
+}
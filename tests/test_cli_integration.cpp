@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 #include <sstream>
 #include <string>
+#include <vector>
 
 // Helper function to execute shell commands and capture output
 struct CommandResult {
@@ -130,6 +131,94 @@ TEST_F(CLIIntegrationTest, MultipleInputFiles) {
     EXPECT_TRUE(result.stderr_output.empty());
 }
 
+// Input files are loaded concurrently but keep their command-line order
+TEST_F(CLIIntegrationTest, ManyInputFilesKeepOrder) {
+    std::filesystem::path script_file = test_dir / "many_inputs.json";
+    create_test_file(script_file, R"(["join", ["$inputs"], ","])");
+    std::string files;
+    std::string expected;
+    for (int i = 0; i < 12; ++i) {
+        std::filesystem::path input_file = test_dir / ("many_" + std::to_string(i) + ".json");
+        create_test_file(input_file, "\"f" + std::to_string(i) + "\"");
+        files += " " + input_file.string();
+        expected += (i == 0 ? "" : ",") + std::string("f") + std::to_string(i);
+    }
+
+    auto result = execute_command(computo_binary + " --script " + script_file.string() + files);
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.stdout_output, "\"" + expected + "\"\n");
+
+    // With several bad files, the first one on the command line is reported
+    std::filesystem::path bad_file = test_dir / "bad.json";
+    create_test_file(bad_file, "{");
+    result = execute_command(computo_binary + " --script " + script_file.string() + files
+                             + " missing.json " + bad_file.string());
+    EXPECT_NE(result.exit_code, 0);
+    EXPECT_NE(result.stderr_output.find("Could not open file: missing.json"), std::string::npos)
+        << result.stderr_output;
+}
+
+TEST_F(CLIIntegrationTest, LazyInputMatchesFullParse) {
+    std::filesystem::path script_file = test_dir / "lazy.json";
+    std::filesystem::path input1_file = test_dir / "lazy_input1.json";
+    std::filesystem::path input2_file = test_dir / "lazy_input2.json";
+    create_test_file(input1_file,
+                     R"({"config": {"scale": 3}, "noise": [1, {"deep": [2, 3]}, "x"]})");
+    create_test_file(input2_file, R"({"values": [1, 2, 3], "unused": {"big": [4, 5, 6]}})");
+    auto run = [&](const std::string& script, const std::string& flags) {
+        create_test_file(script_file, script);
+        return execute_command(computo_binary + " --script " + script_file.string() + " "
+                               + input1_file.string() + " " + input2_file.string() + flags);
+    };
+
+    const std::vector<std::string> scripts = {
+        R"(["map", ["$inputs", "/1/values"],
+            ["lambda", ["x"], ["*", ["$", "/x"], ["$input", "/config/scale"]]]])",
+        R"(["count", ["$inputs"]])",
+        R"(["$input", "/noise/1/deep/1"])",
+        R"(["$input", "/config/missing"])",
+    };
+    for (const auto& script : scripts) {
+        auto full = run(script, "");
+        auto lazy = run(script, " --lazy-input");
+        EXPECT_EQ(lazy.exit_code, full.exit_code) << script;
+        EXPECT_EQ(lazy.stdout_output, full.stdout_output) << script;
+        EXPECT_EQ(lazy.stderr_output, full.stderr_output) << script;
+    }
+
+    // Skipped regions are still checked for balanced brackets
+    create_test_file(input2_file, R"({"values": [1, 2, 3], "unused": {"big": [4, 5, 6})");
+    auto broken = run(R"(["$inputs", "/1/values"])", " --lazy-input");
+    EXPECT_NE(broken.exit_code, 0);
+    EXPECT_NE(broken.stderr_output.find("JSON parse error"), std::string::npos);
+}
+
+TEST_F(CLIIntegrationTest, CompiledScriptMatchesSource) {
+    std::filesystem::path script_file = test_dir / "compiled.computo";
+    std::filesystem::path compiled_file = test_dir / "compiled.computoc";
+    std::filesystem::path input_file = test_dir / "compiled_input.json";
+    create_test_file(script_file, "-- doubled values\nmap($input/values, (x) => x * 2)");
+    create_test_file(input_file, R"({"values": [1, 2.5, 3]})");
+
+    auto compile = execute_command(computo_binary + " --script " + script_file.string()
+                                   + " --compile-to " + compiled_file.string());
+    ASSERT_EQ(compile.exit_code, 0) << compile.stderr_output;
+    EXPECT_TRUE(compile.stdout_output.empty());
+
+    auto source = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                  + input_file.string());
+    auto compiled = execute_command(computo_binary + " --script " + compiled_file.string() + " "
+                                    + input_file.string());
+    EXPECT_EQ(compiled.exit_code, 0);
+    EXPECT_EQ(compiled.stdout_output, source.stdout_output);
+
+    // The array key is part of the compiled form
+    auto other_key = execute_command(computo_binary + " --script " + compiled_file.string() + " "
+                                     + input_file.string() + " --array=@data");
+    EXPECT_NE(other_key.exit_code, 0);
+    EXPECT_NE(other_key.stderr_output.find("compiled with --array=array"), std::string::npos);
+}
+
 // Test complex data transformation
 TEST_F(CLIIntegrationTest, ComplexTransformation) {
     std::filesystem::path script_file = test_dir / "complex.json";
@@ -303,6 +392,109 @@ TEST_F(CLIIntegrationTest, JSONCommentSupport) {
     EXPECT_TRUE(result.stderr_output.empty());
 }
 
+// Test the bytecode backend flag
+TEST_F(CLIIntegrationTest, BytecodeBackend) {
+    std::filesystem::path script_file = test_dir / "bytecode.json";
+    std::filesystem::path input_file = test_dir / "bytecode_input.json";
+    create_test_file(script_file, R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]])");
+    create_test_file(input_file, "[1, 2, 3]");
+
+    auto tree = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                + input_file.string());
+    auto bytecode = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                    + input_file.string() + " --bytecode");
+
+    EXPECT_EQ(bytecode.exit_code, 0);
+    EXPECT_EQ(bytecode.stdout_output, tree.stdout_output);
+    EXPECT_TRUE(bytecode.stderr_output.empty());
+
+    // Errors are reported exactly as on the tree backend
+    create_test_file(script_file, R"(["+", 1, ["$input"]])");
+    tree = execute_command(computo_binary + " --script " + script_file.string() + " "
+                           + input_file.string());
+    bytecode = execute_command(computo_binary + " --script " + script_file.string() + " "
+                               + input_file.string() + " --bytecode");
+    EXPECT_NE(bytecode.exit_code, 0);
+    EXPECT_FALSE(bytecode.stderr_output.empty());
+    EXPECT_EQ(bytecode.stderr_output, tree.stderr_output);
+}
+
+TEST_F(CLIIntegrationTest, ThreadsFlag) {
+    std::filesystem::path script_file = test_dir / "threads.json";
+    std::filesystem::path input_file = test_dir / "threads_input.json";
+    create_test_file(script_file, R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]])");
+    std::string input = "[0";
+    for (int i = 1; i < 5000; ++i) {
+        input += ", " + std::to_string(i);
+    }
+    create_test_file(input_file, input + "]");
+
+    auto sequential = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                      + input_file.string());
+    auto parallel = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                    + input_file.string() + " --threads=4");
+    EXPECT_EQ(parallel.exit_code, 0);
+    EXPECT_EQ(parallel.stdout_output, sequential.stdout_output);
+    EXPECT_TRUE(parallel.stderr_output.empty());
+
+    auto invalid = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                   + input_file.string() + " --threads=0");
+    EXPECT_NE(invalid.exit_code, 0);
+}
+
+TEST_F(CLIIntegrationTest, StatsReportFoldedNodes) {
+    std::filesystem::path script_file = test_dir / "stats.json";
+    std::filesystem::path input_file = test_dir / "stats_input.json";
+    create_test_file(script_file, R"(["*", ["$input"], ["*", 60, 60, 24]])");
+    create_test_file(input_file, "2");
+
+    auto result = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                  + input_file.string() + " --stats");
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.stdout_output, "172800\n");
+    EXPECT_NE(result.stderr_output.find("stats: "), std::string::npos);
+    EXPECT_NE(result.stderr_output.find("\"folded_nodes\":1"), std::string::npos)
+        << result.stderr_output;
+}
+
+TEST_F(CLIIntegrationTest, NdjsonMode) {
+    std::filesystem::path script_file = test_dir / "ndjson.json";
+    std::filesystem::path input_file = test_dir / "records.ndjson";
+    create_test_file(script_file, R"([["$input", "/id"], ["*", ["$input", "/n"], 2]])");
+    std::string records;
+    std::string expected;
+    for (int i = 0; i < 3000; ++i) {
+        records += R"({"id": )" + std::to_string(i) + R"(, "n": )" + std::to_string(i % 7) + "}\n";
+        expected += "[" + std::to_string(i) + "," + std::to_string(2 * (i % 7)) + "]\n";
+    }
+    create_test_file(input_file, records + "\n");
+
+    // One compact line per record, in order, whether read from a file or stdin
+    auto from_file = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                     + input_file.string() + " --ndjson");
+    EXPECT_EQ(from_file.exit_code, 0);
+    EXPECT_EQ(from_file.stdout_output, expected);
+    EXPECT_TRUE(from_file.stderr_output.empty());
+    auto from_stdin = execute_command(computo_binary + " --script " + script_file.string()
+                                      + " --ndjson --threads=4 < " + input_file.string());
+    EXPECT_EQ(from_stdin.exit_code, 0);
+    EXPECT_EQ(from_stdin.stdout_output, expected);
+
+    // Bad records are reported by line and do not stop the others
+    create_test_file(input_file, "{\"id\": 1, \"n\": 2}\nnot json\n"
+                                 "{\"id\": 3, \"n\": \"x\"}\n{\"id\": 4, \"n\": 0}\n");
+    auto failing = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                   + input_file.string() + " --ndjson");
+    EXPECT_NE(failing.exit_code, 0);
+    EXPECT_EQ(failing.stdout_output, "[1,4]\n[4,0]\n");
+    EXPECT_NE(failing.stderr_output.find(":2: JSON parse error"), std::string::npos)
+        << failing.stderr_output;
+    EXPECT_NE(failing.stderr_output.find(":3: "), std::string::npos) << failing.stderr_output;
+
+    auto without_script = execute_command(computo_binary + " --repl --ndjson");
+    EXPECT_NE(without_script.exit_code, 0);
+}
+
 // Test stdin input
 TEST_F(CLIIntegrationTest, StdinInput) {
     std::filesystem::path script_file = test_dir / "stdin_script.json";
@@ -321,6 +513,26 @@ TEST_F(CLIIntegrationTest, StdinInput) {
     EXPECT_EQ(result.stdout_output, "null\n");
 }
 
+#ifndef _WIN32
+// Inputs that cannot be memory-mapped are read instead
+TEST_F(CLIIntegrationTest, UnmappableInputFiles) {
+    std::filesystem::path script_file = test_dir / "unmappable.json";
+    std::filesystem::path empty_file = test_dir / "empty.json";
+    create_test_file(script_file, R"(["+", ["$input"], 1])");
+    create_test_file(empty_file, "");
+
+    auto piped = execute_command("echo '41' | " + computo_binary + " --script "
+                                 + script_file.string() + " /dev/stdin");
+    EXPECT_EQ(piped.exit_code, 0);
+    EXPECT_EQ(piped.stdout_output, "42\n");
+
+    auto empty = execute_command(computo_binary + " --script " + script_file.string() + " "
+                                 + empty_file.string());
+    EXPECT_NE(empty.exit_code, 0);
+    EXPECT_NE(empty.stderr_output.find("JSON parse error"), std::string::npos);
+}
+#endif
+
 // Test cross-platform path handling
 TEST_F(CLIIntegrationTest, PathHandling) {
     // Create nested directory structure
@@ -0,0 +1,95 @@
+#include "computo.hpp"
+#include "json_writer.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+
+using computo::OutputSink;
+using computo::write_json;
+
+class JsonWriterTest : public ::testing::Test {
+protected:
+    const std::string document = R"({
+        "name": "x \"quoted\" \\ \n",
+        "tags": ["a", "b"],
+        "empty": {"list": [], "object": {}},
+        "numbers": [0, -3, 1.5, 1e+20],
+        "flags": [true, false, null],
+        "café": {"\u0001": 1}
+    })";
+
+    // Everything written through a sink of the given capacity
+    static auto serialize(const jsom::JsonDocument& value, bool pretty, std::size_t capacity)
+        -> std::string {
+        std::FILE* file = std::tmpfile();
+        EXPECT_NE(file, nullptr);
+        {
+            OutputSink sink(fileno(file), capacity);
+            write_json(sink, value, pretty);
+        }
+        std::string text;
+        std::rewind(file);
+        char chunk[4096];
+        std::size_t count = 0;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            text.append(chunk, count);
+        }
+        std::fclose(file);
+        return text;
+    }
+};
+
+TEST_F(JsonWriterTest, CompactMatchesToJson) {
+    auto value = jsom::parse_document(document);
+    EXPECT_EQ(serialize(value, false, OutputSink::DEFAULT_CAPACITY), value.to_json());
+    for (const auto* scalar : {"42", "-0.25", "\"text\"", "true", "null", "[]", "{}"}) {
+        auto parsed = jsom::parse_document(scalar);
+        EXPECT_EQ(serialize(parsed, false, OutputSink::DEFAULT_CAPACITY), parsed.to_json());
+    }
+}
+
+TEST_F(JsonWriterTest, PrettyMatchesToJson) {
+    auto nested = jsom::parse_document(
+        R"({"a": [1, {"b": null, "c": [[], [{}], [2, [3, {"d": "e"}]]]}], "f": {"g": {"h": []}}})");
+    for (const auto& value : {nested, jsom::parse_document(document), nested["a"]}) {
+        for (std::size_t capacity : {std::size_t{3}, OutputSink::DEFAULT_CAPACITY}) {
+            EXPECT_EQ(serialize(value, true, capacity), value.to_json(true)) << capacity;
+        }
+    }
+}
+
+TEST_F(JsonWriterTest, PrettyOutputParsesBack) {
+    auto value = jsom::parse_document(document);
+    EXPECT_EQ(jsom::parse_document(serialize(value, true, OutputSink::DEFAULT_CAPACITY)), value);
+}
+
+TEST_F(JsonWriterTest, SmallBuffersGiveTheSameBytes) {
+    auto value = jsom::parse_document(document);
+    auto expected = value.to_json();
+    for (std::size_t capacity : {1U, 3U, 16U}) {
+        EXPECT_EQ(serialize(value, false, capacity), expected) << capacity;
+    }
+}
+
+TEST_F(JsonWriterTest, LengthPrefixedChunks) {
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        OutputSink sink(fileno(file), 4, computo::OutputFraming::LengthPrefixed);
+        sink.write("abcdef"); // Larger than the buffer: one chunk of its own
+        sink.put('g');
+        sink.end_message();
+        sink.end_message(); // Nothing buffered: only the end marker
+    }
+    std::rewind(file);
+    std::string bytes(64, '\0');
+    bytes.resize(std::fread(bytes.data(), 1, bytes.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(bytes, std::string("\x06\0\0\0abcdef\x01\0\0\0g\0\0\0\0\0\0\0\0", 23));
+}
+
+TEST_F(JsonWriterTest, WriteFailureThrows) {
+    OutputSink sink(-1, 4);
+    sink.write("ab");
+    EXPECT_THROW(sink.flush(), std::runtime_error);
+}
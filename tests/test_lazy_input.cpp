@@ -0,0 +1,91 @@
+#include "computo.hpp"
+#include "lazy_input.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using computo::parse_selected;
+using json = jsom::JsonDocument;
+
+class LazyInputTest : public ::testing::Test {
+protected:
+    const std::string document = R"({
+        "meta": {"source": "app", "count": 3},
+        "events": [
+            {"id": 1, "tags": ["a", "b"], "payload": {"text": "x \"quoted\" ]}"}},
+            {"id": 2, "tags": [], "payload": null},
+            {"id": 3, "tags": ["c"], "payload": {"n": -1.5e3}}
+        ],
+        "\u0061lpha": true
+    })";
+
+    // The script's view of the document: the values the pointers reach
+    auto run(const std::string& script, const json& input) -> json {
+        return computo::execute(jsom::parse_document(script), {input});
+    }
+};
+
+TEST_F(LazyInputTest, SelectedValuesMatchFullParse) {
+    auto full = jsom::parse_document(document);
+    auto selected = parse_selected(document, {"/meta/source", "/events/2/payload", "/alpha"});
+    ASSERT_TRUE(selected.has_value());
+    for (const auto* pointer : {"/meta/source", "/events/2/payload", "/alpha"}) {
+        auto script = std::string(R"(["$input", ")") + pointer + R"("])";
+        EXPECT_EQ(run(script, *selected), run(script, full)) << pointer;
+    }
+}
+
+TEST_F(LazyInputTest, SkipsUnselectedMembers) {
+    auto selected = parse_selected(document, {"/events/1/id"});
+    ASSERT_TRUE(selected.has_value());
+    EXPECT_FALSE(selected->contains("meta"));
+    // Arrays keep their length; skipped elements are null
+    ASSERT_EQ((*selected)["events"].size(), 3U);
+    EXPECT_TRUE((*selected)["events"][0].is_null());
+    EXPECT_EQ((*selected)["events"][1], (json{{"id", json(2)}}));
+    EXPECT_TRUE((*selected)["events"][2].is_null());
+}
+
+TEST_F(LazyInputTest, MissingPathsFailAsBefore) {
+    auto full = jsom::parse_document(document);
+    auto selected = parse_selected(document, {"/meta/missing", "/events/7", "/meta/count/x"});
+    ASSERT_TRUE(selected.has_value());
+    for (const auto* pointer : {"/meta/missing", "/events/7", "/meta/count/x"}) {
+        auto script = std::string(R"(["$input", ")") + pointer + R"("])";
+        std::string full_error;
+        std::string selected_error;
+        try {
+            (void)run(script, full);
+        } catch (const computo::ComputoException& e) {
+            full_error = e.what();
+        }
+        try {
+            (void)run(script, *selected);
+        } catch (const computo::ComputoException& e) {
+            selected_error = e.what();
+        }
+        EXPECT_FALSE(full_error.empty()) << pointer;
+        EXPECT_EQ(selected_error, full_error) << pointer;
+    }
+}
+
+TEST_F(LazyInputTest, WholeDocumentAndScanOnly) {
+    auto whole = parse_selected(document, {""});
+    ASSERT_TRUE(whole.has_value());
+    EXPECT_EQ(*whole, jsom::parse_document(document));
+    auto scanned = parse_selected(document, {});
+    ASSERT_TRUE(scanned.has_value());
+    EXPECT_TRUE(scanned->is_null());
+}
+
+TEST_F(LazyInputTest, FallsBackToFullParse) {
+    // Malformed text is left for the full parser to report
+    EXPECT_FALSE(parse_selected(R"({"a": [1, 2})", {"/a"}).has_value());
+    EXPECT_FALSE(parse_selected(R"({"a": 1} x)", {"/a"}).has_value());
+    EXPECT_FALSE(parse_selected(R"({"a": "open)", {}).has_value());
+    // A selected key that appears twice
+    EXPECT_FALSE(parse_selected(R"({"a": 1, "a": 2})", {"/a"}).has_value());
+    // Selected values that a script could run as a lambda reading the input
+    EXPECT_FALSE(parse_selected(R"({"f": [["x"], ["$input", "/secret"]]})", {"/f"}).has_value());
+    EXPECT_FALSE(parse_selected(R"({"f": ["$inputs"]})", {"/f"}).has_value());
+}
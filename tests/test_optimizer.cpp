@@ -0,0 +1,108 @@
+#include <computo.hpp>
+#include <gtest/gtest.h>
+
+using json = jsom::JsonDocument;
+
+class OptimizerTest : public ::testing::Test {
+protected:
+    // The script as compile() leaves it after constant folding
+    static auto folded(const std::string& script_json, const std::string& array_key = "array")
+        -> json {
+        return computo::compile(jsom::parse_document(script_json), array_key).script();
+    }
+
+    static auto folded_nodes(const std::string& script_json) -> std::size_t {
+        return computo::compile(jsom::parse_document(script_json)).stats().folded_nodes;
+    }
+
+    // Folding must never change what a script evaluates to
+    static void expect_same_result(const std::string& script_json,
+                                   const std::vector<json>& inputs = {}) {
+        auto script = jsom::parse_document(script_json);
+        EXPECT_EQ(computo::compile(script).run(inputs), computo::execute(script, inputs))
+            << "script: " << script_json;
+    }
+};
+
+// --- Folding ---
+
+TEST_F(OptimizerTest, PureOperatorsFold) {
+    EXPECT_EQ(folded(R"(["*", 60, 60, 24])"), json(86400));
+    EXPECT_EQ(folded(R"(["strConcat", "a", "b"])"), json("ab"));
+    EXPECT_EQ(folded(R"(["obj", "k", "v"])"), jsom::parse_document(R"({"k": "v"})"));
+    EXPECT_EQ(folded(R"(["if", [">", 2, 1], "yes", "no"])"), json("yes"));
+    EXPECT_EQ(folded_nodes(R"(["*", 60, 60, 24])"), 1U);
+    EXPECT_EQ(folded_nodes(R"(["+", 1, ["*", 2, 3]])"), 2U);
+}
+
+TEST_F(OptimizerTest, ArraysKeepTheirWrapper) {
+    // Array values are written back wrapped, so they are not re-read as calls
+    EXPECT_EQ(folded(R"([1, 2, ["+", 1, 2]])"), jsom::parse_document(R"({"array": [1, 2, 3]})"));
+    EXPECT_EQ(folded(R"(["count", ["cdr", {"array": [1, 2, 3]}]])"), json(2));
+    EXPECT_EQ(folded(R"(["car", ["reverse", {"@": ["a", "b"]}]])", "@"), json("b"));
+    expect_same_result(R"(["count", [["+", 1, 1], "x"]])");
+}
+
+TEST_F(OptimizerTest, ConstantSubtreesInsideDynamicExpressions) {
+    EXPECT_EQ(folded(R"(["+", ["$input"], ["*", 60, 60]])"),
+              jsom::parse_document(R"(["+", ["$input"], 3600])"));
+    // Lambda bodies fold once instead of on every element
+    EXPECT_EQ(folded(R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], ["*", 60, 60]]]])"),
+              jsom::parse_document(
+                  R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 3600]]])"));
+    EXPECT_EQ(folded(R"(["let", [["x", ["+", 1, 1]]], ["$", "/x"]])"),
+              jsom::parse_document(R"(["let", [["x", 2]], ["$", "/x"]])"));
+    expect_same_result(R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], ["+", 1, 1]]]])",
+                       {jsom::parse_document("[1, 2, 3]")});
+}
+
+TEST_F(OptimizerTest, DynamicAndUnsafeSubtreesAreKept) {
+    const std::vector<std::string> unchanged = {
+        R"(["$input", "/a"])",
+        R"(["let", {"x": 1}, ["$", "/x"]])",
+        // Errors stay run-time errors
+        R"(["/", 1, 0])",
+        R"(["car", 5])",
+        R"(["nope", 1])",
+        // Lambda-taking operators are not folded
+        R"(["map", {"array": [1]}, ["lambda", ["x"], ["$", "/x"]]])",
+    };
+    for (const auto& script_json : unchanged) {
+        EXPECT_EQ(folded(script_json), jsom::parse_document(script_json)) << script_json;
+        EXPECT_EQ(folded_nodes(script_json), 0U) << script_json;
+    }
+}
+
+TEST_F(OptimizerTest, LiteralOptionsAreNotExpressions) {
+    EXPECT_EQ(folded(R"(["car", ["sort", {"array": [1, 3, 2]}, "desc"]])"), json(3));
+    expect_same_result(R"(["uniqueSorted", {"array": [1, 1, 2]}, "singles"])");
+}
+
+TEST_F(OptimizerTest, ErrorsAreUnchanged) {
+    auto script = jsom::parse_document(R"(["+", ["*", 2, 3], ["car", ["cdr", {"array": [1]}]]])");
+    std::string interpreted;
+    std::string compiled;
+    try {
+        (void)computo::execute(script);
+    } catch (const computo::ComputoException& e) {
+        interpreted = e.what();
+    }
+    try {
+        (void)computo::compile(script).run();
+    } catch (const computo::ComputoException& e) {
+        compiled = e.what();
+    }
+    EXPECT_FALSE(compiled.empty());
+    EXPECT_EQ(compiled, interpreted);
+}
+
+TEST_F(OptimizerTest, WrapperShapedValuesAreNotFolded) {
+    // {"array": 5} would be read back as a malformed wrapper, not an object
+    EXPECT_EQ(folded(R"(["obj", "array", 5])"), jsom::parse_document(R"(["obj", "array", 5])"));
+    expect_same_result(R"(["obj", "array", 5])");
+    // Array operators return {"array": [...]}, which as a literal would read back
+    // unwrapped; only their callers fold
+    EXPECT_EQ(folded(R"(["cdr", {"array": [1, 2, 3]}])"),
+              jsom::parse_document(R"(["cdr", {"array": [1, 2, 3]}])"));
+    expect_same_result(R"(["cdr", {"array": [1, 2, 3]}])");
+}
@@ -1,24 +1,147 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <computo.hpp>
+#include <json_writer.hpp>
+#include <lazy_input.hpp>
+#include <mapped_file.hpp>
+#include <script_cache.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <server_test_client.hpp>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <numeric>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #ifdef __linux__
 #include <fstream>
 #include <sys/resource.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #endif
 
 using json = jsom::JsonDocument;
 using namespace std::chrono;
 
+// --- Allocation Counting ---
+
+// Every heap allocation in this binary goes through these replacements, so
+// benchmarks can report allocations per operation alongside time and RSS.
+namespace {
+std::atomic<std::size_t> heap_allocation_count{0};
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc)
+void* operator new(std::size_t size) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t /*size*/) noexcept { std::free(ptr); }
+// NOLINTEND(cppcoreguidelines-no-malloc)
+
+// Counts heap allocations made while running func
+template <typename Func> auto count_allocations(Func&& func) -> std::size_t {
+    auto before = heap_allocation_count.load(std::memory_order_relaxed);
+    func();
+    return heap_allocation_count.load(std::memory_order_relaxed) - before;
+}
+
+#ifdef __linux__
+// VmHWM: this process's peak RSS in KB
+inline auto read_peak_rss_kb() -> long {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+#endif
+
+// Runs func in a forked child and returns how much it raised the child's peak
+// RSS, in KB (0 where unsupported). Memory already touched before the call,
+// such as benchmark inputs, is shared with the parent and not counted.
+template <typename Func> auto measure_peak_rss_growth_kb(Func&& func) -> long {
+#ifdef __linux__
+    std::array<int, 2> fds{};
+    if (pipe(fds.data()) != 0) {
+        return 0;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        // The child inherits the parent's peak; restart it from the current RSS
+        // so growth below an earlier, higher peak still shows
+        std::ofstream("/proc/self/clear_refs") << "5";
+        long before = read_peak_rss_kb();
+        func();
+        long growth = read_peak_rss_kb() - before;
+        (void)write(fds[1], &growth, sizeof(growth));
+        _exit(0);
+    }
+    close(fds[1]);
+    long growth = 0;
+    if (read(fds[0], &growth, sizeof(growth)) != sizeof(growth)) {
+        growth = 0;
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return growth;
+#else
+    func();
+    return 0;
+#endif
+}
+
+// --- CLI Process Measurement ---
+
+// Wall time, exit status and peak RSS of one computo CLI run
+struct CliRun {
+    double time_ms{0};
+    long peak_rss_kb{0}; // 0 where unsupported
+    int exit_code{-1};
+};
+
+// Runs the computo binary with args (a shell fragment, so redirections work)
+// and measures that one process
+inline auto run_cli(const std::string& args) -> CliRun {
+    CliRun run;
+    std::string command = std::string(COMPUTO_BINARY_PATH) + " " + args;
+    auto start = steady_clock::now();
+#ifdef __linux__
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    run.peak_rss_kb = usage.ru_maxrss;
+    run.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#else
+    run.exit_code = std::system(command.c_str());
+#endif
+    run.time_ms = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e6;
+    return run;
+}
+
 // --- Performance Measurement Infrastructure ---
 
 struct BenchmarkResult {
@@ -695,6 +818,77 @@ TEST_F(PerformanceBenchmarkTest, TailCallOptimizationBenchmark) {
             execute_script(deep_expr);
         },
         20);
+
+    // Every bounce of the trampoline must be allocation-free: the tail call
+    // references its branch and lives in the trampoline's result slot. Compare
+    // two chain lengths so the fixed cost of the evaluation cancels out.
+    auto if_chain = [](int depth) {
+        std::string expr = "42";
+        for (int i = 0; i < depth; ++i) {
+            expr = R"(["if", [">", )" + std::to_string(i) + ", -1], " + expr + ", 0]";
+        }
+        return jsom::parse_document(expr);
+    };
+    constexpr int SHORT_CHAIN = 200;
+    constexpr int LONG_CHAIN = 1200;
+    auto short_script = if_chain(SHORT_CHAIN);
+    auto long_script = if_chain(LONG_CHAIN);
+    auto short_program = computo::compile(short_script);
+    auto long_program = computo::compile(long_script);
+    ASSERT_EQ(computo::execute(long_script), json(42));
+    ASSERT_EQ(long_program.run(), json(42));
+
+    auto per_bounce = [&](std::size_t short_allocations, std::size_t long_allocations) {
+        return (static_cast<double>(long_allocations) - static_cast<double>(short_allocations))
+               / (LONG_CHAIN - SHORT_CHAIN);
+    };
+    auto interpreted = per_bounce(
+        count_allocations([&]() { (void)computo::execute(short_script); }),
+        count_allocations([&]() { (void)computo::execute(long_script); }));
+    auto compiled = per_bounce(count_allocations([&]() { (void)short_program.run(); }),
+                               count_allocations([&]() { (void)long_program.run(); }));
+    std::cout << "\nHeap allocations per tail-call bounce: interpreted " << interpreted
+              << ", compiled " << compiled << "\n";
+    EXPECT_EQ(interpreted, 0.0);
+    EXPECT_EQ(compiled, 0.0);
+
+    suite_->run_benchmark(
+        "TCO_Bounce", "interpreted", [&]() { (void)computo::execute(long_script); }, LONG_CHAIN);
+    suite_->run_benchmark(
+        "TCO_Bounce", "compiled", [&]() { (void)long_program.run(); }, LONG_CHAIN);
+}
+
+// --- Deep Recursion Benchmarks ---
+
+TEST_F(PerformanceBenchmarkTest, DeepRecursionBenchmark) {
+    // Non-tail recursion through a lambda value: each level waits on "+", so
+    // depth is bounded by the native stack segments evaluate() grows into.
+    // Time per level should stay flat as depth grows (variable lookups do not
+    // walk the recursion's frames).
+    auto script = jsom::parse_document(R"(["let", {"f": ["lambda", ["n"],
+        ["if", ["<=", ["$", "/n"], 0], 0,
+            ["+", 1, ["car", ["map", [["-", ["$", "/n"], 1]], ["$", "/f"]]]]]]},
+        ["car", ["map", [["$input"]], ["$", "/f"]]]])");
+    auto program = computo::compile(script);
+
+    std::cout << "\nDeep recursion, time per level:\n";
+    PerformanceTimer timer;
+    for (int depth : {1000, 10000, 100000}) {
+        timer.start();
+        auto result = program.run({json(depth)});
+        timer.stop();
+        ASSERT_EQ(result, json(depth));
+        std::cout << "  depth " << depth << ": " << timer.get_duration_ms() * 1000.0 / depth
+                  << " us/level (" << timer.get_duration_ms() << " ms)\n";
+    }
+
+    constexpr int BENCHMARK_DEPTH = 1000;
+    suite_->run_benchmark(
+        "DeepRecursion", "interpreted",
+        [&]() { (void)computo::execute(script, {json(BENCHMARK_DEPTH)}); }, BENCHMARK_DEPTH);
+    suite_->run_benchmark(
+        "DeepRecursion", "compiled", [&]() { (void)program.run({json(BENCHMARK_DEPTH)}); },
+        BENCHMARK_DEPTH);
 }
 
 // --- Variable Access and Scoping Benchmarks ---
@@ -738,6 +932,55 @@ TEST_F(PerformanceBenchmarkTest, VariableScopingBenchmark) {
             ]
         ])");
     });
+
+    // Deep nesting: each scope adds one frame of four bindings, so entering a
+    // scope must not cost more as the chain grows
+    for (int depth : {8, 64}) {
+        std::string nested = R"(["$", "/v0_0"])";
+        for (int level = depth - 1; level >= 0; --level) {
+            auto prefix = "v" + std::to_string(level) + "_";
+            nested = R"(["let", {")" + prefix + R"(0": 0, ")" + prefix + R"(1": 1, ")" + prefix
+                     + R"(2": 2, ")" + prefix + R"(3": 3}, )" + nested + "]";
+        }
+        auto script = jsom::parse_document(nested);
+        suite_->run_benchmark("Variable_Nesting", "depth_" + std::to_string(depth),
+                              [&script]() { (void)computo::execute(script, {json(nullptr)}); },
+                              static_cast<std::size_t>(depth));
+    }
+
+    // Compiled programs resolve these lookups to frame slots ahead of time.
+    // The lambda case binds one frame per element inside a let.
+    struct Workload {
+        std::string name;
+        std::string script;
+        json input;
+    };
+    const std::vector<Workload> workloads = {
+        {"nested_scoping", R"(["let", {"x": 1}, ["let", {"y": 2}, ["let", {"z": 3},
+            ["+", ["$", "/x"], ["$", "/y"], ["$", "/z"]]]]])", json(nullptr)},
+        {"variable_shadowing", R"(["let", {"x": 10}, ["let", {"x": 20}, ["let", {"x": 30},
+            ["$", "/x"]]]])", json(nullptr)},
+        {"lambda_free_variable", R"(["let", {"k": 3}, ["map", ["$input"],
+            ["lambda", ["x"], ["*", ["$", "/x"], ["$", "/k"]]]]])", create_large_array(10000)},
+    };
+
+    for (const auto& workload : workloads) {
+        const auto& name = workload.name;
+        auto script = jsom::parse_document(workload.script);
+        std::vector<json> inputs = {workload.input};
+        auto program = computo::compile(script);
+        ASSERT_EQ(program.run(inputs), computo::execute(script, inputs)) << name;
+        auto interpreted_allocations
+            = count_allocations([&]() { (void)computo::execute(script, inputs); });
+        auto compiled_allocations = count_allocations([&]() { (void)program.run(inputs); });
+        std::cout << "Variable_Allocations " << name << ": interpreted " << interpreted_allocations
+                  << ", compiled " << compiled_allocations << "\n";
+
+        suite_->run_benchmark("Variable_Access_Interpreted", name,
+                              [&]() { (void)computo::execute(script, inputs); });
+        suite_->run_benchmark("Variable_Access_Compiled", name,
+                              [&]() { (void)program.run(inputs); });
+    }
 }
 
 // --- Real-world Scenario Benchmarks ---
@@ -949,3 +1192,977 @@ TEST_F(PerformanceBenchmarkTest, DebugOverheadBenchmark) {
         },
         1000);
 }
+
+// --- Compiled Program Benchmarks ---
+
+TEST_F(PerformanceBenchmarkTest, CompiledVsInterpretedBenchmark) {
+    struct Workload {
+        std::string name;
+        std::string script;
+        json input;
+        std::size_t data_size;
+    };
+
+    const std::vector<Workload> workloads = {
+        {"arithmetic", R"(["+", ["*", 2, 3], ["-", 10, 5], ["/", 20, 4], ["%", 17, 5]])",
+         json(nullptr), 1},
+        {"control_flow", R"(["let", [["x", 10], ["y", 20]],
+            ["if", [">", ["$", "/x"], ["$", "/y"]], ["-", ["$", "/x"], ["$", "/y"]],
+                ["if", ["==", ["$", "/x"], 10], ["*", ["$", "/y"], 2], 0]]])",
+         json(nullptr), 1},
+        {"object_build", R"(["obj", "a", ["+", 1, 2], "b", ["strConcat", "x", "y"],
+            "c", ["merge", {"k": 1}, {"l": 2}], "d", [1, ["+", 1, 1], 3]])",
+         json(nullptr), 1},
+        {"map_pipeline", R"(["reduce",
+            ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]],
+                       ["lambda", ["x"], [">", ["$", "/x"], 100]]],
+            ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]], 0])",
+         create_large_array(1000), 1000},
+    };
+
+    for (const auto& workload : workloads) {
+        auto script = jsom::parse_document(workload.script);
+        auto program = computo::compile(script);
+        std::vector<json> inputs = {workload.input};
+        ASSERT_EQ(program.run(inputs), computo::execute(script, inputs)) << workload.name;
+
+        suite_->run_benchmark(
+            "Compile_Interpreted", workload.name,
+            [&script, &inputs]() { (void)computo::execute(script, inputs); },
+            workload.data_size);
+        suite_->run_benchmark(
+            "Compile_Compiled", workload.name, [&program, &inputs]() { (void)program.run(inputs); },
+            workload.data_size);
+    }
+
+    // One-off cost of compiling, to compare against a single interpreted run
+    auto pipeline = jsom::parse_document(workloads.back().script);
+    suite_->run_benchmark("Compile_Cost", "map_pipeline",
+                          [&pipeline]() { (void)computo::compile(pipeline); });
+}
+
+// --- Operator Dispatch Benchmarks ---
+
+TEST_F(PerformanceBenchmarkTest, OperatorDispatchBenchmark) {
+    auto& registry = computo::OperatorRegistry::get_instance();
+    const auto names = registry.get_operator_names();
+    constexpr std::size_t LOOKUPS = 100000;
+
+    std::vector<computo::OpCode> opcodes;
+    opcodes.reserve(names.size());
+    for (const auto& name : names) {
+        opcodes.push_back(*registry.find_opcode(name));
+    }
+
+    std::size_t sink = 0;
+    suite_->run_benchmark(
+        "Dispatch_Lookup", "by_name",
+        [&]() {
+            for (std::size_t i = 0; i < LOOKUPS; ++i) {
+                sink += registry.get_operator(names[i % names.size()]) != nullptr ? 1 : 0;
+            }
+        },
+        LOOKUPS, 20);
+    suite_->run_benchmark(
+        "Dispatch_Lookup", "by_opcode",
+        [&]() {
+            for (std::size_t i = 0; i < LOOKUPS; ++i) {
+                sink += registry.get_operator(opcodes[i % opcodes.size()]) != nullptr ? 1 : 0;
+            }
+        },
+        LOOKUPS, 20);
+    EXPECT_GT(sink, 0U);
+
+    // End to end: a reduce-heavy script, interpreted (name lookup per node) vs compiled
+    auto script = jsom::parse_document(R"(["reduce", ["$input"],
+        ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["*", ["$", "/x"], 2]]], 0])");
+    std::vector<json> inputs = {create_large_array(1000)};
+    auto program = computo::compile(script);
+    suite_->run_benchmark(
+        "Dispatch_Reduce", "interpreted",
+        [&]() { (void)computo::execute(script, inputs); }, 1000);
+    suite_->run_benchmark(
+        "Dispatch_Reduce", "compiled", [&]() { (void)program.run(inputs); }, 1000);
+}
+
+// --- Argument Passing Allocation Benchmarks ---
+
+TEST_F(PerformanceBenchmarkTest, ArgumentPassingAllocationBenchmark) {
+    // Deeply nested arithmetic, each level carrying a large literal array that
+    // used to be deep-copied into the argument list of every enclosing call
+    constexpr int NESTING_DEPTH = 50;
+    std::string big_literal = "[0";
+    for (int i = 1; i < 200; ++i) {
+        big_literal += ", " + std::to_string(i);
+    }
+    big_literal += "]";
+    std::string nested = "0";
+    for (int i = 0; i < NESTING_DEPTH; ++i) {
+        nested = R"(["+", ["count", {"array": )" + big_literal + "}], " + nested + "]";
+    }
+
+    auto script = jsom::parse_document(nested);
+    auto program = computo::compile(script);
+    ASSERT_EQ(program.run(), json(200 * NESTING_DEPTH));
+
+    // Reference: what materialising every call's argument list costs
+    std::function<void(const json&)> copy_arguments = [&](const json& expr) {
+        if (!expr.is_array() || expr.empty() || !expr[0].is_string()) {
+            return;
+        }
+        json args = json::make_array();
+        for (std::size_t i = 1; i < expr.size(); ++i) {
+            args.push_back(expr[i]);
+            copy_arguments(expr[i]);
+        }
+    };
+
+    auto copied = count_allocations([&]() { copy_arguments(script); });
+    auto interpreted = count_allocations([&]() { (void)computo::execute(script); });
+    auto compiled = count_allocations([&]() { (void)program.run(); });
+
+    std::cout << "\nAllocations per evaluation (depth " << NESTING_DEPTH << "):\n"
+              << "  argument copies alone: " << copied << "\n"
+              << "  interpreted:           " << interpreted << "\n"
+              << "  compiled:              " << compiled << "\n";
+    EXPECT_LT(interpreted, copied);
+
+    suite_->run_benchmark(
+        "ArgPassing_Nested", "interpreted", [&script]() { (void)computo::execute(script); },
+        NESTING_DEPTH);
+    suite_->run_benchmark(
+        "ArgPassing_Nested", "compiled", [&program]() { (void)program.run(); }, NESTING_DEPTH);
+}
+
+// --- Execution Path Tracking Benchmarks ---
+
+TEST_F(PerformanceBenchmarkTest, PathTrackingAllocationBenchmark) {
+    // Straight-line scripts (no branches), so every compiled node is evaluated
+    // exactly once and allocations can be reported per evaluated node
+    constexpr int ELEMENTS = 100;
+    constexpr int NESTING_DEPTH = 50;
+    std::string elements = "[";
+    for (int i = 0; i < ELEMENTS; ++i) {
+        elements += (i == 0 ? "" : ", ") + std::string(R"(["and", ["<", )") + std::to_string(i)
+                    + R"(, 1000], ["==", )" + std::to_string(i) + ", " + std::to_string(i) + "]]";
+    }
+    elements += "]";
+    std::string nested = "true";
+    for (int i = 0; i < NESTING_DEPTH; ++i) {
+        nested = R"(["==", )" + nested + ", true]";
+    }
+
+    // Reference: copying a std::vector<std::string> breadcrumb and appending a
+    // formatted segment for every evaluated argument
+    std::function<void(const json&, const std::vector<std::string>&)> copy_paths
+        = [&](const json& expr, const std::vector<std::string>& path) {
+              if (!expr.is_array() || expr.empty()) {
+                  return;
+              }
+              std::size_t first = expr[0].is_string() ? 1 : 0;
+              for (std::size_t i = first; i < expr.size(); ++i) {
+                  auto child_path = path;
+                  child_path.push_back(first == 1 ? "arg" + std::to_string(i - 1)
+                                                  : std::to_string(i));
+                  copy_paths(expr[i], child_path);
+              }
+          };
+
+    std::cout << "\nAllocations per evaluated node:\n";
+    for (const auto& [name, text] : std::vector<std::pair<std::string, std::string>>{
+             {"literal_array_of_comparisons", elements}, {"nested_comparisons", nested}}) {
+        auto script = jsom::parse_document(text);
+        auto program = computo::compile(script);
+        auto nodes = static_cast<double>(program.node_count());
+        ASSERT_EQ(program.run(), computo::execute(script)) << name;
+
+        auto reference = count_allocations([&]() { copy_paths(script, {}); });
+        auto interpreted = count_allocations([&]() { (void)computo::execute(script); });
+        auto compiled = count_allocations([&]() { (void)program.run(); });
+        std::cout << "  " << name << " (" << program.node_count() << " nodes): "
+                  << "path copies alone " << static_cast<double>(reference) / nodes
+                  << ", interpreted " << static_cast<double>(interpreted) / nodes
+                  << ", compiled " << static_cast<double>(compiled) / nodes << "\n";
+
+        suite_->run_benchmark(
+            "PathTracking_Interpreted", name, [&script]() { (void)computo::execute(script); },
+            program.node_count());
+        suite_->run_benchmark(
+            "PathTracking_Compiled", name, [&program]() { (void)program.run(); },
+            program.node_count());
+    }
+}
+
+// --- Bytecode Backend Benchmarks ---
+
+TEST_F(PerformanceBenchmarkTest, BytecodeBackendBenchmark) {
+    struct Category {
+        std::string name;
+        std::string script;
+        json input;
+        std::size_t data_size;
+    };
+
+    // Each category leans on one group of VM instructions; "fallback" mixes in
+    // operators that the VM hands back to the tree
+    const std::vector<Category> categories = {
+        {"arithmetic", R"(["map", ["$input"], ["lambda", ["x"],
+            ["+", ["*", ["$", "/x"], 3], ["-", ["$", "/x"], 5], ["/", ["$", "/x"], 4],
+                  ["%", ["$", "/x"], 7]]]])",
+         create_large_array(1000), 1000},
+        {"comparison_logic", R"(["filter", ["$input"], ["lambda", ["x"],
+            ["and", [">=", ["$", "/x"], 100], ["not", ["==", ["%", ["$", "/x"], 3], 0]],
+                    ["or", ["<", ["$", "/x"], 500], [">", ["$", "/x"], 900]]]]])",
+         create_large_array(1000), 1000},
+        {"control_flow", R"(["map", ["$input"], ["lambda", ["x"],
+            ["let", {"y": ["*", ["$", "/x"], 2]},
+                ["if", [">", ["$", "/y"], 1000], ["-", ["$", "/y"], 1000],
+                    ["if", [">", ["$", "/y"], 500], ["$", "/y"], 0]]]]])",
+         create_large_array(1000), 1000},
+        {"variables_input", R"(["let", {"scale": 3, "config": {"offset": [1, 2, 3]}},
+            ["map", ["$input", "/items"], ["lambda", ["x"],
+                ["+", ["*", ["$", "/x"], ["$", "/scale"]], ["$", "/config/offset/2"]]]]])",
+         json{{"items", create_large_array(1000)}}, 1000},
+        {"array_pipeline", R"(["reduce",
+            ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]],
+                       ["lambda", ["x"], [">", ["$", "/x"], 100]]],
+            ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]], 0])",
+         create_large_array(1000), 1000},
+        {"fallback", R"(["map", ["$input"], ["lambda", ["x"],
+            ["+", ["count", ["cdr", [1, 2, ["$", "/x"]]]], ["$", "/x"]]]])",
+         create_large_array(1000), 1000},
+    };
+
+    std::vector<std::pair<std::string, double>> speedups;
+    for (const auto& category : categories) {
+        auto script = jsom::parse_document(category.script);
+        auto tree = computo::compile(script);
+        auto bytecode = computo::compile(script, "array", computo::Backend::Bytecode);
+        std::vector<json> inputs = {category.input};
+        ASSERT_EQ(bytecode.run(inputs), tree.run(inputs)) << category.name;
+
+        auto tree_result = suite_->run_benchmark(
+            "Backend_Tree", category.name, [&]() { (void)tree.run(inputs); }, category.data_size);
+        auto bytecode_result = suite_->run_benchmark(
+            "Backend_Bytecode", category.name, [&]() { (void)bytecode.run(inputs); },
+            category.data_size);
+        speedups.emplace_back(category.name, tree_result.avg_time_ms / bytecode_result.avg_time_ms);
+    }
+
+    std::cout << "\nBytecode speedup over the tree backend:\n";
+    for (const auto& [name, speedup] : speedups) {
+        std::cout << "  " << name << ": " << speedup << "x\n";
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, ConstantFoldingBenchmark) {
+    // Generated-script shape: constants recomputed for every element
+    auto script = jsom::parse_document(R"(["map", ["$input"], ["lambda", ["x"],
+        ["obj", ["strConcat", "prefix", "_", "seconds"], ["*", ["$", "/x"], ["*", 60, 60, 24]],
+                "limits", [["*", 1024, 1024], ["+", 100, ["*", 2, 50]]],
+                "label", ["strConcat", "a", "b", "c"]]]])");
+    auto program = computo::compile(script);
+    const auto& folded = program.script();
+    std::vector<json> inputs = {create_large_array(1000)};
+    ASSERT_EQ(computo::execute(folded, inputs), computo::execute(script, inputs));
+
+    // Both run on the interpreter so only the folding differs
+    auto original = suite_->run_benchmark(
+        "ConstantFolding", "original",
+        [&]() { (void)computo::execute(script, inputs); }, 1000);
+    auto optimized = suite_->run_benchmark(
+        "ConstantFolding", "folded",
+        [&]() { (void)computo::execute(folded, inputs); }, 1000);
+
+    std::cout << "\nConstant folding: " << program.stats().folded_nodes << " nodes folded, "
+              << original.avg_time_ms / optimized.avg_time_ms << "x speedup\n";
+}
+
+TEST_F(PerformanceBenchmarkTest, LoopInvariantHoistingBenchmark) {
+    // The predicate's second operand depends only on the input: O(n * k)
+    // interpreted, O(n + k) once hoisted out of the lambda
+    auto script = jsom::parse_document(R"(["filter", ["$input", "/items"], ["lambda", ["x"],
+        [">", ["$", "/x"], ["-", ["count", ["$input", "/allowed"]], ["$input", "/config/offset"]]]]])");
+    auto program = computo::compile(script);
+    ASSERT_EQ(program.stats().hoisted_nodes, 1U);
+
+    constexpr std::size_t ITEMS = 1000;
+    std::vector<std::pair<std::size_t, double>> speedups;
+    for (std::size_t allowed : {10, 100, 1000}) {
+        json input = json::make_object();
+        input.set("items", create_large_array(ITEMS));
+        input.set("allowed", create_large_array(allowed));
+        input.set("config", json{{"offset", 5}});
+        std::vector<json> inputs = {input};
+        ASSERT_EQ(program.run(inputs), computo::execute(script, inputs));
+
+        auto label = "k=" + std::to_string(allowed);
+        auto interpreted = suite_->run_benchmark(
+            "LoopInvariant_Interpreted", label, [&]() { (void)computo::execute(script, inputs); },
+            ITEMS);
+        auto hoisted = suite_->run_benchmark(
+            "LoopInvariant_Hoisted", label, [&]() { (void)program.run(inputs); }, ITEMS);
+        speedups.emplace_back(allowed, interpreted.avg_time_ms / hoisted.avg_time_ms);
+    }
+
+    std::cout << "\nLoop-invariant hoisting speedup over the interpreter:\n";
+    for (const auto& [allowed, speedup] : speedups) {
+        std::cout << "  k=" << allowed << ": " << speedup << "x\n";
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, FusedPipelineBenchmark) {
+    // The same pipeline chained (fused into one pass) and with every stage
+    // bound to a variable, which materializes each intermediate array
+    auto chained = computo::compile(jsom::parse_document(R"(["reduce",
+        ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]],
+                   ["lambda", ["x"], ["==", ["%", ["$", "/x"], 3], 0]]],
+        ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]], 0])"));
+    auto staged = computo::compile(jsom::parse_document(R"(["let",
+        [["mapped", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]]]],
+        ["let", [["filtered", ["filter", ["$", "/mapped"],
+                                         ["lambda", ["x"], ["==", ["%", ["$", "/x"], 3], 0]]]]],
+            ["reduce", ["$", "/filtered"],
+                       ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]], 0]]])"));
+
+    constexpr std::size_t ELEMENTS = 1000000;
+    std::vector<json> inputs = {create_large_array(ELEMENTS)};
+    ASSERT_EQ(chained.run(inputs), staged.run(inputs));
+
+    auto time_ms = [&](const computo::Program& program) {
+        auto start = high_resolution_clock::now();
+        (void)program.run(inputs);
+        return duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e6;
+    };
+    auto staged_ms = time_ms(staged);
+    auto chained_ms = time_ms(chained);
+    auto staged_kb = measure_peak_rss_growth_kb([&]() { (void)staged.run(inputs); });
+    auto chained_kb = measure_peak_rss_growth_kb([&]() { (void)chained.run(inputs); });
+
+    std::cout << "\nmap -> filter -> reduce over " << ELEMENTS << " elements:\n"
+              << "  materialized stages: " << staged_ms << " ms, peak RSS +" << staged_kb << " KB\n"
+              << "  fused chain:         " << chained_ms << " ms, peak RSS +" << chained_kb
+              << " KB\n";
+}
+
+TEST_F(PerformanceBenchmarkTest, BorrowedArrayMemoryBenchmark) {
+    // count, car and reduce only read their array argument, and let shares the
+    // value it binds, so an array taken from the input or a variable is never
+    // copied. Routing the same array through "if" makes it a computed value,
+    // which still is.
+    struct Case {
+        const char* name;
+        json borrowed;
+        json copied;
+        long borrowed_kb{0};
+        long copied_kb{0};
+    };
+    std::vector<Case> cases = {
+        {"count $input", jsom::parse_document(R"(["count", ["$input", "/items"]])"),
+         jsom::parse_document(R"(["count", ["if", true, ["$input", "/items"], null]])")},
+        {"car $input", jsom::parse_document(R"(["car", ["$input", "/items"]])"),
+         jsom::parse_document(R"(["car", ["if", true, ["$input", "/items"], null]])")},
+        {"car variable",
+         jsom::parse_document(R"(["let", [["xs", ["$input", "/items"]]], ["car", ["$", "/xs"]]])"),
+         jsom::parse_document(
+             R"(["let", [["xs", ["if", true, ["$input", "/items"], null]]], ["car", ["$", "/xs"]]])")},
+        {"reduce variable",
+         jsom::parse_document(R"(["let", [["xs", ["$input", "/items"]]],
+             ["reduce", ["$", "/xs"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0]])"),
+         jsom::parse_document(R"(["let", [["xs", ["if", true, ["$input", "/items"], null]]],
+             ["reduce", ["$", "/xs"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0]])")},
+    };
+
+    constexpr std::size_t ELEMENTS = 1000000;
+    constexpr int RUNS = 5;
+    // Built once, before measuring: only what the script itself allocates counts
+    computo::ExecutionContext ctx(json{{"items", create_large_array(ELEMENTS)}});
+
+    // Memory first, while no freed pages are left over to be reused
+    for (auto& test_case : cases) {
+        test_case.borrowed_kb =
+            measure_peak_rss_growth_kb([&]() { (void)computo::evaluate(test_case.borrowed, ctx); });
+        test_case.copied_kb =
+            measure_peak_rss_growth_kb([&]() { (void)computo::evaluate(test_case.copied, ctx); });
+    }
+
+    auto time_ms = [&](const json& script) {
+        auto start = high_resolution_clock::now();
+        for (int i = 0; i < RUNS; ++i) {
+            (void)computo::evaluate(script, ctx);
+        }
+        return duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e6
+               / RUNS;
+    };
+    std::cout << "\nRead-only array arguments over " << ELEMENTS << " elements:\n";
+    for (const auto& test_case : cases) {
+        ASSERT_EQ(computo::evaluate(test_case.borrowed, ctx), computo::evaluate(test_case.copied, ctx));
+        std::cout << "  " << test_case.name << ": borrowed " << time_ms(test_case.borrowed)
+                  << " ms, peak RSS +" << test_case.borrowed_kb << " KB; copied "
+                  << time_ms(test_case.copied) << " ms, peak RSS +" << test_case.copied_kb
+                  << " KB\n";
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, ParallelMapScalingBenchmark) {
+    // A map and a filter whose lambdas do enough work per element for chunks
+    // to pay for their scheduling
+    auto map = computo::compile(jsom::parse_document(R"(["map", ["$input"], ["lambda", ["x"],
+        ["reduce", {"array": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16]},
+                   ["lambda", ["acc", "k"], ["+", ["$", "/acc"], ["*", ["$", "/x"], ["$", "/k"]]]], 0]]])"));
+    auto filter = computo::compile(jsom::parse_document(R"(["filter", ["$input"], ["lambda", ["x"],
+        ["==", ["%", ["reduce", {"array": [1, 2, 3, 4, 5, 6, 7, 8]},
+                                ["lambda", ["acc", "k"], ["+", ["$", "/acc"], ["*", ["$", "/x"], ["$", "/k"]]]], 0],
+              3], 0]]])"));
+
+    constexpr std::size_t ELEMENTS = 5000;
+    constexpr std::size_t RUNS = 5;
+    std::vector<json> inputs = {create_large_array(ELEMENTS)};
+    std::cout << "\nParallel map / filter over " << ELEMENTS << " elements ("
+              << std::thread::hardware_concurrency() << " hardware threads):\n";
+    for (const auto& [name, program] : {std::pair<const char*, const computo::Program&>{"map", map},
+                                        {"filter", filter}}) {
+        auto sequential = program.run(inputs);
+        double baseline_ms = 0;
+        for (std::size_t threads : {1, 2, 4, 8, 16}) {
+            computo::ParallelOptions options;
+            options.threads = threads;
+            ASSERT_EQ(program.run(inputs, nullptr, options), sequential);
+            auto result = suite_->run_benchmark(
+                std::string("ParallelScaling_") + name, std::to_string(threads) + " threads",
+                [&]() { (void)program.run(inputs, nullptr, options); }, ELEMENTS, RUNS);
+            if (threads == 1) {
+                baseline_ms = result.avg_time_ms;
+            }
+            std::cout << "  " << name << ", " << threads << " threads: " << result.avg_time_ms
+                      << " ms (" << baseline_ms / result.avg_time_ms << "x)\n";
+        }
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, ParallelReduceBenchmark) {
+    // Associative reducers fold chunks on the pool and combine the results as
+    // a tree; threads=1 is the sequential fold
+    auto objects = json::make_array();
+    for (int i = 0; i < 20000; ++i) {
+        objects.push_back(json{{"k" + std::to_string(i % 64), json(i)}});
+    }
+    std::vector<json> inputs = {json{{"items", create_large_array(100000)}, {"objects", objects}}};
+    struct Case {
+        const char* name;
+        computo::Program program;
+    };
+    std::vector<Case> cases = {
+        {"sum", computo::compile(jsom::parse_document(R"(["reduce", ["$input", "/items"],
+            ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0])"))},
+        {"max", computo::compile(jsom::parse_document(R"(["reduce", ["$input", "/items"],
+            ["lambda", ["a", "x"], ["if", [">", ["$", "/a"], ["$", "/x"]], ["$", "/a"], ["$", "/x"]]], 0])"))},
+        {"merge", computo::compile(jsom::parse_document(R"(["reduce", ["$input", "/objects"],
+            ["lambda", ["a", "x"], ["merge", ["$", "/a"], ["$", "/x"]]], {}])"))},
+    };
+
+    constexpr std::size_t RUNS = 5;
+    std::cout << "\nParallel reduce (" << std::thread::hardware_concurrency()
+              << " hardware threads):\n";
+    for (const auto& test_case : cases) {
+        auto sequential = test_case.program.run(inputs);
+        double baseline_ms = 0;
+        for (std::size_t threads : {1, 2, 4, 8, 16}) {
+            computo::ParallelOptions options;
+            options.threads = threads;
+            ASSERT_EQ(test_case.program.run(inputs, nullptr, options), sequential);
+            auto result = suite_->run_benchmark(
+                std::string("ParallelReduce_") + test_case.name, std::to_string(threads) + " threads",
+                [&]() { (void)test_case.program.run(inputs, nullptr, options); }, 0, RUNS);
+            if (threads == 1) {
+                baseline_ms = result.avg_time_ms;
+            }
+            std::cout << "  " << test_case.name << ", " << threads << " threads: "
+                      << result.avg_time_ms << " ms (" << baseline_ms / result.avg_time_ms << "x)\n";
+        }
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, ParallelArgumentsBenchmark) {
+    // Four independent filters over the same input, as obj values and as let
+    // bindings; with threads > 1 they are forked onto the pool together
+    const std::string filter = R"(["filter", ["$input"], ["lambda", ["x"], ["==", ["%", ["$", "/x"], K], 0]]])";
+    auto with_modulus = [&](int modulus) {
+        auto text = filter;
+        text.replace(text.find('K'), 1, std::to_string(modulus));
+        return text;
+    };
+    auto obj = computo::compile(jsom::parse_document(
+        R"(["obj", "by2", )" + with_modulus(2) + R"(, "by3", )" + with_modulus(3) + R"(, "by5", )"
+        + with_modulus(5) + R"(, "by7", )" + with_modulus(7) + "]"));
+    auto let = computo::compile(jsom::parse_document(
+        R"(["let", [["a", )" + with_modulus(2) + R"(], ["b", )" + with_modulus(3) + R"(], ["c", )"
+        + with_modulus(5) + R"(], ["d", )" + with_modulus(7)
+        + R"(]], ["append", ["$", "/a"], ["$", "/b"], ["$", "/c"], ["$", "/d"]]])"));
+
+    constexpr std::size_t ELEMENTS = 20000;
+    constexpr std::size_t RUNS = 5;
+    std::vector<json> inputs = {create_large_array(ELEMENTS)};
+    std::cout << "\nForked operator arguments (" << std::thread::hardware_concurrency()
+              << " hardware threads):\n";
+    for (const auto& [name, program] : {std::pair<const char*, const computo::Program&>{"obj", obj},
+                                        {"let", let}}) {
+        auto sequential = program.run(inputs);
+        double baseline_ms = 0;
+        for (std::size_t threads : {1, 2, 4, 8, 16}) {
+            computo::ParallelOptions options;
+            options.threads = threads;
+            options.min_elements = ELEMENTS + 1; // Only the arguments run in parallel
+            ASSERT_EQ(program.run(inputs, nullptr, options), sequential);
+            auto result = suite_->run_benchmark(
+                std::string("ParallelArguments_") + name, std::to_string(threads) + " threads",
+                [&]() { (void)program.run(inputs, nullptr, options); }, ELEMENTS, RUNS);
+            if (threads == 1) {
+                baseline_ms = result.avg_time_ms;
+            }
+            std::cout << "  " << name << ", " << threads << " threads: " << result.avg_time_ms
+                      << " ms (" << baseline_ms / result.avg_time_ms << "x)\n";
+        }
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, BatchThroughputBenchmark) {
+    // One script over many small independent documents: execute() per
+    // document, a compiled program per document, and execute_batch()
+    const auto script = jsom::parse_document(R"(["obj",
+        "id", ["$input", "/id"],
+        "total", ["reduce", ["$input", "/items"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0],
+        "large", ["count", ["filter", ["$input", "/items"], ["lambda", ["x"], [">", ["$", "/x"], 10]]]]])");
+    constexpr std::size_t DOCUMENTS = 2000;
+    constexpr std::size_t RUNS = 3;
+    std::vector<json> documents;
+    for (std::size_t i = 0; i < DOCUMENTS; ++i) {
+        documents.push_back(json{{"id", json(static_cast<int>(i))}, {"items", create_large_array(20)}});
+    }
+    auto report = [](const char* name, const BenchmarkResult& result) {
+        std::cout << "  " << name << ": " << result.avg_time_ms << " ms ("
+                  << static_cast<std::size_t>(DOCUMENTS * 1000.0 / result.avg_time_ms)
+                  << " documents/s)\n";
+    };
+
+    std::cout << "\nBatch throughput, " << DOCUMENTS << " documents ("
+              << std::thread::hardware_concurrency() << " hardware threads):\n";
+    report("execute() loop", suite_->run_benchmark("BatchThroughput", "execute loop", [&]() {
+        for (const auto& document : documents) {
+            (void)computo::execute(script, {document});
+        }
+    }, DOCUMENTS, RUNS));
+    auto program = computo::compile(script);
+    report("Program::run() loop", suite_->run_benchmark("BatchThroughput", "run loop", [&]() {
+        for (const auto& document : documents) {
+            (void)program.run({document});
+        }
+    }, DOCUMENTS, RUNS));
+    for (std::size_t threads : {1, 2, 4, 8, 16}) {
+        computo::BatchOptions options;
+        options.threads = threads;
+        auto results = computo::execute_batch(script, documents, options);
+        ASSERT_EQ(results.size(), DOCUMENTS);
+        ASSERT_EQ(results.back().value, computo::execute(script, {documents.back()}));
+        auto name = "batch, " + std::to_string(threads) + " threads";
+        report(name.c_str(), suite_->run_benchmark("BatchThroughput", name, [&]() {
+            (void)computo::execute_batch(script, documents, options);
+        }, DOCUMENTS, RUNS));
+    }
+}
+
+TEST_F(PerformanceBenchmarkTest, NdjsonThroughputBenchmark) {
+    // --ndjson over a stream of small records, against one process per record
+    constexpr std::size_t RECORDS = 200000;
+    auto dir = std::filesystem::temp_directory_path() / "computo_ndjson_bench";
+    std::filesystem::create_directories(dir);
+    auto script_file = dir / "script.json";
+    auto records_file = dir / "records.ndjson";
+    auto record_file = dir / "record.json";
+    std::ofstream(script_file) << R"(["obj", "id", ["$input", "/id"],
+        "total", ["reduce", ["$input", "/items"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0]])";
+    {
+        std::ofstream records(records_file);
+        for (std::size_t i = 0; i < RECORDS; ++i) {
+            records << R"({"id": )" << i << R"(, "level": "info", "items": [1, 2, 3, 4, 5, 6, 7, 8]})"
+                    << "\n";
+        }
+    }
+    std::ofstream(record_file) << R"({"id": 1, "level": "info", "items": [1, 2, 3, 4, 5, 6, 7, 8]})";
+
+    auto report = [](const std::string& name, std::size_t records, const CliRun& run) {
+        std::cout << "  " << name << ": " << run.time_ms << " ms, "
+                  << static_cast<std::size_t>(records * 1000.0 / run.time_ms) << " records/s, peak RSS "
+                  << run.peak_rss_kb << " KB\n";
+    };
+    std::cout << "\nNDJSON throughput, " << RECORDS << " records ("
+              << std::filesystem::file_size(records_file) / 1024 << " KB):\n";
+    constexpr std::size_t PROCESSES = 100;
+    CliRun per_process;
+    for (std::size_t i = 0; i < PROCESSES; ++i) {
+        auto run = run_cli("--script " + script_file.string() + " " + record_file.string()
+                           + " > /dev/null");
+        ASSERT_EQ(run.exit_code, 0);
+        per_process.time_ms += run.time_ms;
+        per_process.peak_rss_kb = std::max(per_process.peak_rss_kb, run.peak_rss_kb);
+    }
+    report("one process per record", PROCESSES, per_process);
+    for (std::size_t threads : {1, 4}) {
+        auto run = run_cli("--script " + script_file.string() + " --ndjson --threads="
+                           + std::to_string(threads) + " < " + records_file.string() + " > /dev/null");
+        ASSERT_EQ(run.exit_code, 0);
+        report("--ndjson, " + std::to_string(threads) + " threads", RECORDS, run);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(PerformanceBenchmarkTest, InputFileLoadingBenchmark) {
+    // load_json_file's former path (a byte-at-a-time copy into a string, then
+    // a parse of the string) against parsing straight from a mapped file. Set
+    // COMPUTO_BENCH_LARGE_INPUTS to add a 1 GB input.
+    std::vector<std::size_t> sizes_mb = {100};
+    if (std::getenv("COMPUTO_BENCH_LARGE_INPUTS") != nullptr) {
+        sizes_mb.push_back(1024);
+    }
+    auto dir = std::filesystem::temp_directory_path() / "computo_load_bench";
+    std::filesystem::create_directories(dir);
+    auto script_file = dir / "script.json";
+    std::ofstream(script_file) << "true";
+
+    for (auto size_mb : sizes_mb) {
+        auto input_file = dir / ("input_" + std::to_string(size_mb) + "mb.json");
+        {
+            std::ofstream input(input_file);
+            input << "[";
+            const std::string record
+                = R"({"id": 123456, "name": "event name", "tags": ["a", "b", "c"], "value": 3.25})";
+            std::size_t written = 1;
+            for (bool first = true; written < size_mb * 1024 * 1024; first = false) {
+                input << (first ? "" : ",\n") << record;
+                written += record.size() + 2;
+            }
+            input << "]";
+        }
+
+        auto measure = [](const char* name, const std::function<void()>& load) {
+            auto start = steady_clock::now();
+            auto rss_kb = measure_peak_rss_growth_kb(load);
+            auto ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+            std::cout << "  " << name << ": " << ms << " ms, peak RSS +" << rss_kb / 1024
+                      << " MB\n";
+        };
+        std::cout << "\nLoading a " << size_mb << " MB input:\n";
+        measure("istreambuf copy + parse", [&]() {
+            std::ifstream file(input_file);
+            std::string content((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+            (void)jsom::parse_document(content);
+        });
+        measure("mmap + parse", [&]() {
+            computo::MappedFile file(input_file.string());
+            (void)jsom::parse_document(file.view());
+        });
+        auto cli = run_cli("--script " + script_file.string() + " " + input_file.string()
+                           + " > /dev/null");
+        ASSERT_EQ(cli.exit_code, 0);
+        std::cout << "  CLI run: " << cli.time_ms << " ms, peak RSS " << cli.peak_rss_kb / 1024
+                  << " MB\n";
+        std::filesystem::remove(input_file);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(PerformanceBenchmarkTest, MultiFileStartupBenchmark) {
+    // CLI startup with N x 50 MB inputs, which are loaded and parsed
+    // concurrently, against parsing the same files one after another
+    constexpr std::size_t FILE_MB = 50;
+    auto dir = std::filesystem::temp_directory_path() / "computo_startup_bench";
+    std::filesystem::create_directories(dir);
+    auto script_file = dir / "script.json";
+    std::ofstream(script_file) << R"(["count", ["$inputs"]])";
+
+    std::vector<std::string> files;
+    for (std::size_t n = 0; n < 8; ++n) {
+        auto input_file = dir / ("input_" + std::to_string(n) + ".json");
+        std::ofstream input(input_file);
+        input << "[";
+        const std::string record = R"({"id": )" + std::to_string(n)
+                                   + R"(, "name": "event name", "tags": ["a", "b"], "value": 3.25})";
+        for (std::size_t written = 1; written < FILE_MB * 1024 * 1024;
+             written += record.size() + 2) {
+            input << (written == 1 ? "" : ",\n") << record;
+        }
+        input << "]";
+        files.push_back(input_file.string());
+    }
+
+    std::cout << "\nCLI startup with N x " << FILE_MB << " MB inputs ("
+              << std::thread::hardware_concurrency() << " hardware threads):\n";
+    for (std::size_t count : {1, 2, 4, 8}) {
+        std::string args = "--script " + script_file.string();
+        for (std::size_t n = 0; n < count; ++n) {
+            args += " " + files[n];
+        }
+        auto start = steady_clock::now();
+        for (std::size_t n = 0; n < count; ++n) {
+            computo::MappedFile file(files[n]);
+            (void)jsom::parse_document(file.view());
+        }
+        auto sequential_ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        auto run = run_cli(args + " > /dev/null");
+        ASSERT_EQ(run.exit_code, 0);
+        std::cout << "  " << count << " files: CLI " << run.time_ms << " ms (sequential parse "
+                  << sequential_ms << " ms), peak RSS " << run.peak_rss_kb / 1024 << " MB\n";
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(PerformanceBenchmarkTest, LazyInputParsingBenchmark) {
+    // A script reading a few paths of a large event dump: full parse against
+    // parse_selected(), in process and through the CLI's --lazy-input. Set
+    // COMPUTO_BENCH_LARGE_INPUTS to add a 1 GB dump.
+    std::vector<std::size_t> sizes_mb = {100};
+    if (std::getenv("COMPUTO_BENCH_LARGE_INPUTS") != nullptr) {
+        sizes_mb.push_back(1024);
+    }
+    auto dir = std::filesystem::temp_directory_path() / "computo_lazy_bench";
+    std::filesystem::create_directories(dir);
+    auto script_file = dir / "script.json";
+    std::ofstream(script_file) << R"(["strConcat", ["$input", "/meta/source"], ":",
+        ["$input", "/events/5/payload/name"]])";
+    auto pointers = computo::compile(jsom::parse_document(R"(["strConcat",
+        ["$input", "/meta/source"], ["$input", "/events/5/payload/name"]])"))
+                        .input_access()
+                        .pointers[0];
+
+    for (auto size_mb : sizes_mb) {
+        auto input_file = dir / ("events_" + std::to_string(size_mb) + "mb.json");
+        {
+            std::ofstream input(input_file);
+            input << R"({"meta": {"source": "bench", "version": 2}, "events": [)";
+            const std::string event = R"({"id": 42, "level": "info", "tags": ["a", "b"],)"
+                                      R"( "payload": {"name": "event", "value": 3.25}})";
+            for (std::size_t written = 0; written < size_mb * 1024 * 1024;
+                 written += event.size() + 2) {
+                input << (written == 0 ? "" : ",\n") << event;
+            }
+            input << "]}";
+        }
+
+        auto measure = [](const char* name, const std::function<void()>& load) {
+            auto start = steady_clock::now();
+            auto rss_kb = measure_peak_rss_growth_kb(load);
+            auto ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+            std::cout << "  " << name << ": " << ms << " ms, peak RSS +" << rss_kb / 1024
+                      << " MB\n";
+        };
+        std::cout << "\nReading 2 paths of a " << size_mb << " MB event dump:\n";
+        computo::MappedFile file(input_file.string());
+        measure("full parse", [&]() { (void)jsom::parse_document(file.view()); });
+        measure("parse_selected", [&]() { (void)computo::parse_selected(file.view(), pointers); });
+        for (const auto* flags : {"", " --lazy-input"}) {
+            auto run = run_cli("--script " + script_file.string() + " " + input_file.string()
+                               + flags + " > /dev/null");
+            ASSERT_EQ(run.exit_code, 0);
+            std::cout << "  CLI" << flags << ": " << run.time_ms << " ms, peak RSS "
+                      << run.peak_rss_kb / 1024 << " MB\n";
+        }
+        std::filesystem::remove(input_file);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(PerformanceBenchmarkTest, OutputSerializationBenchmark) {
+    // Writing a large compact result (as --ndjson and the server do): building
+    // it as one string and writing that, against streaming it through an
+    // OutputSink. Set COMPUTO_BENCH_LARGE_INPUTS to add a 1 GB result. The CLI
+    // run pretty-prints, which jsom still does as one string.
+    std::vector<std::size_t> sizes_mb = {100};
+    if (std::getenv("COMPUTO_BENCH_LARGE_INPUTS") != nullptr) {
+        sizes_mb.push_back(1024);
+    }
+    auto dir = std::filesystem::temp_directory_path() / "computo_output_bench";
+    std::filesystem::create_directories(dir);
+    auto script_file = dir / "script.json";
+    std::ofstream(script_file) << R"(["$input"])";
+    auto record = jsom::parse_document(
+        R"({"id": 123456, "name": "event name", "tags": ["a", "b", "c"], "value": 3.25})");
+    auto record_bytes = record.to_json().size();
+
+    for (auto size_mb : sizes_mb) {
+        auto result = json::make_array();
+        for (std::size_t written = 0; written < size_mb * 1024 * 1024; written += record_bytes) {
+            result.push_back(record);
+        }
+
+        auto measure = [](const char* name, const std::function<void()>& write) {
+            auto start = steady_clock::now();
+            auto rss_kb = measure_peak_rss_growth_kb(write);
+            auto ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+            std::cout << "  " << name << ": " << ms << " ms, peak RSS +" << rss_kb / 1024
+                      << " MB\n";
+        };
+        std::cout << "\nWriting a ~" << size_mb << " MB compact result to /dev/null:\n";
+        measure("to_json() + ofstream", [&]() {
+            std::ofstream out("/dev/null");
+            out << result.to_json() << "\n";
+        });
+        measure("write_json", [&]() {
+            std::FILE* out = std::fopen("/dev/null", "w");
+            {
+                computo::OutputSink sink(fileno(out));
+                computo::write_json(sink, result, false);
+            }
+            std::fclose(out);
+        });
+
+        auto input_file = dir / ("result_" + std::to_string(size_mb) + "mb.json");
+        std::ofstream(input_file) << result.to_json();
+        result = json(nullptr);
+        auto run = run_cli("--script " + script_file.string() + " " + input_file.string()
+                           + " > /dev/null");
+        ASSERT_EQ(run.exit_code, 0);
+        std::cout << "  CLI run: " << run.time_ms << " ms, peak RSS " << run.peak_rss_kb / 1024
+                  << " MB\n";
+        std::filesystem::remove(input_file);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(PerformanceBenchmarkTest, ScriptColdStartBenchmark) {
+    // Cold-start latency of short CLI runs with the script as JSON, as sugar
+    // and compiled (.computoc), plus the in-process load step each one takes.
+    // A compiled file skips the JSON parse only; compile() runs for all three.
+    constexpr std::size_t BINDINGS = 300;
+    constexpr std::size_t PROCESSES = 50;
+    auto dir = std::filesystem::temp_directory_path() / "computo_cold_start_bench";
+    std::filesystem::create_directories(dir);
+    auto json_file = dir / "script.json";
+    auto sugar_file = dir / "script.sugar"; // No .computo extension: format auto-detected
+    auto compiled_file = dir / "script.computoc";
+    auto input_file = dir / "input.json";
+    std::ofstream(input_file) << R"({"a": 2, "b": [1, 2, 3]})";
+
+    std::string json_text = R"(["let", [)";
+    std::string sugar_text = "let ";
+    for (std::size_t i = 0; i < BINDINGS; ++i) {
+        auto name = "v" + std::to_string(i);
+        auto previous = i == 0 ? std::string(R"(["$input", "/a"])")
+                               : R"(["$", "/v)" + std::to_string(i - 1) + R"("])";
+        json_text += (i == 0 ? "" : ",\n") + std::string(R"([")") + name + R"(", ["+", )"
+                     + previous + R"(, ["count", ["$input", "/b"]]]])";
+        sugar_text += (i == 0 ? "" : ",\n    ") + name + " = "
+                      + (i == 0 ? std::string("$input/a") : "v" + std::to_string(i - 1))
+                      + " + count($input/b)";
+    }
+    json_text += R"(], ["$", "/v)" + std::to_string(BINDINGS - 1) + R"("]])";
+    sugar_text += "\nin v" + std::to_string(BINDINGS - 1);
+    std::ofstream(json_file) << json_text;
+    std::ofstream(sugar_file) << sugar_text;
+    ASSERT_EQ(run_cli("--script " + json_file.string() + " --compile-to "
+                      + compiled_file.string()).exit_code, 0);
+
+    auto script = jsom::parse_document(json_text);
+    auto bytes = computo::encode_script_cache(script, "array");
+    std::cout << "\nLoading a script of " << BINDINGS << " let bindings (" << json_text.size()
+              << " bytes as JSON, " << bytes.size() << " compiled):\n";
+    auto report = [](const char* name, const BenchmarkResult& result) {
+        std::cout << "  " << name << ": " << result.avg_time_ms * 1000 << " us\n";
+    };
+    report("JSON parse", suite_->run_benchmark("ColdStart", "JSON parse", [&]() {
+        (void)jsom::parse_document(json_text);
+    }, 1, 200));
+    report("compiled decode", suite_->run_benchmark("ColdStart", "decode", [&]() {
+        (void)computo::decode_script_cache(bytes);
+    }, 1, 200));
+    report("compile()", suite_->run_benchmark("ColdStart", "compile", [&]() {
+        (void)computo::compile(script);
+    }, 1, 200));
+
+    for (const auto& file : {json_file, sugar_file, compiled_file}) {
+        double total_ms = 0;
+        for (std::size_t i = 0; i < PROCESSES; ++i) {
+            auto run = run_cli("--script " + file.string() + " " + input_file.string()
+                               + " > /dev/null");
+            ASSERT_EQ(run.exit_code, 0) << file;
+            total_ms += run.time_ms;
+        }
+        std::cout << "  CLI " << file.filename().string() << ": "
+                  << total_ms / PROCESSES << " ms per run\n";
+    }
+    std::filesystem::remove_all(dir);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(PerformanceBenchmarkTest, ServerThroughputBenchmark) {
+    // Requests/s and client-side p50 / p99 latency of --serve over a Unix
+    // socket for N concurrent clients, against one CLI process per request
+    constexpr std::size_t REQUESTS_PER_CLIENT = 2000;
+    constexpr std::size_t PROCESSES = 50;
+    auto dir = std::filesystem::temp_directory_path() / "computo_server_bench";
+    std::filesystem::create_directories(dir);
+    auto script_file = dir / "transform.json";
+    auto record_file = dir / "record.json";
+    auto socket_path = (dir / "computo.sock").string();
+    const std::string record = R"({"id": 7, "level": "info", "items": [1, 2, 3, 4, 5, 6, 7, 8]})";
+    std::ofstream(script_file) << R"(["obj", "id", ["$input", "/id"],
+        "total", ["reduce", ["$input", "/items"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0]])";
+    std::ofstream(record_file) << record;
+
+    auto percentile = [](std::vector<double>& samples, double percent) {
+        std::sort(samples.begin(), samples.end());
+        auto index = static_cast<std::size_t>(percent / 100.0 * (samples.size() - 1));
+        return samples[index];
+    };
+
+    std::vector<double> process_ms;
+    for (std::size_t i = 0; i < PROCESSES; ++i) {
+        auto run = run_cli("--script " + script_file.string() + " " + record_file.string()
+                           + " > /dev/null");
+        ASSERT_EQ(run.exit_code, 0);
+        process_ms.push_back(run.time_ms);
+    }
+    std::cout << "\nSmall transform per request (" << std::thread::hardware_concurrency()
+              << " hardware threads):\n";
+    std::cout << "  one process per request: p50 " << percentile(process_ms, 50) * 1000
+              << " us, p99 " << percentile(process_ms, 99) * 1000 << " us\n";
+
+    auto server = test_utils::start_server(COMPUTO_BINARY_PATH, socket_path,
+                                           {script_file.string()});
+    for (std::size_t clients : {1, 4, 16}) {
+        std::vector<std::vector<double>> latencies(clients);
+        std::vector<std::thread> threads;
+        auto start = steady_clock::now();
+        for (std::size_t c = 0; c < clients; ++c) {
+            threads.emplace_back([&, c]() {
+                test_utils::ServerClient client(socket_path);
+                for (std::size_t i = 0; i < REQUESTS_PER_CLIENT; ++i) {
+                    auto begin = steady_clock::now();
+                    auto reply = client.request("transform", record);
+                    latencies[c].push_back(
+                        duration_cast<nanoseconds>(steady_clock::now() - begin).count() / 1e3);
+                    if (!reply.ok) {
+                        ADD_FAILURE() << reply.body;
+                        return;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto seconds = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+        std::vector<double> all;
+        for (auto& samples : latencies) {
+            all.insert(all.end(), samples.begin(), samples.end());
+        }
+        std::cout << "  --serve, " << clients << " clients: "
+                  << static_cast<std::size_t>(all.size() / seconds) << " requests/s, p50 "
+                  << percentile(all, 50) << " us, p99 " << percentile(all, 99) << " us\n";
+    }
+    test_utils::ServerClient client(socket_path);
+    std::cout << "  server stats: " << client.request("$stats", "").body << "\n";
+    EXPECT_EQ(test_utils::stop_server(server), 0);
+    std::filesystem::remove_all(dir);
+}
+#endif
@@ -0,0 +1,594 @@
+#include <computo.hpp>
+#include <functional>
+#include <gtest/gtest.h>
+
+using json = jsom::JsonDocument;
+
+class ProgramTest : public ::testing::Test {
+protected:
+    // Runs a script both interpreted and compiled, and checks they agree
+    static auto run_both(const std::string& script_json, const std::vector<json>& inputs = {})
+        -> json {
+        auto script = jsom::parse_document(script_json);
+        auto interpreted = computo::execute(script, inputs);
+        auto compiled = computo::compile(script).run(inputs);
+        EXPECT_EQ(compiled, interpreted) << "script: " << script_json;
+        return compiled;
+    }
+};
+
+// --- Compiled Programs ---
+
+TEST_F(ProgramTest, LiteralsAndArithmetic) {
+    EXPECT_EQ(run_both("42"), json(42));
+    EXPECT_EQ(run_both(R"({"a": 1})"), jsom::parse_document(R"({"a": 1})"));
+    EXPECT_EQ(run_both(R"(["+", ["*", 2, 3], ["-", 10, 4]])"), json(12));
+}
+
+TEST_F(ProgramTest, LiteralArraysEvaluateElements) {
+    EXPECT_EQ(run_both(R"([1, ["+", 1, 1], {"array": [3]}])"), jsom::parse_document("[1, 2, [3]]"));
+    EXPECT_EQ(run_both("[]"), json::make_array());
+}
+
+TEST_F(ProgramTest, TailCallsInsideLiteralArrays) {
+    EXPECT_EQ(run_both(R"([1, ["if", true, 2, 3], ["let", {"x": 5}, ["$", "/x"]]])"),
+              jsom::parse_document("[1, 2, 5]"));
+}
+
+TEST_F(ProgramTest, ControlFlowAndVariables) {
+    EXPECT_EQ(run_both(R"(["let", [["x", 10], ["y", ["*", 2, 3]]],
+                          ["if", [">", ["$", "/x"], ["$", "/y"]], "bigger", "smaller"]])"),
+              json("bigger"));
+}
+
+TEST_F(ProgramTest, ArrayOperatorsWithLambdas) {
+    auto input = jsom::parse_document(R"([1, 2, 3, 4, 5])");
+    EXPECT_EQ(run_both(R"(["reduce",
+                             ["filter", ["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 10]]],
+                                        ["lambda", ["x"], [">", ["$", "/x"], 20]]],
+                             ["lambda", ["acc", "x"], ["+", ["$", "/acc"], ["$", "/x"]]],
+                             0])",
+                       {input}),
+              json(120));
+}
+
+TEST_F(ProgramTest, LexicalVariablesResolveToSlots) {
+    // Shadowing, outer frames, duplicate names (last binding wins) and lambda
+    // parameters next to let bindings
+    EXPECT_EQ(run_both(R"(["let", {"x": 1}, ["let", {"x": 2, "y": 3},
+                          ["+", ["$", "/x"], ["$", "/y"]]]])"),
+              json(5));
+    EXPECT_EQ(run_both(R"(["let", [["x", 1], ["y", 2]], ["let", [["z", 3]],
+                          ["-", ["$", "/x"], ["$", "/z"]]]])"),
+              json(-2));
+    EXPECT_EQ(run_both(R"(["let", [["x", 1], ["x", 2]], ["$", "/x"]])"), json(2));
+    EXPECT_EQ(run_both(R"(["let", {"k": 10}, ["map", {"array": [1, 2]},
+                          ["lambda", ["x"], ["let", {"y": ["*", ["$", "/x"], ["$", "/k"]]},
+                              ["+", ["$", "/y"], ["$", "/x"]]]]]])"),
+              jsom::parse_document(R"({"array": [11, 22]})"));
+    EXPECT_EQ(run_both(R"(["let", {"p": {"a": [4, 5]}}, ["$", "/p/a/1"]])"), json(5));
+}
+
+TEST_F(ProgramTest, DynamicallyScopedLambdaValues) {
+    // A lambda stored in a variable sees the caller's bindings at call time
+    EXPECT_EQ(run_both(R"(["let", {"f": ["lambda", ["x"], ["+", ["$", "/x"], ["$", "/k"]]]},
+                          ["let", {"k": 100}, ["map", {"array": [1, 2]}, ["$", "/f"]]]])"),
+              jsom::parse_document(R"({"array": [101, 102]})"));
+    // Let binding values are evaluated in the enclosing scope
+    EXPECT_EQ(run_both(R"(["let", {"x": 1}, ["let", {"x": 2, "y": ["$", "/x"]}, ["$", "/y"]]])"),
+              json(1));
+}
+
+TEST_F(ProgramTest, RunsRepeatedlyWithDifferentInputs) {
+    auto program = computo::compile(jsom::parse_document(R"(["+", ["$input"], 1])"));
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(program.run({json(i)}), json(i + 1));
+    }
+    EXPECT_GT(program.node_count(), 0U);
+}
+
+TEST_F(ProgramTest, CustomArrayKey) {
+    auto program = computo::compile(jsom::parse_document(R"({"@items": [1, 2]})"), "@items");
+    EXPECT_EQ(program.array_key(), "@items");
+    EXPECT_EQ(program.run(), jsom::parse_document("[1, 2]"));
+}
+
+TEST_F(ProgramTest, UnknownOperatorReportedWhenEvaluated) {
+    // Compiling never fails; the error surfaces only if the node is reached
+    auto unreachable = computo::compile(jsom::parse_document(R"(["if", true, 1, ["nope"]])"));
+    EXPECT_EQ(unreachable.run(), json(1));
+
+    auto reachable = computo::compile(jsom::parse_document(R"(["mapp", [1], 2])"));
+    EXPECT_THROW((void)reachable.run(), computo::InvalidOperatorException);
+}
+
+TEST_F(ProgramTest, ErrorsMatchInterpreter) {
+    auto script = jsom::parse_document(R"(["+", 1, "two"])");
+    std::string interpreted_message;
+    std::string compiled_message;
+    try {
+        (void)computo::execute(script);
+    } catch (const computo::ComputoException& e) {
+        interpreted_message = e.what();
+    }
+    try {
+        (void)computo::compile(script).run();
+    } catch (const computo::ComputoException& e) {
+        compiled_message = e.what();
+    }
+    EXPECT_FALSE(compiled_message.empty());
+    EXPECT_EQ(compiled_message, interpreted_message);
+}
+
+TEST_F(ProgramTest, ErrorLocationsFollowExecutionPath) {
+    auto message_of = [](const computo::Program& program) {
+        try {
+            (void)program.run();
+        } catch (const computo::ComputoException& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    const std::vector<std::pair<std::string, std::string>> cases = {
+        {R"(["<", 1, ["car", 5]])", " at /arg1"},
+        {R"([0, ["car", 5]])", " at /1"},
+        {R"(["let", {"x": ["car", 5]}, 1])", " at /binding_value_for_x"},
+        // Tail calls keep the full path of the operators that made them
+        {R"(["==", 1, ["if", true, ["car", 5], 0]])", " at /arg1/then"},
+        {R"(["==", 1, ["let", {"x": 1}, ["if", true, ["car", 5], 0]]])", " at /arg1/let_body/then"},
+        {R"(["if", true, ["let", {"x": 1}, ["if", false, 0, ["car", 5]]], 0])",
+         " at /then/let_body/else"},
+        {R"(["==", 1, ["let", {"x": 1}, ["let", {"y": 2}, ["if", true, ["car", 5], 0]]]])",
+         " at /arg1/let_body/let_body/then"},
+        {R"(["let", {"x": ["let", {"y": 1}, ["==", 1, ["car", ["$", "/y"]]]]}, 1])",
+         " at /binding_value_for_x/let_body/arg1"},
+    };
+    for (const auto& [script_json, location] : cases) {
+        auto script = jsom::parse_document(script_json);
+        auto message = message_of(computo::compile(script));
+        std::string interpreted;
+        try {
+            (void)computo::execute(script);
+        } catch (const computo::ComputoException& e) {
+            interpreted = e.what();
+        }
+        EXPECT_EQ(message, interpreted) << script_json;
+        EXPECT_NE(message.find(location), std::string::npos) << script_json << ": " << message;
+    }
+}
+
+// --- Loop-Invariant Hoisting ---
+
+TEST_F(ProgramTest, HoistsParameterIndependentSubexpressions) {
+    auto input = jsom::parse_document(R"({"items": [1, 5, 9], "config": {"threshold": 4}})");
+    auto hoisted_nodes = [](const std::string& script_json) {
+        return computo::compile(jsom::parse_document(script_json)).stats().hoisted_nodes;
+    };
+
+    const std::string threshold = R"(["filter", ["$input", "/items"],
+        ["lambda", ["x"], [">", ["$", "/x"], ["$input", "/config/threshold"]]]])";
+    EXPECT_EQ(run_both(threshold, {input}), jsom::parse_document(R"({"array": [5, 9]})"));
+    EXPECT_EQ(hoisted_nodes(threshold), 1U);
+
+    const std::string lookup = R"(["let", {"lookup": {"a": {"b": 2}}}, ["map", ["$input", "/items"],
+        ["lambda", ["x"], ["*", ["$", "/x"], ["$", "/lookup/a/b"]]]]])";
+    EXPECT_EQ(run_both(lookup, {input}), jsom::parse_document(R"({"array": [2, 10, 18]})"));
+    EXPECT_EQ(hoisted_nodes(lookup), 1U);
+
+    // Only the largest invariant subtree is cached
+    const std::string nested = R"(["some", ["$input", "/items"], ["lambda", ["x"],
+        ["==", ["$", "/x"], ["+", ["count", ["$input", "/items"]], 6]]]])";
+    EXPECT_EQ(run_both(nested, {input}), json(true));
+    EXPECT_EQ(hoisted_nodes(nested), 1U);
+
+    EXPECT_EQ(hoisted_nodes(R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]])"), 0U);
+    EXPECT_EQ(hoisted_nodes(R"(["count", ["$input", "/items"]])"), 0U); // Not in a lambda
+}
+
+TEST_F(ProgramTest, HoistingRespectsScopes) {
+    auto input = jsom::parse_document(R"({"a": [1, 2], "b": [10, 20, 30]})");
+    auto hoisted_nodes = [](const std::string& script_json) {
+        return computo::compile(jsom::parse_document(script_json)).stats().hoisted_nodes;
+    };
+
+    // Names bound inside the body vary per element
+    const std::string let_in_body = R"(["map", ["$input", "/a"], ["lambda", ["x"],
+        ["let", {"y": ["*", ["$", "/x"], 2]}, ["+", ["$", "/y"], ["count", ["$input", "/b"]]]]]])";
+    EXPECT_EQ(run_both(let_in_body, {input}), jsom::parse_document(R"({"array": [5, 7]})"));
+    EXPECT_EQ(hoisted_nodes(let_in_body), 1U);
+
+    // An invariant object binding value moves; the body using it does not
+    const std::string invariant_binding = R"(["map", ["$input", "/a"], ["lambda", ["x"],
+        ["let", {"n": ["count", ["$input", "/b"]]}, ["+", ["$", "/x"], ["$", "/n"]]]]])";
+    EXPECT_EQ(run_both(invariant_binding, {input}), jsom::parse_document(R"({"array": [4, 5]})"));
+    EXPECT_EQ(hoisted_nodes(invariant_binding), 1U);
+
+    // Inner loop invariants move to the outermost loop they do not depend on
+    const std::string nested_loops = R"(["map", ["$input", "/a"], ["lambda", ["x"],
+        ["reduce", ["$input", "/b"],
+            ["lambda", ["acc", "y"], ["+", ["$", "/acc"], ["$", "/x"], ["count", ["$input", "/b"]]]],
+            0]]])";
+    EXPECT_EQ(run_both(nested_loops, {input}), jsom::parse_document(R"({"array": [12, 15]})"));
+    EXPECT_EQ(hoisted_nodes(nested_loops), 2U);
+
+    // A lambda value sees the caller's bindings, so calls through one never
+    // move; only the inner map's array argument does
+    const std::string dynamic = R"(["let", {"f": ["lambda", ["y"], ["+", ["$", "/y"], ["$", "/x"]]]},
+        ["map", ["$input", "/a"], ["lambda", ["x"], ["car", ["map", ["$input", "/b"], ["$", "/f"]]]]]])";
+    EXPECT_EQ(run_both(dynamic, {input}), jsom::parse_document(R"({"array": [11, 12]})"));
+    EXPECT_EQ(hoisted_nodes(dynamic), 1U);
+}
+
+TEST_F(ProgramTest, HoistedSubexpressionsEvaluateLazily) {
+    auto input = jsom::parse_document(R"({"items": [1, 2, 3]})");
+    // Never reached: no error, exactly as in the interpreter
+    EXPECT_EQ(run_both(R"(["filter", ["$input", "/items"], ["lambda", ["x"],
+                          ["if", [">", ["$", "/x"], 5], ["$input", "/missing"], true]]])",
+                       {input}),
+              jsom::parse_document(R"({"array": [1, 2, 3]})"));
+    EXPECT_EQ(run_both(R"(["map", [], ["lambda", ["x"], ["/", 1, ["$input", "/zero"]]]])", {input}),
+              jsom::parse_document(R"({"array": []})"));
+
+    // Reached: the error and its location match the interpreter
+    auto script = jsom::parse_document(R"(["map", ["$input", "/items"], ["lambda", ["x"],
+        ["if", [">", ["$", "/x"], 1], ["$input", "/missing"], ["$", "/x"]]]])");
+    std::string interpreted;
+    std::string compiled;
+    try {
+        (void)computo::execute(script, {input});
+    } catch (const computo::ComputoException& e) {
+        interpreted = e.what();
+    }
+    try {
+        (void)computo::compile(script).run({input});
+    } catch (const computo::ComputoException& e) {
+        compiled = e.what();
+    }
+    EXPECT_FALSE(compiled.empty());
+    EXPECT_EQ(compiled, interpreted);
+}
+
+// --- Parallel Map and Filter ---
+
+namespace {
+
+// Small chunks, so even short arrays are spread over the threads
+auto parallel_options(std::size_t threads) -> computo::ParallelOptions {
+    computo::ParallelOptions options;
+    options.threads = threads;
+    options.min_elements = 2;
+    options.chunk_size = 3;
+    return options;
+}
+
+auto numbers(int count) -> json {
+    auto array = json::make_array();
+    for (int i = 0; i < count; ++i) {
+        array.push_back(json(i));
+    }
+    return array;
+}
+
+auto error_message(const std::function<void()>& run) -> std::string {
+    try {
+        run();
+    } catch (const computo::ComputoException& e) {
+        return e.what();
+    }
+    return {};
+}
+
+} // namespace
+
+TEST_F(ProgramTest, ParallelMapAndFilterKeepOrder) {
+    auto input = json{{"limit", json(50)}, {"items", numbers(200)}};
+    const std::vector<std::string> scripts = {
+        R"(["map", ["$input", "/items"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]])",
+        R"(["filter", ["$input", "/items"], ["lambda", ["x"], ["<", ["$", "/x"], ["$input", "/limit"]]]])",
+        // Hoisted values are shared by the chunks
+        R"(["map", ["$input", "/items"], ["lambda", ["x"],
+            ["+", ["$", "/x"], ["count", ["filter", ["$input", "/items"], ["lambda", ["y"], [">", ["$", "/y"], 100]]]]]]])",
+        // Nested calls split again on pool threads
+        R"(["map", ["$input", "/items"], ["lambda", ["x"],
+            ["count", ["filter", ["$input", "/items"], ["lambda", ["y"], ["<", ["$", "/y"], ["$", "/x"]]]]]]])",
+    };
+    for (const auto& script_json : scripts) {
+        auto script = jsom::parse_document(script_json);
+        auto expected = computo::execute(script, {input});
+        for (std::size_t threads : {2, 4, 16}) {
+            EXPECT_EQ(computo::execute(script, {input}, nullptr, "array", parallel_options(threads)),
+                      expected)
+                << script_json << " on " << threads << " threads";
+            EXPECT_EQ(computo::compile(script).run({input}, nullptr, parallel_options(threads)),
+                      expected)
+                << script_json << " on " << threads << " threads";
+        }
+    }
+}
+
+TEST_F(ProgramTest, ParallelChunksShareNestedInvariants) {
+    auto input = json{{"items", numbers(200)}};
+    // The outer lambda's invariants contain loops with invariants of their
+    // own, and those loops split over the pool again while chunks of the
+    // outer map race to fill the same slots
+    auto script = jsom::parse_document(R"(["map", ["$input", "/items"], ["lambda", ["x"],
+        ["+", ["$", "/x"],
+            ["count", ["filter", ["$input", "/items"], ["lambda", ["y"],
+                [">", ["$", "/y"], ["count", ["map", ["$input", "/items"],
+                    ["lambda", ["z"], ["+", ["$", "/z"], ["count", ["$input", "/items"]]]]]]]]]],
+            ["count", ["filter", ["$input", "/items"], ["lambda", ["y"],
+                ["<", ["$", "/y"], ["-", ["$", "/x"], ["count", ["$input", "/items"]]]]]]]]]])");
+    EXPECT_GT(computo::compile(script).stats().hoisted_nodes, 1U);
+    auto expected = computo::execute(script, {input});
+    for (std::size_t threads : {2, 4, 16}) {
+        EXPECT_EQ(computo::compile(script).run({input}, nullptr, parallel_options(threads)),
+                  expected)
+            << threads << " threads";
+    }
+}
+
+TEST_F(ProgramTest, ParallelErrorsMatchSequential) {
+    auto input = json{{"items", numbers(100)}};
+    // Elements 40 and 70 both fail; the first in array order is reported
+    auto script = jsom::parse_document(R"(["map", ["$input", "/items"], ["lambda", ["x"],
+        ["if", ["==", ["$", "/x"], 40], ["car", []],
+            ["if", ["==", ["$", "/x"], 70], ["/", 1, 0], ["$", "/x"]]]]])");
+    auto expected = error_message([&] { (void)computo::execute(script, {input}); });
+    EXPECT_FALSE(expected.empty());
+    auto program = computo::compile(script);
+    for (std::size_t threads : {2, 4, 16}) {
+        EXPECT_EQ(error_message([&] {
+                      (void)computo::execute(script, {input}, nullptr, "array",
+                                             parallel_options(threads));
+                  }),
+                  expected);
+        EXPECT_EQ(error_message([&] { (void)program.run({input}, nullptr, parallel_options(threads)); }),
+                  expected);
+    }
+}
+
+TEST_F(ProgramTest, ParallelThresholdKeepsSmallArraysSequential) {
+    auto options = parallel_options(4);
+    options.min_elements = 1000;
+    auto script = jsom::parse_document(R"(["map", ["$input"], ["lambda", ["x"], ["+", ["$", "/x"], 1]]])");
+    EXPECT_EQ(computo::compile(script).run({numbers(10)}, nullptr, options),
+              computo::execute(script, {numbers(10)}));
+}
+
+TEST_F(ProgramTest, ParallelReduceMatchesSequential) {
+    auto objects = json::make_array();
+    for (int i = 0; i < 50; ++i) {
+        objects.push_back(json{{"k" + std::to_string(i % 7), json(i)}});
+    }
+    auto small = json::make_array();
+    for (int i = 0; i < 40; ++i) {
+        small.push_back(json(i % 3 + 1));
+    }
+    auto input = json{{"items", numbers(200)}, {"objects", objects}, {"small", small},
+                      {"mixed", jsom::parse_document(R"([1, 2.5, 3, 0.1, 7])")}};
+    const std::vector<std::string> scripts = {
+        // Recognized as associative; the initial value need not be an identity
+        R"(["reduce", ["$input", "/items"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 10])",
+        R"(["reduce", ["$input", "/small"], ["lambda", ["a", "x"], ["*", ["$", "/x"], ["$", "/a"]]], 1])",
+        R"(["reduce", ["$input", "/items"], ["lambda", ["a", "x"],
+            ["if", [">", ["$", "/a"], ["$", "/x"]], ["$", "/a"], ["$", "/x"]]], 0])",
+        R"(["reduce", ["$input", "/items"], ["lambda", ["a", "x"],
+            ["if", ["<=", ["$", "/x"], ["$", "/a"]], ["$", "/x"], ["$", "/a"]]], 1000])",
+        R"(["reduce", ["$input", "/objects"], ["lambda", ["a", "x"], ["merge", ["$", "/a"], ["$", "/x"]]], {}])",
+        // Fractions round differently when regrouped, so they stay sequential
+        R"(["reduce", ["$input", "/mixed"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0])",
+        // Not associative
+        R"(["reduce", ["$input", "/items"], ["lambda", ["a", "x"], ["-", ["$", "/a"], ["$", "/x"]]], 0])",
+    };
+    for (const auto& script_json : scripts) {
+        auto script = jsom::parse_document(script_json);
+        auto expected = computo::execute(script, {input});
+        for (std::size_t threads : {2, 4, 16}) {
+            EXPECT_EQ(computo::compile(script).run({input}, nullptr, parallel_options(threads)),
+                      expected)
+                << script_json << " on " << threads << " threads";
+        }
+    }
+
+    // Values the reducer rejects are reported by the sequential fold
+    auto script = jsom::parse_document(
+        R"(["reduce", ["$input"], ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0])");
+    auto bad = jsom::parse_document(R"([1, 2, 3, "four", 5, 6, 7, 8])");
+    auto expected = error_message([&] { (void)computo::execute(script, {bad}); });
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(error_message([&] {
+                  (void)computo::execute(script, {bad}, nullptr, "array", parallel_options(4));
+              }),
+              expected);
+}
+
+TEST_F(ProgramTest, ParallelArgumentsMatchSequential) {
+    auto input = json{{"items", numbers(100)}};
+    // Each filter counts as expensive; literal keys and numbers do not
+    const std::string small = R"(["filter", ["$input", "/items"], ["lambda", ["x"], ["<", ["$", "/x"], 10]]])";
+    const std::string large = R"(["filter", ["$input", "/items"], ["lambda", ["x"], [">", ["$", "/x"], 90]]])";
+    const std::string total = R"(["reduce", )" + small + R"(, ["lambda", ["a", "x"], ["+", ["$", "/a"], ["$", "/x"]]], 0])";
+    const std::vector<std::string> scripts = {
+        R"(["obj", "small", )" + small + R"(, "large", )" + large + "]",
+        R"(["merge", ["obj", "a", )" + small + R"(], ["obj", "b", )" + large + "]]",
+        R"(["append", )" + small + ", " + large + ", " + small + "]",
+        R"(["zip", )" + small + ", " + large + "]",
+        R"(["+", 1, )" + total + ", " + total + "]",
+        R"(["strConcat", )" + total + R"(, "-", )" + total + "]",
+        R"(["-", )" + total + ", " + total + ", 1]",
+        R"(["*", )" + total + ", " + total + "]",
+        R"(["/", )" + total + ", " + total + "]",
+        R"(["%", )" + total + ", " + total + "]",
+        R"(["<", 0, )" + total + ", " + total + "]",
+        R"([">=", )" + total + ", " + total + ", 1]",
+        R"(["==", )" + small + ", " + small + "]",
+        R"(["!=", )" + small + ", " + large + "]",
+        R"(["let", [["s", )" + small + R"(], ["l", )" + large + R"(]], ["append", ["$", "/s"], ["$", "/l"]]])",
+        R"(["let", {"s": )" + small + R"(, "l": )" + large + R"(}, ["append", ["$", "/l"], ["$", "/s"]]])",
+    };
+    for (const auto& script_json : scripts) {
+        auto script = jsom::parse_document(script_json);
+        auto expected = computo::execute(script, {input});
+        for (std::size_t threads : {2, 4}) {
+            EXPECT_EQ(computo::execute(script, {input}, nullptr, "array", parallel_options(threads)),
+                      expected)
+                << script_json;
+            EXPECT_EQ(computo::compile(script).run({input}, nullptr, parallel_options(threads)),
+                      expected)
+                << script_json;
+        }
+    }
+
+    // The first error in argument order wins, even when a later argument
+    // fails as well or an earlier one only fails a type check afterwards
+    const std::string fails = R"(["map", ["$input", "/items"], ["lambda", ["x"], ["/", 1, ["-", ["$", "/x"], 50]]]])";
+    const std::string missing = R"(["map", ["$input", "/items"], ["lambda", ["x"], ["$input", "/missing"]]])";
+    const std::vector<std::string> failing = {
+        R"(["append", )" + fails + ", " + missing + "]",
+        R"(["append", )" + missing + ", " + fails + "]",
+        R"(["+", )" + small + ", " + fails + "]",
+        R"(["*", )" + total + ", " + fails + ", " + missing + "]",
+        R"([">", )" + small + ", " + fails + "]",
+        R"(["<", )" + fails + ", " + missing + "]",
+        R"(["let", [["a", )" + small + R"(], ["b", )" + fails + R"(], "bad"], 1])",
+        R"(["let", [["a", )" + small + R"(], "bad", ["b", )" + fails + R"(]], 1])",
+    };
+    for (const auto& script_json : failing) {
+        auto script = jsom::parse_document(script_json);
+        auto expected = error_message([&] { (void)computo::execute(script, {input}); });
+        EXPECT_FALSE(expected.empty()) << script_json;
+        EXPECT_EQ(error_message([&] {
+                      (void)computo::execute(script, {input}, nullptr, "array", parallel_options(4));
+                  }),
+                  expected)
+            << script_json;
+        EXPECT_EQ(error_message([&] {
+                      (void)computo::compile(script).run({input}, nullptr, parallel_options(4));
+                  }),
+                  expected)
+            << script_json;
+    }
+}
+
+TEST_F(ProgramTest, ParallelShortCircuitsGuardRecursion) {
+    // Both arguments of the or look expensive, but the recursive call may only
+    // run once the guard has failed; evaluating it ahead would never end
+    const std::string guarded = R"(["let", {"f": ["lambda", ["n"],
+        ["or", ["every", [["$", "/n"]], ["lambda", ["x"], ["<=", ["$", "/x"], 0]]],
+               ["car", ["map", [["-", ["$", "/n"], 1]], ["$", "/f"]]]]]},
+        ["car", ["map", [["$input"]], ["$", "/f"]]]])";
+    auto script = jsom::parse_document(guarded);
+    EXPECT_EQ(computo::execute(script, {json(20)}, nullptr, "array", parallel_options(4)),
+              json(true));
+    EXPECT_EQ(computo::compile(script).run({json(20)}, nullptr, parallel_options(4)), json(true));
+
+    // The same guard in an and: the failing call past a false guard never runs
+    const std::string failing = R"(["and",
+        ["some", ["$input"], ["lambda", ["x"], ["<", ["$", "/x"], 0]]],
+        ["map", ["$input"], ["lambda", ["x"], ["/", 1, 0]]]])";
+    auto input = jsom::parse_document("[1, 2, 3]");
+    EXPECT_EQ(computo::compile(jsom::parse_document(failing))
+                  .run({input}, nullptr, parallel_options(4)),
+              json(false));
+}
+
+TEST_F(ProgramTest, BatchKeepsInputOrderAndCapturesErrors) {
+    auto script = jsom::parse_document(R"(["/", 100, ["$input", "/n"]])");
+    std::vector<json> inputs;
+    for (int n = 0; n < 50; ++n) {
+        inputs.push_back(json{{"n", n % 10}});
+    }
+    inputs.push_back(json{{"m", 1}});
+    for (std::size_t threads : {1, 4}) {
+        computo::BatchOptions options;
+        options.threads = threads;
+        options.chunk_size = 3;
+        auto results = computo::execute_batch(script, inputs, options);
+        ASSERT_EQ(results.size(), inputs.size());
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            auto expected = error_message([&] { (void)computo::execute(script, {inputs[i]}); });
+            if (expected.empty()) {
+                EXPECT_TRUE(results[i].ok());
+                EXPECT_EQ(results[i].value, computo::execute(script, {inputs[i]}));
+            } else {
+                // A failing document keeps its own error and stops nothing else
+                EXPECT_FALSE(results[i].ok());
+                EXPECT_TRUE(results[i].value.is_null());
+                EXPECT_EQ(results[i].error_message(), expected);
+                EXPECT_THROW(std::rethrow_exception(results[i].error), computo::ComputoException);
+            }
+        }
+    }
+}
+
+TEST_F(ProgramTest, BatchRunsCompiledProgramsOnMovedInputs) {
+    auto program = computo::compile(
+        jsom::parse_document(R"(["map", ["$input"], ["lambda", ["x"], ["*", ["$", "/x"], 2]]])"));
+    std::vector<json> inputs = {numbers(3), numbers(5), numbers(1)};
+    computo::BatchOptions options;
+    options.threads = 2;
+    options.parallel = parallel_options(2); // Each document may fan out as well
+    auto expected = inputs;
+    for (auto& document : expected) {
+        document = program.run({document});
+    }
+    auto results = program.run_batch(std::move(inputs), options);
+    ASSERT_EQ(results.size(), 3);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].value, expected[i]);
+    }
+    EXPECT_EQ(results[2].error_message(), "");
+    EXPECT_TRUE(computo::execute_batch(json(1), {}).empty());
+    EXPECT_THROW((void)computo::Program().run_batch({json(1)}), computo::ComputoException);
+}
+
+TEST_F(ProgramTest, InputAccessListsLiteralPointers) {
+    auto access = computo::compile(jsom::parse_document(R"(["let",
+        [["limit", ["$input", "/config/limit"]]],
+        ["filter", ["$inputs", "/1/events"],
+            ["lambda", ["e"], [">", ["$", "/e/n"], ["$input", ["strConcat", "/config", "/min"]]]]]])"))
+                      .input_access();
+    EXPECT_FALSE(access.all_inputs);
+    // Constant pointer expressions are folded to literals first
+    EXPECT_EQ(access.pointers[0], (std::vector<std::string>{"/config/limit", "/config/min"}));
+    EXPECT_EQ(access.pointers[1], (std::vector<std::string>{"/events"}));
+    EXPECT_FALSE(access.reads_whole(0));
+    EXPECT_FALSE(access.reads_whole(2));
+
+    auto whole = computo::compile(jsom::parse_document(
+                                      R"(["+", ["$input", ["$", "/p"]], ["$inputs", "/2"]])"))
+                     .input_access();
+    EXPECT_TRUE(whole.reads_whole(0)); // Computed pointer
+    EXPECT_TRUE(whole.reads_whole(2));
+    EXPECT_FALSE(whole.reads_whole(1));
+    EXPECT_TRUE(computo::compile(jsom::parse_document(R"(["count", ["$inputs"]])"))
+                    .input_access()
+                    .all_inputs);
+    EXPECT_TRUE(computo::compile(json(1)).input_access().pointers.empty());
+}
+
+TEST_F(ProgramTest, DebugBreakpointsStillFire) {
+    auto program = computo::compile(jsom::parse_document(R"(["+", ["$input"], ["*", 2, 3]])"));
+    computo::DebugContext debug_ctx;
+    debug_ctx.set_debug_enabled(true);
+    debug_ctx.set_operator_breakpoint("+");
+    EXPECT_THROW((void)program.run({json(1)}, &debug_ctx), computo::DebugBreakException);
+}
+
+TEST_F(ProgramTest, EmptyProgramThrows) {
+    computo::Program program;
+    EXPECT_THROW((void)program.run(), computo::ComputoException);
+}
+
+TEST_F(ProgramTest, OpcodesRoundTripThroughRegistry) {
+    auto& registry = computo::OperatorRegistry::get_instance();
+    auto names = registry.get_operator_names();
+    EXPECT_EQ(names.size(), registry.operator_count());
+    for (const auto& name : names) {
+        auto opcode = registry.find_opcode(name);
+        ASSERT_TRUE(opcode.has_value()) << name;
+        EXPECT_EQ(registry.get_operator_name(*opcode), name);
+        EXPECT_EQ(registry.get_operator(*opcode), registry.get_operator(name));
+    }
+    EXPECT_FALSE(registry.find_opcode("no_such_operator").has_value());
+}
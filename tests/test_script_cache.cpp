@@ -0,0 +1,109 @@
+#include "computo.hpp"
+#include "script_cache.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using computo::decode_script_cache;
+using computo::encode_script_cache;
+using computo::is_script_cache;
+using json = jsom::JsonDocument;
+
+class ScriptCacheTest : public ::testing::Test {
+protected:
+    const json script = jsom::parse_document(R"(["let", [["rate", 1.5e2]],
+        ["map", ["$input", "/items"],
+            ["lambda", ["x"], ["obj",
+                "id", ["$", "/x/id"],
+                "cost", ["*", ["$", "/x/qty"], ["$", "/rate"], -3],
+                "tags", {"array": ["a", "b\n\"c\"", null, true, false, {}]},
+                "meta", {"café": {"nested": []}, "": 1234567890123}]]]])");
+};
+
+TEST_F(ScriptCacheTest, RoundTripsScriptAndArrayKey) {
+    auto bytes = encode_script_cache(script, "@data");
+    ASSERT_TRUE(is_script_cache(bytes));
+    auto cached = decode_script_cache(bytes);
+    EXPECT_EQ(cached.script, script);
+    EXPECT_EQ(cached.script.to_json(), script.to_json());
+    EXPECT_EQ(cached.array_key, "@data");
+
+    for (const auto* scalar : {"42", "\"text\"", "null", "[]", "{}"}) {
+        auto value = jsom::parse_document(scalar);
+        EXPECT_EQ(decode_script_cache(encode_script_cache(value, "array")).script, value)
+            << scalar;
+    }
+}
+
+TEST_F(ScriptCacheTest, DecodedScriptRunsTheSame) {
+    auto input = jsom::parse_document(R"({"items": [{"id": 1, "qty": 2}, {"id": 2, "qty": 0}]})");
+    auto cached = decode_script_cache(encode_script_cache(script, "array"));
+    EXPECT_EQ(computo::execute(cached.script, {input}), computo::execute(script, {input}));
+}
+
+TEST_F(ScriptCacheTest, InternsRepeatedStrings) {
+    auto repeated = jsom::parse_document(R"(["+", ["+", ["+", 1, 2], 3], ["+", 4, 5]])");
+    auto once = jsom::parse_document(R"(["+", 1, 2])");
+    // Each extra "+" costs a record but no string bytes
+    auto extra = encode_script_cache(repeated, "array").size()
+                 - encode_script_cache(once, "array").size();
+    EXPECT_EQ(extra, (9U * 16) + (3U * 4) + 3); // 9 records, 3 one-digit numbers
+}
+
+TEST_F(ScriptCacheTest, RejectsOtherVersionsAndDamage) {
+    auto bytes = encode_script_cache(script, "array");
+    EXPECT_FALSE(is_script_cache(script.to_json()));
+
+    auto other_version = bytes;
+    other_version[8] = static_cast<char>(computo::SCRIPT_CACHE_VERSION + 1);
+    try {
+        (void)decode_script_cache(other_version);
+        FAIL() << "expected a version error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("recompile"), std::string::npos);
+    }
+
+    EXPECT_THROW((void)decode_script_cache(bytes.substr(0, bytes.size() - 1)),
+                 std::runtime_error);
+    EXPECT_THROW((void)decode_script_cache(bytes.substr(0, 12)), std::runtime_error);
+    auto bad_tag = bytes;
+    bad_tag[24] = 'x';
+    EXPECT_THROW((void)decode_script_cache(bad_tag), std::runtime_error);
+}
+
+TEST_F(ScriptCacheTest, CapsNestingDepth) {
+    auto nested = [](std::size_t depth) {
+        auto value = json(1);
+        for (std::size_t i = 0; i < depth; ++i) {
+            auto array = json::make_array();
+            array.push_back(std::move(value));
+            value = std::move(array);
+        }
+        return value;
+    };
+    auto deepest = nested(computo::SCRIPT_CACHE_MAX_DEPTH);
+    EXPECT_EQ(decode_script_cache(encode_script_cache(deepest, "array")).script, deepest);
+    EXPECT_THROW((void)encode_script_cache(nested(computo::SCRIPT_CACHE_MAX_DEPTH + 1), "array"),
+                 std::runtime_error);
+
+    // A hand-made file of a hundred thousand one-element arrays, far past the cap
+    constexpr std::uint32_t RECORDS = 100000;
+    auto header = encode_script_cache(json(nullptr), "array").substr(0, 16);
+    std::string bytes = header;
+    for (int shift = 0; shift < 32; shift += 8) {
+        bytes.push_back(static_cast<char>((RECORDS >> shift) & 0xFFU));
+    }
+    bytes += std::string("\x01\0\0\0", 4); // One string: the array key
+    for (std::uint32_t i = 0; i < RECORDS; ++i) {
+        std::string record(16, '\0');
+        record[0] = static_cast<char>(i + 1 < RECORDS ? 5 : 0); // Array of one, then null
+        record[8] = static_cast<char>(i + 1 < RECORDS ? 1 : 0);
+        bytes += record;
+    }
+    bytes += std::string("\0\0\0\0\x05\0\0\0array", 13); // String offsets, then bytes
+    try {
+        (void)decode_script_cache(bytes);
+        FAIL() << "expected a depth error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()), "Invalid compiled script: nested too deeply");
+    }
+}
@@ -0,0 +1,171 @@
+#include "computo.hpp"
+#include "server_test_client.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+using test_utils::ServerClient;
+
+class ServerModeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path()
+                   / ("computo_server_test_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(test_dir);
+        socket_path = (test_dir / "computo.sock").string();
+        std::ofstream(test_dir / "double.json") << R"(["*", ["$input", "/n"], 2])";
+        std::ofstream(test_dir / "squares.computo") << "map($input/values, (x) => x * x)";
+        server = test_utils::start_server(
+            COMPUTO_BINARY_PATH, socket_path,
+            {(test_dir / "double.json").string(), (test_dir / "squares.computo").string()},
+            {"--max-request-bytes=" + std::to_string(MAX_REQUEST_BYTES),
+             "--max-connections=" + std::to_string(max_connections())});
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(test_utils::stop_server(server), 0);
+        EXPECT_FALSE(std::filesystem::exists(socket_path));
+        std::filesystem::remove_all(test_dir);
+    }
+
+    static constexpr std::size_t MAX_REQUEST_BYTES = 4096;
+    // One more than the pool has workers
+    static auto max_connections() -> std::size_t {
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 1) + 1;
+    }
+
+    std::filesystem::path test_dir;
+    std::string socket_path;
+    pid_t server{-1};
+};
+
+TEST_F(ServerModeTest, RunsScriptsById) {
+    ServerClient client(socket_path);
+    auto doubled = client.request("double", R"({"n": 21})");
+    EXPECT_TRUE(doubled.ok);
+    EXPECT_EQ(doubled.body, "42");
+    // Several requests on one connection, results unwrapped as by the CLI
+    auto squares = client.request("squares", R"({"values": [1, 2, 3]})");
+    EXPECT_TRUE(squares.ok);
+    EXPECT_EQ(squares.body, "[1,4,9]");
+}
+
+TEST_F(ServerModeTest, ReportsErrorsAndKeepsServing) {
+    ServerClient client(socket_path);
+    auto unknown = client.request("missing", "{}");
+    EXPECT_FALSE(unknown.ok);
+    EXPECT_EQ(unknown.body, "Unknown script: missing");
+    auto broken = client.request("double", R"({"n": )");
+    EXPECT_FALSE(broken.ok);
+    EXPECT_NE(broken.body.find("JSON parse error"), std::string::npos);
+    auto failing = client.request("double", R"({"m": 1})");
+    EXPECT_FALSE(failing.ok);
+    EXPECT_FALSE(failing.body.empty());
+    EXPECT_EQ(client.request("double", R"({"n": 1})").body, "2");
+}
+
+TEST_F(ServerModeTest, RejectsOversizedRequests) {
+    ServerClient client(socket_path);
+    auto padded = std::string(R"({"n": 4})") + std::string(MAX_REQUEST_BYTES - 8, ' ');
+    EXPECT_EQ(client.request("double", padded).body, "8");
+    // Only the length is sent: the server answers before reading any input
+    client.announce("double", 0xFFFFFFFFU);
+    auto rejected = client.read_reply();
+    EXPECT_FALSE(rejected.ok);
+    EXPECT_EQ(rejected.body, "Request too large: 4294967295 bytes (limit 4096)");
+    EXPECT_THROW((void)client.read_reply(), std::runtime_error); // Connection closed
+
+    ServerClient next(socket_path);
+    EXPECT_FALSE(next.request("double", padded + " ").ok);
+    ServerClient last(socket_path);
+    auto stats = jsom::parse_document(last.request("$stats", "").body);
+    EXPECT_EQ(stats["errors"].as<int>(), 2);
+}
+
+TEST_F(ServerModeTest, MoreOpenConnectionsThanWorkers) {
+    // One more connection than the pool has workers, all open at once and
+    // answered newest first, so none can wait for an older one to close
+    auto count = max_connections();
+    std::vector<std::unique_ptr<ServerClient>> clients;
+    for (std::size_t i = 0; i < count; ++i) {
+        clients.push_back(std::make_unique<ServerClient>(socket_path));
+        ASSERT_EQ(clients.back()->request("double", R"({"n": 1})").body, "2");
+    }
+    for (std::size_t i = count; i-- > 0;) {
+        auto n = std::to_string(i);
+        EXPECT_EQ(clients[i]->request("double", R"({"n": )" + n + "}").body,
+                  std::to_string(i * 2));
+    }
+}
+
+TEST_F(ServerModeTest, DefersConnectionsOverTheLimit) {
+    std::vector<std::unique_ptr<ServerClient>> clients;
+    for (std::size_t i = 0; i < max_connections(); ++i) {
+        clients.push_back(std::make_unique<ServerClient>(socket_path));
+        ASSERT_TRUE(clients.back()->request("double", R"({"n": 1})").ok);
+    }
+    // Connected, but not accepted until one of the others closes
+    ServerClient waiting(socket_path);
+    std::atomic<bool> answered{false};
+    std::thread request([&]() {
+        EXPECT_EQ(waiting.request("double", R"({"n": 5})").body, "10");
+        answered = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(answered);
+    clients.pop_back();
+    request.join();
+    EXPECT_TRUE(answered);
+}
+
+TEST_F(ServerModeTest, ConcurrentClientsAndStats) {
+    constexpr int CLIENTS = 4;
+    constexpr int REQUESTS = 50;
+    std::vector<std::thread> clients;
+    std::vector<int> mismatches(CLIENTS, 0);
+    for (int c = 0; c < CLIENTS; ++c) {
+        clients.emplace_back([&, c]() {
+            ServerClient client(socket_path);
+            for (int i = 0; i < REQUESTS; ++i) {
+                auto n = (c * REQUESTS) + i;
+                auto reply = client.request("double", R"({"n": )" + std::to_string(n) + "}");
+                if (!reply.ok || reply.body != std::to_string(n * 2)) {
+                    ++mismatches[c];
+                }
+            }
+        });
+    }
+    for (auto& thread : clients) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches, std::vector<int>(CLIENTS, 0));
+
+    ServerClient client(socket_path);
+    (void)client.request("missing", "{}");
+    auto reply = client.request("$stats", "");
+    ASSERT_TRUE(reply.ok);
+    auto stats = jsom::parse_document(reply.body);
+    EXPECT_EQ(stats["requests"].as<int>(), (CLIENTS * REQUESTS) + 1);
+    EXPECT_EQ(stats["errors"].as<int>(), 1);
+    const auto& doubled = stats["scripts"]["double"];
+    EXPECT_EQ(doubled["requests"].as<int>(), CLIENTS * REQUESTS);
+    EXPECT_GT(doubled["latency_us"]["p99"].as<int>(), 0);
+    EXPECT_GE(doubled["latency_us"]["p99"].as<int>(), doubled["latency_us"]["p50"].as<int>());
+    int counted = 0;
+    for (const auto& bucket : doubled["latency_us"]["histogram"]) {
+        counted += bucket["count"].as<int>();
+    }
+    EXPECT_EQ(counted, CLIENTS * REQUESTS);
+    EXPECT_EQ(stats["scripts"]["squares"]["requests"].as<int>(), 0);
+}
+
+#endif
@@ -340,6 +340,103 @@ TEST_F(SharedUtilitiesTest, GetTypeName) {
     EXPECT_EQ(get_type_name(json::make_object()), "object");
 }
 
+// --- Borrowed Operand Tests ---
+
+TEST_F(SharedUtilitiesTest, EvaluateBorrowedReferencesExistingValues) {
+    ExecutionContext input_ctx(jsom::parse_document(R"({"items": [1, 2, 3]})"));
+    auto whole = evaluate_shared(jsom::parse_document(R"(["$input"])"), input_ctx);
+    EXPECT_EQ(&whole.get(), &input_ctx.input());
+
+    auto items = evaluate_shared(jsom::parse_document(R"(["$input", "/items"])"), input_ctx);
+    EXPECT_EQ(&items.get(), &input_ctx.input()["items"]);
+
+    auto var_ctx = input_ctx.with_variables({{"xs", jsom::parse_document("[4, 5]")}});
+    auto element = evaluate_shared(jsom::parse_document(R"(["$", "/xs/1"])"), var_ctx);
+    EXPECT_EQ(&element.get(), &(*var_ctx.find_variable("xs"))[1]);
+
+    auto wrapper = jsom::parse_document(R"({"array": [1, 2]})");
+    auto literal = evaluate_shared(wrapper, input_ctx);
+    EXPECT_EQ(&literal.get(), &wrapper["array"]);
+}
+
+TEST_F(SharedUtilitiesTest, EvaluateBorrowedFallsBackToEvaluate) {
+    ExecutionContext input_ctx(jsom::parse_document(R"({"items": [1, 2, 3]})"));
+    auto computed =
+        evaluate_shared(jsom::parse_document(R"(["cdr", ["$input", "/items"]])"), input_ctx);
+    EXPECT_EQ(computed.get(), jsom::parse_document(R"({"array": [2, 3]})"));
+    EXPECT_EQ(std::move(computed).take(), jsom::parse_document(R"({"array": [2, 3]})"));
+
+    // Failed lookups throw exactly what evaluate() throws
+    for (const auto* script : {R"(["$input", "/missing"])", R"(["$", "/nope"])",
+                               R"({"array": 5})"}) {
+        auto expr = jsom::parse_document(script);
+        std::string expected;
+        std::string actual;
+        try {
+            (void)evaluate(expr, input_ctx);
+        } catch (const ComputoException& e) {
+            expected = e.what();
+        }
+        try {
+            (void)evaluate_shared(expr, input_ctx);
+        } catch (const ComputoException& e) {
+            actual = e.what();
+        }
+        EXPECT_FALSE(expected.empty()) << script;
+        EXPECT_EQ(actual, expected) << script;
+    }
+}
+
+TEST_F(SharedUtilitiesTest, FindJsonPointer) {
+    auto doc = jsom::parse_document(R"({"items": [1, {"k": "v"}], "a~b": 1, "": 2})");
+    ASSERT_NE(find_json_pointer(doc, "/items/1/k"), nullptr);
+    EXPECT_EQ(*find_json_pointer(doc, "/items/1/k"), json("v"));
+    EXPECT_EQ(find_json_pointer(doc, "/items"), &doc["items"]);
+
+    // Missing paths, and anything left to evaluate_json_pointer()
+    EXPECT_EQ(find_json_pointer(doc, "/items/2"), nullptr);
+    EXPECT_EQ(find_json_pointer(doc, "/items/01"), nullptr);
+    EXPECT_EQ(find_json_pointer(doc, "/items/x"), nullptr);
+    EXPECT_EQ(find_json_pointer(doc, "/a~0b"), nullptr);
+    EXPECT_EQ(find_json_pointer(doc, "/"), nullptr);
+    EXPECT_EQ(find_json_pointer(doc, "items"), nullptr);
+}
+
+TEST_F(SharedUtilitiesTest, SharedJsonSharesStorage) {
+    SharedJson member;
+    {
+        SharedJson document(jsom::parse_document(R"({"items": [1, 2, 3]})"));
+        member = document.share((*document)["items"]);
+        EXPECT_EQ(&*member, &(*document)["items"]);
+    }
+    // The document lives as long as a handle into it does
+    EXPECT_EQ(*member, jsom::parse_document("[1, 2, 3]"));
+
+    // take() copies a shared value and leaves the other handles intact
+    auto copy = member;
+    auto taken = std::move(copy).take();
+    EXPECT_EQ(taken, *member);
+    EXPECT_NE(&taken, &*member);
+    EXPECT_EQ(SharedJson(json(7)).take(), json(7));
+}
+
+TEST_F(SharedUtilitiesTest, InputsAndBindingsAreShared) {
+    auto inputs = std::make_shared<const std::vector<json>>(
+        std::vector<json>{jsom::parse_document(R"({"items": [1, 2, 3]})"), json(2)});
+    ExecutionContext input_ctx(inputs);
+    EXPECT_EQ(&input_ctx.input(), &(*inputs)[0]);
+
+    // let binds the input's array itself (its body is a pending tail call)
+    auto let_expr = jsom::parse_document(R"(["let", [["xs", ["$input", "/items"]]], ["$", "/xs"]])");
+    auto result = evaluate_internal(let_expr, input_ctx);
+    ASSERT_TRUE(result.is_tail_call);
+    EXPECT_EQ(result.tail_call->context.find_variable("xs"), &(*inputs)[0]["items"]);
+
+    EXPECT_EQ(find_inputs_pointer(*inputs, "/1"), &(*inputs)[1]);
+    EXPECT_EQ(find_inputs_pointer(*inputs, "/0/items/2"), &(*inputs)[0]["items"][2]);
+    EXPECT_EQ(find_inputs_pointer(*inputs, "/2"), nullptr);
+}
+
 // --- Integration Tests ---
 
 TEST_F(SharedUtilitiesTest, LambdaWithComplexExpression) {
@@ -400,6 +497,51 @@ TEST_F(SharedUtilitiesTest, LambdaVariableShadowing) {
               json(TEST_VALUE)); // Should be lambda parameter, not outer variable
 }
 
+TEST_F(SharedUtilitiesTest, VariableFramesShareTheirParent) {
+    auto outer = ctx.with_variables({{"x", json(1)}, {"y", json(2)}});
+    auto left = outer.with_bindings({{"x", json(10)}});
+    auto right = outer.with_bindings({{"z", json(3)}, {"z", json(4)}});
+
+    // Sibling scopes see the same parent frame without copying it
+    EXPECT_EQ(left.frame()->parent(), outer.frame());
+    EXPECT_EQ(right.frame()->parent(), outer.frame());
+    EXPECT_EQ(*left.find_variable("x"), json(10));
+    EXPECT_EQ(*right.find_variable("x"), json(1));
+    EXPECT_EQ(*right.find_variable("z"), json(4)); // Last binding of a name wins
+    EXPECT_EQ(left.find_variable("z"), nullptr);
+
+    // Slot loads check the name and miss on a layout mismatch
+    EXPECT_EQ(*right.load_variable(1, 1, "y"), json(2));
+    EXPECT_EQ(right.load_variable(1, 1, "x"), nullptr);
+    EXPECT_EQ(right.load_variable(2, 0, "x"), nullptr);
+
+    // Flat views materialize on demand with inner bindings winning
+    auto flat = left.variables();
+    EXPECT_EQ(flat.size(), 2U);
+    EXPECT_EQ(flat.at("x"), json(10));
+    EXPECT_EQ(flat.at("y"), json(2));
+    EXPECT_TRUE(ctx.variables().empty());
+}
+
+TEST_F(SharedUtilitiesTest, ShadowedVariableFramesAreElided) {
+    auto outer = ctx.with_variables({{"f", json("fn")}});
+    auto level1 = outer.with_bindings({{"n", json(1)}});
+    auto level2 = level1.with_bindings({{"n", json(2)}});
+    auto level3 = level2.with_bindings({{"n", json(3)}, {"m", json(0)}});
+
+    // Frames rebinding every parent name link straight past the parent
+    EXPECT_EQ(level2.frame()->parent(), outer.frame());
+    EXPECT_EQ(level3.frame()->parent(), outer.frame());
+    EXPECT_EQ(level3.frame()->elided(), 2U);
+    EXPECT_EQ(*level3.find_variable("n"), json(3));
+    EXPECT_EQ(*level3.find_variable("f"), json("fn"));
+
+    // Compiled hop counts still land on the right frame, or miss if elided
+    EXPECT_EQ(*level3.load_variable(3, 0, "f"), json("fn"));
+    EXPECT_EQ(level3.load_variable(1, 0, "n"), nullptr);
+    EXPECT_EQ(*level1.load_variable(1, 0, "f"), json("fn"));
+}
+
 // --- Levenshtein Distance Tests ---
 
 TEST_F(SharedUtilitiesTest, LevenshteinDistanceIdentical) {
@@ -112,3 +112,60 @@ TEST_F(TCOTest, DeepRecursionConditional) {
     // This should not cause stack overflow and should return "success"
     EXPECT_EQ(execute_script(deep_conditional), json("success"));
 }
+
+// --- Recursion Through Operators and Lambdas ---
+
+namespace {
+
+// f(n) = n <= 0 ? 0 : 1 + f(n - 1), recursing through map over a one-element
+// array; the "+" keeps every level alive on the native stack
+const char* const RECURSIVE_COUNT = R"(["let", {"f": ["lambda", ["n"],
+    ["if", ["<=", ["$", "/n"], 0], 0,
+        ["+", 1, ["car", ["map", [["-", ["$", "/n"], 1]], ["$", "/f"]]]]]]},
+    ["car", ["map", [["$input"]], ["$", "/f"]]]])";
+
+} // namespace
+
+TEST_F(TCOTest, DeepNonTailRecursionThroughLambdas) {
+    // Far deeper than a default 8MB thread stack holds for this script
+    constexpr int RECURSION_DEPTH = 20000;
+    EXPECT_EQ(execute_script(RECURSIVE_COUNT, json(RECURSION_DEPTH)), json(RECURSION_DEPTH));
+
+    auto program = computo::compile(jsom::parse_document(RECURSIVE_COUNT));
+    EXPECT_EQ(program.run({json(RECURSION_DEPTH)}), json(RECURSION_DEPTH));
+}
+
+#if defined(__linux__)
+TEST_F(TCOTest, MillionLevelNonTailRecursion) {
+    // Every pending level stays on the native stack segments, so this needs
+    // a few GB of address space but no more than the default thread stack
+    constexpr int RECURSION_DEPTH = 1000000;
+    auto program = computo::compile(jsom::parse_document(RECURSIVE_COUNT));
+    EXPECT_EQ(program.run({json(RECURSION_DEPTH)}), json(RECURSION_DEPTH));
+}
+#endif
+
+TEST_F(TCOTest, DeepRecursionErrorsPropagate) {
+    // The innermost level fails; the error must unwind through every level
+    const std::string failing = R"(["let", {"f": ["lambda", ["n"],
+        ["if", ["<=", ["$", "/n"], 0], ["/", 1, "zero"],
+            ["+", 1, ["car", ["map", [["-", ["$", "/n"], 1]], ["$", "/f"]]]]]]},
+        ["car", ["map", [["$input"]], ["$", "/f"]]]])";
+    constexpr int RECURSION_DEPTH = 10000;
+    EXPECT_THROW(execute_script(failing, json(RECURSION_DEPTH)),
+                 computo::InvalidArgumentException);
+
+    // The evaluator is still usable afterwards
+    EXPECT_EQ(execute_script(RECURSIVE_COUNT, json(100)), json(100));
+}
+
+TEST_F(TCOTest, TailCallsInsideLambdaBodies) {
+    // Deep let/if chains in a lambda body bounce on the shared trampoline
+    std::string body = R"(["$", "/x"])";
+    constexpr int NESTING_LEVELS = 2000;
+    for (int i = 0; i < NESTING_LEVELS; ++i) {
+        body = R"(["if", true, ["let", {"y": 1}, )" + body + R"(], null])";
+    }
+    auto script = R"(["map", {"array": [1, 2]}, ["lambda", ["x"], )" + body + "]]";
+    EXPECT_EQ(execute_script(script), jsom::parse_document(R"({"array": [1, 2]})"));
+}